@@ -0,0 +1,93 @@
+#include <iostream>
+#include <chrono>
+#include <gmp.h>
+
+#include "gmpxx_mkII.h"
+#if !defined ___GMPXX_STRICT_COMPATIBILITY___
+using namespace gmpxx;
+#endif
+
+#define MFLOPS 1e+6
+
+gmp_randstate_t state;
+
+// double-double dot product; four independent partial sums so the loop can be vectorized (-O3 -march=native)
+dd_class _Rdot(int64_t n, const dd_class *dx, int64_t incx, const dd_class *dy, int64_t incy) {
+    if (incx != 1 || incy != 1) {
+        std::cerr << "Increments other than 1 are not supported." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    dd_class temp0 = 0, temp1 = 0, temp2 = 0, temp3 = 0;
+    int64_t i;
+    for (i = 0; i + 3 < n; i += 4) {
+        temp0 += dx[i] * dy[i];
+        temp1 += dx[i + 1] * dy[i + 1];
+        temp2 += dx[i + 2] * dy[i + 2];
+        temp3 += dx[i + 3] * dy[i + 3];
+    }
+    for (; i < n; i++) {
+        temp0 += dx[i] * dy[i];
+    }
+    return (temp0 + temp1) + (temp2 + temp3);
+}
+
+// the same with mpf_class at 106 bits
+mpf_class Rdot_ref(int64_t n, const mpf_class *dx, const mpf_class *dy) {
+    mpf_class temp = 0;
+    for (int64_t i = 0; i < n; i++) {
+        temp += dx[i] * dy[i];
+    }
+    return temp;
+}
+
+void init_vec(mpf_class *vec, dd_class *dvec, int n) {
+    for (int i = 0; i < n; i++) {
+        mpf_urandomb(vec[i].get_mpf_t(), state, 106);
+        dvec[i] = dd_class(vec[i]);
+    }
+}
+
+int main(int argc, char **argv) {
+    gmp_randinit_default(state);
+    gmp_randseed_ui(state, 42);
+
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <vector size>" << std::endl;
+        return 1;
+    }
+
+    int N = std::atoi(argv[1]);
+    mpf_set_default_prec(106);
+
+    mpf_class *vec1 = new mpf_class[N];
+    mpf_class *vec2 = new mpf_class[N];
+    dd_class *dvec1 = new dd_class[N];
+    dd_class *dvec2 = new dd_class[N];
+    init_vec(vec1, dvec1, N);
+    init_vec(vec2, dvec2, N);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    dd_class _ans = _Rdot(N, dvec1, 1, dvec2, 1);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    auto start_ref = std::chrono::high_resolution_clock::now();
+    mpf_class ans = Rdot_ref(N, vec1, vec2);
+    auto end_ref = std::chrono::high_resolution_clock::now();
+
+    std::chrono::duration<double> elapsed_seconds = end - start;
+    std::chrono::duration<double> elapsed_seconds_ref = end_ref - start_ref;
+    std::cout << "Elapsed time: " << elapsed_seconds.count() << " s" << std::endl;
+    std::cout << "MFLOPS: " << (2.0 * double(N) - 1.0) / elapsed_seconds.count() / MFLOPS << std::endl;
+    std::cout << "Elapsed time (mpf_class, 106 bits): " << elapsed_seconds_ref.count() << " s" << std::endl;
+    mpf_class diff = abs(_ans.get_mpf_class(256) - ans) / ans;
+    std::cout << "DIFF: ";
+    gmp_printf("%.4Fe\n", diff.get_mpf_t());
+
+    delete[] vec1;
+    delete[] vec2;
+    delete[] dvec1;
+    delete[] dvec2;
+
+    return 0;
+}
@@ -36,7 +36,7 @@ void _Rdot(int64_t n, mpf_t *dx, int64_t incx, mpf_t *dy, int64_t incy, mpf_t *a
         mpf_set_d(temp, 0.0);
         mpf_set_d(templ, 0.0);
 
-#pragma omp for
+#pragma omp for schedule(static)
         for (i = 0; i < n; i++) {
             mpf_mul(templ, dx[i], dy[i]);
             mpf_add(temp, temp, templ);
@@ -49,8 +49,13 @@ void _Rdot(int64_t n, mpf_t *dx, int64_t incx, mpf_t *dy, int64_t incy, mpf_t *a
 }
 
 void init_mpf_vec(mpf_t *vec, int n, int prec) {
+    // first touch: each element is allocated by the thread that uses it in _Rdot
+#pragma omp parallel for schedule(static)
     for (int i = 0; i < n; i++) {
         mpf_init2(vec[i], prec);
+        mpf_set_ui(vec[i], 0);
+    }
+    for (int i = 0; i < n; i++) {
         mpf_urandomb(vec[i], state, prec);
     }
 }
@@ -35,7 +35,7 @@ mpf_class _Rdot(int64_t n, mpf_class *dx, int64_t incx, mpf_class *dy, int64_t i
     {
         templ = 0.0;
 #ifdef _OPENMP
-#pragma omp for
+#pragma omp for schedule(static)
 #endif
         for (i = 0; i < n; i++) {
             templ += dx[i] * dy[i];
@@ -48,6 +48,15 @@ mpf_class _Rdot(int64_t n, mpf_class *dx, int64_t incx, mpf_class *dy, int64_t i
     return temp;
 }
 
+// first touch: gives every element new limbs allocated by the thread that uses it in the kernel
+void first_touch(mpf_class *vec, int64_t n) {
+#pragma omp parallel for schedule(static)
+    for (int64_t i = 0; i < n; ++i) {
+        mpf_class fresh(vec[i]);
+        mpf_swap(vec[i].get_mpf_t(), fresh.get_mpf_t());
+    }
+}
+
 void init_mpf_vec(mpf_t *vec, int n, int prec) {
     for (int i = 0; i < n; i++) {
         mpf_init2(vec[i], prec);
@@ -91,6 +100,8 @@ int main(int argc, char **argv) {
         vec1_mpf_class[i] = mpf_class(vec1[i]);
         vec2_mpf_class[i] = mpf_class(vec2[i]);
     }
+    first_touch(vec1_mpf_class, N);
+    first_touch(vec2_mpf_class, N);
 
     auto start = std::chrono::high_resolution_clock::now();
     _ans = _Rdot(N, vec1_mpf_class, 1, vec2_mpf_class, 1);
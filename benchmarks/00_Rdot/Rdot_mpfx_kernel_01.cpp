@@ -0,0 +1,84 @@
+#include <iostream>
+#include <chrono>
+#include <gmp.h>
+
+#include "gmpxx_mkII.h"
+#if !defined ___GMPXX_STRICT_COMPATIBILITY___
+using namespace gmpxx;
+#endif
+
+#define MFLOPS 1e+6
+
+constexpr int prec = 512;
+using fixed = mpfx<63, prec>;
+
+// fixed-point dot product: one mpn_mul_n, one shift and one mpn_add_n per term
+fixed _Rdot(int64_t n, const fixed *dx, int64_t incx, const fixed *dy, int64_t incy) {
+    if (incx != 1 || incy != 1) {
+        std::cerr << "Increments other than 1 are not supported." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    fixed temp;
+    for (int64_t i = 0; i < n; i++) {
+        temp += dx[i] * dy[i];
+    }
+    return temp;
+}
+
+// the same with mpf_class
+mpf_class Rdot_ref(int64_t n, const mpf_class *dx, const mpf_class *dy) {
+    mpf_class temp = 0;
+    for (int64_t i = 0; i < n; i++) {
+        temp += dx[i] * dy[i];
+    }
+    return temp;
+}
+
+int main(int argc, char **argv) {
+    gmp_randclass r(gmp_randinit_default);
+    r.seed(42);
+
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <vector size>" << std::endl;
+        return 1;
+    }
+
+    int64_t N = std::atoll(argv[1]);
+    mpf_set_default_prec(prec);
+
+    mpf_class *vec1 = new mpf_class[N];
+    mpf_class *vec2 = new mpf_class[N];
+    fixed *fvec1 = new fixed[N];
+    fixed *fvec2 = new fixed[N];
+    for (int64_t i = 0; i < N; i++) {
+        vec1[i] = r.get_f(prec);
+        vec2[i] = r.get_f(prec);
+        fvec1[i] = fixed(vec1[i]);
+        fvec2[i] = fixed(vec2[i]);
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    fixed _ans = _Rdot(N, fvec1, 1, fvec2, 1);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    auto start_ref = std::chrono::high_resolution_clock::now();
+    mpf_class ans = Rdot_ref(N, vec1, vec2);
+    auto end_ref = std::chrono::high_resolution_clock::now();
+
+    std::chrono::duration<double> elapsed_seconds = end - start;
+    std::chrono::duration<double> elapsed_seconds_ref = end_ref - start_ref;
+    std::cout << "Elapsed time: " << elapsed_seconds.count() << " s" << std::endl;
+    std::cout << "MFLOPS: " << (2.0 * double(N) - 1.0) / elapsed_seconds.count() / MFLOPS << std::endl;
+    std::cout << "Elapsed time (mpf_class): " << elapsed_seconds_ref.count() << " s" << std::endl;
+    mpf_class diff = abs(_ans.get_mpf_class(prec) - ans);
+    std::cout << "DIFF: ";
+    gmp_printf("%.4Fe\n", diff.get_mpf_t());
+
+    delete[] vec1;
+    delete[] vec2;
+    delete[] fvec1;
+    delete[] fvec2;
+
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include <iostream>
+#include <chrono>
+#include <gmp.h>
+
+#include "gmpxx_mkII.h"
+#if !defined ___GMPXX_STRICT_COMPATIBILITY___
+using namespace gmpxx;
+#endif
+
+#define MFLOPS 1e+6
+
+gmp_randstate_t state;
+
+// exact rational dot product on mpq_accumulator: the sum is canonicalized once, on get(), instead of after every term;
+// no interval is passed since the products of random rationals do not cancel
+mpq_class _Rdot(int64_t n, mpq_class *dx, int64_t incx, mpq_class *dy, int64_t incy) {
+    if (incx != 1 || incy != 1) {
+        std::cerr << "Increments other than 1 are not supported." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    int64_t i;
+
+    mpq_accumulator temp;
+    for (i = 0; i < n; i++) {
+        temp.add_product(dx[i], dy[i]);
+    }
+    return temp.get();
+}
+
+// the same with mpq_class operators, which canonicalize every product and every partial sum
+mpq_class Rdot_ref(int64_t n, mpq_class *dx, mpq_class *dy) {
+    mpq_class temp = 0;
+    for (int64_t i = 0; i < n; i++) {
+        temp += dx[i] * dy[i];
+    }
+    return temp;
+}
+
+void init_mpq_vec(mpq_class *vec, int n, unsigned long bound) {
+    for (int i = 0; i < n; i++) {
+        long num = static_cast<long>(gmp_urandomm_ui(state, 2 * bound + 1)) - static_cast<long>(bound);
+        long den = static_cast<long>(gmp_urandomm_ui(state, bound)) + 1;
+        mpq_set_si(vec[i].get_mpq_t(), num, den);
+        mpq_canonicalize(vec[i].get_mpq_t());
+    }
+}
+
+int main(int argc, char **argv) {
+    gmp_randinit_default(state);
+    gmp_randseed_ui(state, 42);
+
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <vector size> <bound of numerators and denominators>" << std::endl;
+        return 1;
+    }
+
+    int N = std::atoi(argv[1]);
+    unsigned long bound = std::strtoul(argv[2], nullptr, 10);
+
+    mpq_class *vec1 = new mpq_class[N];
+    mpq_class *vec2 = new mpq_class[N];
+    init_mpq_vec(vec1, N, bound);
+    init_mpq_vec(vec2, N, bound);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    mpq_class _ans = _Rdot(N, vec1, 1, vec2, 1);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    auto start_ref = std::chrono::high_resolution_clock::now();
+    mpq_class ans = Rdot_ref(N, vec1, vec2);
+    auto end_ref = std::chrono::high_resolution_clock::now();
+
+    std::chrono::duration<double> elapsed_seconds = end - start;
+    std::chrono::duration<double> elapsed_seconds_ref = end_ref - start_ref;
+    std::cout << "Elapsed time: " << elapsed_seconds.count() << " s" << std::endl;
+    std::cout << "MFLOPS: " << (2.0 * double(N) - 1.0) / elapsed_seconds.count() / MFLOPS << std::endl;
+    std::cout << "Elapsed time (mpq_class +=): " << elapsed_seconds_ref.count() << " s" << std::endl;
+    std::cout << "DIFF: " << (_ans == ans ? "OK" : "NG") << std::endl;
+
+    delete[] vec1;
+    delete[] vec2;
+
+    return 0;
+}
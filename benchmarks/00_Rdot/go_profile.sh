@@ -0,0 +1,24 @@
+# the counters of -D___GMPXX_MKII_PROFILE___ for the Rdot kernels: calls, time and limbs per gmpxx_mkII.h function.
+# No perf or root needed; each run writes profile_<kernel>.txt and profile_<kernel>.json.
+# ARGS overrides the size and precision, e.g. ARGS="1000000 1024" bash go_profile.sh
+uname -a
+cat /proc/cpuinfo | grep 'model name' | head -1
+echo
+
+executables=(
+    "Rdot_gmp_kernel_01_profile"
+    "Rdot_gmp_kernel_02_profile"
+    "Rdot_gmp_kernel_03_profile"
+    "Rdot_gmp_kernel_04_profile"
+    "Rdot_gmp_kernel_openmp_01_profile"
+    "Rdot_gmp_kernel_openmp_02_profile"
+)
+
+args=${ARGS:-"10000000 512"}
+for exe in "${executables[@]}"; do
+    echo "Profiling $exe"
+    GMPXX_MKII_PROFILE=profile_${exe}.json ./$exe $args
+    GMPXX_MKII_PROFILE=profile_${exe}.txt ./$exe $args >/dev/null
+    cat profile_${exe}.txt
+    echo
+done
@@ -0,0 +1,79 @@
+#include <iostream>
+#include <chrono>
+
+#include "gmpxx_mkII.h"
+#if !defined ___GMPXX_STRICT_COMPATIBILITY___
+using namespace gmpxx;
+#endif
+
+#include "Raxpy.hpp"
+
+#define MFLOPS 1e+6
+
+constexpr int prec = 256;
+
+// y = alpha * x + y on limb-interleaved batches, 8 lanes per step
+void _Raxpy(const mpf_class &alpha, const mpf_batch<prec> &x, mpf_batch<prec> &y) { batch_axpy(alpha, x, y); }
+
+int main(int argc, char **argv) {
+    gmp_randclass r(gmp_randinit_default);
+    r.seed(42);
+
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <vector size>" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    int64_t N = std::atoll(argv[1]);
+    mpf_set_default_prec(prec);
+
+    mpf_class *x = new mpf_class[N];
+    mpf_class *yy = new mpf_class[N];
+    mpf_batch<prec> bx(N), by(N);
+    mpf_class alpha;
+    alpha = r.get_f(prec);
+
+    for (int64_t i = 0; i < N; ++i) {
+        x[i] = r.get_f(prec);
+        yy[i] = r.get_f(prec);
+        bx.set(i, x[i]);
+        by.set(i, yy[i]);
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    _Raxpy(alpha, bx, by);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    auto start_ref = std::chrono::high_resolution_clock::now();
+    Raxpy(N, alpha, x, 1, yy, 1);
+    auto end_ref = std::chrono::high_resolution_clock::now();
+
+    std::chrono::duration<double> elapsed_seconds = end - start;
+    std::chrono::duration<double> elapsed_seconds_ref = end_ref - start_ref;
+    double mflops = (2.0 * double(N)) / (elapsed_seconds.count() * MFLOPS);
+
+    std::cout << "Elapsed time: " << elapsed_seconds.count() << " s" << std::endl;
+    std::cout << "MFLOPS: " << mflops << std::endl;
+    std::cout << "Elapsed time (mpf_class): " << elapsed_seconds_ref.count() << " s" << std::endl;
+
+    mpf_class l1_norm = 0;
+    for (int64_t i = 0; i < N; ++i) {
+        mpf_class diff = abs(by.get(i) - yy[i]);
+        l1_norm += diff;
+    }
+
+    std::cout << "L1 Norm of difference: ";
+    gmp_printf("%.4Fg\n", l1_norm.get_mpf_t());
+
+    mpf_class threshold = 1e-5;
+    if (l1_norm < threshold) {
+        std::cout << "Result OK" << std::endl;
+    } else {
+        std::cout << "Result NG" << std::endl;
+    }
+
+    delete[] x;
+    delete[] yy;
+
+    return EXIT_SUCCESS;
+}
@@ -30,7 +30,7 @@ void _Raxpy(int64_t n, const mpf_t alpha, mpf_t *x, int64_t incx, mpf_t *y, int6
         mpf_t temp;
         mpf_init(temp);
 
-#pragma omp for
+#pragma omp for schedule(static)
         for (int64_t i = 0; i < n; ++i) {
             mpf_mul(temp, alpha, x[i]); // temp = alpha * x[i]
             mpf_add(y[i], y[i], temp);  // y[i] = y[i] + temp
@@ -41,8 +41,13 @@ void _Raxpy(int64_t n, const mpf_t alpha, mpf_t *x, int64_t incx, mpf_t *y, int6
 }
 
 void init_mpf_vec(mpf_t *vec, int64_t n, int prec) {
+    // first touch: each element is allocated by the thread that uses it in _Raxpy
+#pragma omp parallel for schedule(static)
     for (int64_t i = 0; i < n; ++i) {
         mpf_init2(vec[i], prec);
+        mpf_set_ui(vec[i], 0);
+    }
+    for (int64_t i = 0; i < n; ++i) {
         mpf_urandomb(vec[i], state, prec); // 0 <= vec[i] < 1
     }
 }
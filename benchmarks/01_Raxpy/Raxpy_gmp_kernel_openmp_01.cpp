@@ -24,12 +24,21 @@ void _Raxpy(int64_t n, const mpf_class &alpha, mpf_class *x, int64_t incx, mpf_c
         exit(EXIT_FAILURE);
     }
 
-#pragma omp parallel for
+#pragma omp parallel for schedule(static)
     for (int64_t i = 0; i < n; ++i) {
         y[i] += alpha * x[i]; // y[i] = y[i] + alpha * x[i]
     }
 }
 
+// first touch: gives every element new limbs allocated by the thread that uses it in the kernel
+void first_touch(mpf_class *vec, int64_t n) {
+#pragma omp parallel for schedule(static)
+    for (int64_t i = 0; i < n; ++i) {
+        mpf_class fresh(vec[i]);
+        mpf_swap(vec[i].get_mpf_t(), fresh.get_mpf_t());
+    }
+}
+
 int main(int argc, char **argv) {
     gmp_randclass r(gmp_randinit_default);
     r.seed(42);
@@ -54,6 +63,8 @@ int main(int argc, char **argv) {
         y[i] = r.get_f(prec);
         yy[i] = y[i];
     }
+    first_touch(x, N);
+    first_touch(y, N);
 
     auto start = std::chrono::high_resolution_clock::now();
     _Raxpy(N, alpha, x, 1, y, 1);
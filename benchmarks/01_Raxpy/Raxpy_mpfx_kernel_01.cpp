@@ -0,0 +1,92 @@
+#include <iostream>
+#include <chrono>
+
+#include "gmpxx_mkII.h"
+#if !defined ___GMPXX_STRICT_COMPATIBILITY___
+using namespace gmpxx;
+#endif
+
+#include "Raxpy.hpp"
+
+#define MFLOPS 1e+6
+
+constexpr int prec = 512;
+using fixed = mpfx<63, prec>;
+
+// y = alpha * x + y in fixed point
+void _Raxpy(int64_t n, const fixed &alpha, const fixed *x, int64_t incx, fixed *y, int64_t incy) {
+    if (incx != 1 || incy != 1) {
+        std::cerr << "Increments other than 1 are not supported." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    for (int64_t i = 0; i < n; ++i) {
+        y[i] += alpha * x[i];
+    }
+}
+
+int main(int argc, char **argv) {
+    gmp_randclass r(gmp_randinit_default);
+    r.seed(42);
+
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <vector size>" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    int64_t N = std::atoll(argv[1]);
+    mpf_set_default_prec(prec);
+
+    mpf_class *x = new mpf_class[N];
+    mpf_class *yy = new mpf_class[N];
+    fixed *fx = new fixed[N];
+    fixed *fy = new fixed[N];
+    mpf_class alpha;
+    alpha = r.get_f(prec);
+
+    for (int64_t i = 0; i < N; ++i) {
+        x[i] = r.get_f(prec);
+        yy[i] = r.get_f(prec);
+        fx[i] = fixed(x[i]);
+        fy[i] = fixed(yy[i]);
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    _Raxpy(N, fixed(alpha), fx, 1, fy, 1);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    auto start_ref = std::chrono::high_resolution_clock::now();
+    Raxpy(N, alpha, x, 1, yy, 1);
+    auto end_ref = std::chrono::high_resolution_clock::now();
+
+    std::chrono::duration<double> elapsed_seconds = end - start;
+    std::chrono::duration<double> elapsed_seconds_ref = end_ref - start_ref;
+    double mflops = (2.0 * double(N)) / (elapsed_seconds.count() * MFLOPS);
+
+    std::cout << "Elapsed time: " << elapsed_seconds.count() << " s" << std::endl;
+    std::cout << "MFLOPS: " << mflops << std::endl;
+    std::cout << "Elapsed time (mpf_class): " << elapsed_seconds_ref.count() << " s" << std::endl;
+
+    mpf_class l1_norm = 0;
+    for (int64_t i = 0; i < N; ++i) {
+        mpf_class diff = abs(fy[i].get_mpf_class(prec) - yy[i]);
+        l1_norm += diff;
+    }
+
+    std::cout << "L1 Norm of difference: ";
+    gmp_printf("%.4Fg\n", l1_norm.get_mpf_t());
+
+    mpf_class threshold = 1e-5;
+    if (l1_norm < threshold) {
+        std::cout << "Result OK" << std::endl;
+    } else {
+        std::cout << "Result NG" << std::endl;
+    }
+
+    delete[] x;
+    delete[] yy;
+    delete[] fx;
+    delete[] fy;
+
+    return EXIT_SUCCESS;
+}
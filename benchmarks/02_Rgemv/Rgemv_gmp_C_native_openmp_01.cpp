@@ -25,12 +25,12 @@ void _Rgemv(int64_t m, int64_t n, const mpf_t alpha, const mpf_t *A, int64_t lda
         exit(EXIT_FAILURE);
     }
 
-#pragma omp parallel for
+#pragma omp parallel for schedule(static)
     for (int64_t i = 0; i < m; ++i) {
         mpf_mul(y[i], y[i], beta);
     }
 
-#pragma omp parallel for
+#pragma omp parallel for schedule(static)
     for (int64_t i = 0; i < m; ++i) {
         mpf_t temp;
         mpf_init(temp);
@@ -53,9 +53,16 @@ void _Rgemv(int64_t m, int64_t n, const mpf_t alpha, const mpf_t *A, int64_t lda
 
 // Initialize a matrix with random values
 void init_mpf_mat(mpf_t *mat, int64_t m, int64_t n, int64_t lda, int prec) {
+    // first touch: row i is allocated by the thread that uses it in _Rgemv
+#pragma omp parallel for schedule(static)
+    for (int64_t i = 0; i < m; ++i) {
+        for (int64_t j = 0; j < n; ++j) {
+            mpf_init2(mat[i + j * lda], prec);
+            mpf_set_ui(mat[i + j * lda], 0);
+        }
+    }
     for (int64_t j = 0; j < n; ++j) {
         for (int64_t i = 0; i < m; ++i) {
-            mpf_init2(mat[i + j * lda], prec);
             mpf_urandomb(mat[i + j * lda], state, prec); // 0 <= mat[i + j*lda] < 1
         }
     }
@@ -104,8 +111,12 @@ int main(int argc, char **argv) {
         mpf_init2(x[i], prec);
         mpf_urandomb(x[i], state, prec);
     }
+#pragma omp parallel for schedule(static)
     for (int64_t i = 0; i < m; ++i) {
         mpf_init2(y[i], prec);
+        mpf_set_ui(y[i], 0);
+    }
+    for (int64_t i = 0; i < m; ++i) {
         mpf_urandomb(y[i], state, prec);
     }
 
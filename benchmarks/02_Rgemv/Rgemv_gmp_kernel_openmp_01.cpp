@@ -22,11 +22,11 @@ void _Rgemv(int64_t m, int64_t n, const mpf_class &alpha, const mpf_class *A, in
         std::cerr << "Increments other than 1 are not supported." << std::endl;
         exit(EXIT_FAILURE);
     }
-#pragma omp parallel for
+#pragma omp parallel for schedule(static)
     for (int64_t i = 0; i < m; ++i) {
         y[i] *= beta;
     }
-#pragma omp parallel for
+#pragma omp parallel for schedule(static)
     for (int64_t i = 0; i < m; ++i) {
         mpf_class temp = 0;
         for (int64_t j = 0; j < n; ++j) {
@@ -36,6 +36,26 @@ void _Rgemv(int64_t m, int64_t n, const mpf_class &alpha, const mpf_class *A, in
     }
 }
 
+// first touch: gives every element new limbs allocated by the thread that uses it in the kernel
+void first_touch(mpf_class *vec, int64_t n) {
+#pragma omp parallel for schedule(static)
+    for (int64_t i = 0; i < n; ++i) {
+        mpf_class fresh(vec[i]);
+        mpf_swap(vec[i].get_mpf_t(), fresh.get_mpf_t());
+    }
+}
+
+// the same for A, whose row i is used by the thread that owns y[i]
+void first_touch_rows(mpf_class *A, int64_t m, int64_t n, int64_t lda) {
+#pragma omp parallel for schedule(static)
+    for (int64_t i = 0; i < m; ++i) {
+        for (int64_t j = 0; j < n; ++j) {
+            mpf_class fresh(A[i + j * lda]);
+            mpf_swap(A[i + j * lda].get_mpf_t(), fresh.get_mpf_t());
+        }
+    }
+}
+
 int main(int argc, char **argv) {
     // Initialize random state
     gmp_randclass r(gmp_randinit_default);
@@ -77,6 +97,8 @@ int main(int argc, char **argv) {
         y[i] = r.get_f(prec);
         yy[i] = y[i];
     }
+    first_touch_rows(A, M, N, M);
+    first_touch(y, M);
 
     auto start = std::chrono::high_resolution_clock::now();
     _Rgemv(M, N, alpha, A, M, x, 1, beta, y, 1);
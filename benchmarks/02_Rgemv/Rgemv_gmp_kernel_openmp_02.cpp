@@ -24,14 +24,14 @@ void _Rgemv(int64_t m, int64_t n, const mpf_class &alpha, const mpf_class *A, in
     }
 
     // Scale y by beta: y = beta * y
-#pragma omp parallel for
+#pragma omp parallel for schedule(static)
     for (int64_t i = 0; i < m; ++i) {
         y[i] *= beta;
     }
 
     // Compute alpha * A * x and add to y: y += alpha * A * x
     mpf_class temp, templ;
-#pragma omp parallel for private(temp, templ)
+#pragma omp parallel for private(temp, templ) schedule(static)
     for (int64_t j = 0; j < n; ++j) {
         temp = alpha;
         temp *= x[j];
@@ -43,6 +43,26 @@ void _Rgemv(int64_t m, int64_t n, const mpf_class &alpha, const mpf_class *A, in
     }
 }
 
+// first touch: gives every element new limbs allocated by the thread that uses it in the kernel
+void first_touch(mpf_class *vec, int64_t n) {
+#pragma omp parallel for schedule(static)
+    for (int64_t i = 0; i < n; ++i) {
+        mpf_class fresh(vec[i]);
+        mpf_swap(vec[i].get_mpf_t(), fresh.get_mpf_t());
+    }
+}
+
+// the same for A, whose column j is used by the thread that owns x[j]
+void first_touch_columns(mpf_class *A, int64_t m, int64_t n, int64_t lda) {
+#pragma omp parallel for schedule(static)
+    for (int64_t j = 0; j < n; ++j) {
+        for (int64_t i = 0; i < m; ++i) {
+            mpf_class fresh(A[i + j * lda]);
+            mpf_swap(A[i + j * lda].get_mpf_t(), fresh.get_mpf_t());
+        }
+    }
+}
+
 int main(int argc, char **argv) {
     // Initialize random state
     gmp_randclass r(gmp_randinit_default);
@@ -84,6 +104,9 @@ int main(int argc, char **argv) {
         y[i] = r.get_f(prec);
         yy[i] = y[i];
     }
+    first_touch_columns(A, M, N, M);
+    first_touch(x, N);
+    first_touch(y, M);
 
     auto start = std::chrono::high_resolution_clock::now();
     _Rgemv(M, N, alpha, A, M, x, 1, beta, y, 1);
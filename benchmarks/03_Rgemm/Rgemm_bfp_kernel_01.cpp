@@ -0,0 +1,92 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+
+#include "gmpxx_mkII.h"
+#if !defined ___GMPXX_STRICT_COMPATIBILITY___
+using namespace gmpxx;
+#endif
+
+#include "Rgemm.hpp"
+
+#define MFLOPS 1e+6
+
+constexpr int prec = 512;
+
+// cf. https://netlib.org/lapack/lawnspdf/lawn41.pdf p.120
+double flops_gemm(int k_i, int m_i, int n_i) {
+    double adds, muls, flops;
+    double k, m, n;
+    m = (double)m_i;
+    n = (double)n_i;
+    k = (double)k_i;
+    muls = m * (k + 2) * n;
+    adds = m * k * n;
+    flops = muls + adds;
+    return flops;
+}
+
+int main(int argc, char **argv) {
+    gmp_randclass r(gmp_randinit_default);
+    r.seed(42);
+
+    if (argc != 4) {
+        std::cerr << "Usage: " << argv[0] << " <rows m> <cols k> <cols n>" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    int64_t M = std::atoll(argv[1]);
+    int64_t K = std::atoll(argv[2]);
+    int64_t N = std::atoll(argv[3]);
+    mpf_set_default_prec(prec);
+
+    mpf_matrix A(M, K, prec), B(K, N, prec), C(M, N, prec);
+    mpf_class *C_ref = new mpf_class[M * N];
+
+    for (int64_t j = 0; j < K; ++j)
+        for (int64_t i = 0; i < M; ++i)
+            A(i, j) = r.get_f(prec);
+    for (int64_t j = 0; j < N; ++j)
+        for (int64_t i = 0; i < K; ++i)
+            B(i, j) = r.get_f(prec);
+
+    // C = A * B on block floating point mantissas, conversions included
+    auto start = std::chrono::high_resolution_clock::now();
+    mpf_bfp_matrix bA(A), bB(B), bC(M, N, prec);
+    gemm(bC, bA, bB);
+    bC.get(C);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    mpf_class alpha = 1, beta = 0;
+    auto start_ref = std::chrono::high_resolution_clock::now();
+    Rgemm("n", "n", M, N, K, alpha, A.data(), M, B.data(), K, beta, C_ref, M);
+    auto end_ref = std::chrono::high_resolution_clock::now();
+
+    std::chrono::duration<double> elapsed = end - start;
+    std::chrono::duration<double> elapsed_ref = end_ref - start_ref;
+    std::cout << "Elapsed time: " << elapsed.count() << " s" << std::endl;
+    std::cout << "MFLOPS: " << flops_gemm(M, N, K) / (elapsed.count() * MFLOPS) << std::endl;
+    std::cout << "Elapsed time (mpf_class Rgemm): " << elapsed_ref.count() << " s" << std::endl;
+
+    mpf_class l1_norm = 0;
+    for (int64_t j = 0; j < N; ++j) {
+        for (int64_t i = 0; i < M; ++i) {
+            mpf_class diff = abs(C(i, j) - C_ref[i + j * M]);
+            l1_norm += diff;
+        }
+    }
+
+    std::cout << "L1 Norm of difference: ";
+    gmp_printf("%.4Fg\n", l1_norm.get_mpf_t());
+
+    mpf_class threshold = 1e-5;
+    if (l1_norm < threshold) {
+        std::cout << "Result OK" << std::endl;
+    } else {
+        std::cout << "Result NG" << std::endl;
+    }
+
+    delete[] C_ref;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,123 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+
+#include "gmpxx_mkII.h"
+#if !defined ___GMPXX_STRICT_COMPATIBILITY___
+using namespace gmpxx;
+#endif
+
+#include "Rgemm.hpp"
+
+#define MFLOPS 1e+6
+
+constexpr int prec = 512;
+using fixed = mpfx<63, prec>;
+
+// cf. https://netlib.org/lapack/lawnspdf/lawn41.pdf p.120
+double flops_gemm(int k_i, int m_i, int n_i) {
+    double adds, muls, flops;
+    double k, m, n;
+    m = (double)m_i;
+    n = (double)n_i;
+    k = (double)k_i;
+    muls = m * (k + 2) * n;
+    adds = m * k * n;
+    flops = muls + adds;
+    return flops;
+}
+
+// C = alpha * A * B + beta * C in fixed point
+void _Rgemm(int64_t m, int64_t k, int64_t n, const fixed &alpha, const fixed *A, int64_t lda, const fixed *B, int64_t ldb, const fixed &beta, fixed *C, int64_t ldc) {
+    for (int64_t j = 0; j < n; ++j) {
+        for (int64_t i = 0; i < m; ++i) {
+            C[i + j * ldc] = beta * C[i + j * ldc];
+        }
+    }
+
+    for (int64_t i = 0; i < m; ++i) {
+        for (int64_t j = 0; j < n; ++j) {
+            fixed temp;
+            for (int64_t l = 0; l < k; ++l) {
+                temp += A[i + l * lda] * B[l + j * ldb];
+            }
+            C[i + j * ldc] += alpha * temp;
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    gmp_randclass r(gmp_randinit_default);
+    r.seed(42);
+
+    if (argc != 4) {
+        std::cerr << "Usage: " << argv[0] << " <rows m> <cols k> <cols n>" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    int64_t M = std::atoll(argv[1]);
+    int64_t K = std::atoll(argv[2]);
+    int64_t N = std::atoll(argv[3]);
+    mpf_set_default_prec(prec);
+
+    mpf_class *A = new mpf_class[M * K];
+    mpf_class *B = new mpf_class[K * N];
+    mpf_class *C_ref = new mpf_class[M * N];
+    fixed *fA = new fixed[M * K];
+    fixed *fB = new fixed[K * N];
+    fixed *fC = new fixed[M * N];
+
+    mpf_class alpha = r.get_f(prec);
+    mpf_class beta = r.get_f(prec);
+    for (int64_t i = 0; i < M * K; ++i) {
+        A[i] = r.get_f(prec);
+        fA[i] = fixed(A[i]);
+    }
+    for (int64_t i = 0; i < K * N; ++i) {
+        B[i] = r.get_f(prec);
+        fB[i] = fixed(B[i]);
+    }
+    for (int64_t i = 0; i < M * N; ++i) {
+        C_ref[i] = r.get_f(prec);
+        fC[i] = fixed(C_ref[i]);
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    _Rgemm(M, K, N, fixed(alpha), fA, M, fB, K, fixed(beta), fC, M);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    auto start_ref = std::chrono::high_resolution_clock::now();
+    Rgemm("n", "n", M, N, K, alpha, A, M, B, K, beta, C_ref, M);
+    auto end_ref = std::chrono::high_resolution_clock::now();
+
+    std::chrono::duration<double> elapsed = end - start;
+    std::chrono::duration<double> elapsed_ref = end_ref - start_ref;
+    std::cout << "Elapsed time: " << elapsed.count() << " s" << std::endl;
+    std::cout << "MFLOPS: " << flops_gemm(M, N, K) / (elapsed.count() * MFLOPS) << std::endl;
+    std::cout << "Elapsed time (mpf_class Rgemm): " << elapsed_ref.count() << " s" << std::endl;
+
+    mpf_class l1_norm = 0;
+    for (int64_t i = 0; i < M * N; ++i) {
+        mpf_class diff = abs(fC[i].get_mpf_class(prec) - C_ref[i]);
+        l1_norm += diff;
+    }
+
+    std::cout << "L1 Norm of difference: ";
+    gmp_printf("%.4Fg\n", l1_norm.get_mpf_t());
+
+    mpf_class threshold = 1e-5;
+    if (l1_norm < threshold) {
+        std::cout << "Result OK" << std::endl;
+    } else {
+        std::cout << "Result NG" << std::endl;
+    }
+
+    delete[] A;
+    delete[] B;
+    delete[] C_ref;
+    delete[] fA;
+    delete[] fB;
+    delete[] fC;
+
+    return EXIT_SUCCESS;
+}
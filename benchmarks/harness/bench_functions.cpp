@@ -0,0 +1,263 @@
+#include <iostream>
+#include <vector>
+#include <gmp.h>
+#if defined USE_MPFR
+#include <mpfr.h>
+#endif
+
+#include "gmpxx_mkII.h"
+using namespace gmpxx;
+
+#include "harness.hpp"
+
+// The elementary and transcendental functions of gmpxx_mkII.h on the harness, one kernel per function.
+// --sizes is the number of arguments per run and --precs the working precision; a sweep such as
+//   bench_functions --sizes 16 --precs 64,256,1024,4096,16384,65536
+// times each function over arguments chosen to stress range reduction (tiny, moderate and huge arguments,
+// arguments close to multiples of pi, to 1 for log, and so on) and reports the worst accuracy over them in bits.
+// The reference is the same function at 64 more bits, or MPFR at 64 more bits when built with -DUSE_MPFR -lmpfr;
+// the MPFR build also times the MPFR counterpart of every function as mpfr_<name>.
+// Without MPFR the accuracy is self-referential: it catches errors that shrink as the precision grows, but an
+// error that does not depend on the precision (a wrong range reduction, a wrong constant) shows up in both the
+// value and the reference and is reported as full accuracy.
+
+namespace {
+
+constexpr int guard_bits = 64;
+
+// correct bits of value against reference, capped at prec
+double accurate_bits(const mpf_class &value, const mpf_class &reference, int prec) {
+    mpf_class diff = abs(value - reference);
+    if (diff == 0)
+        return prec;
+    long e_diff, e_ref;
+    double d_diff = mpf_get_d_2exp(&e_diff, diff.get_mpf_t()), d_ref = mpf_get_d_2exp(&e_ref, reference.get_mpf_t());
+    if (reference == 0)
+        return 0;
+    double bits = (e_ref + std::log2(std::fabs(d_ref))) - (e_diff + std::log2(std::fabs(d_diff)));
+    return std::max(0.0, std::min(static_cast<double>(prec), bits));
+}
+
+// the value at index i of an argument distribution, r uniform in [0, 1)
+using distribution = mpf_class (*)(std::size_t i, const mpf_class &r, const mpf_class &pi);
+mpf_class scaled(const mpf_class &r, long exp2) {
+    mpf_class x(r);
+    if (exp2 >= 0)
+        mpf_mul_2exp(x.get_mpf_t(), x.get_mpf_t(), exp2);
+    else
+        mpf_div_2exp(x.get_mpf_t(), x.get_mpf_t(), -exp2);
+    return x;
+}
+// tiny, moderate and large arguments of both signs
+mpf_class exp_arguments(std::size_t i, const mpf_class &r, const mpf_class &) {
+    mpf_class x = (i % 3 == 0) ? scaled(r, -20) : (i % 3 == 1) ? r * 100 : r * 2000;
+    return (i % 2) ? mpf_class(-x) : x;
+}
+// close to 1, moderate, and huge or tiny
+mpf_class log_arguments(std::size_t i, const mpf_class &r, const mpf_class &) {
+    if (i % 3 == 0)
+        return 1 + scaled(r - 0.5, -30);
+    if (i % 3 == 1)
+        return r * 100 + 0.01;
+    return scaled(r + 0.5, (i % 2) ? 1000 : -1000);
+}
+// moderate, huge, and within 2^-40 of a multiple of pi / 2
+mpf_class trig_arguments(std::size_t i, const mpf_class &r, const mpf_class &pi) {
+    switch (i % 4) {
+    case 0:
+        return r;
+    case 1:
+        return r * 100;
+    case 2:
+        return scaled(r, 64);
+    default:
+        return pi * static_cast<unsigned long>(i + 1) / 2 + scaled(r, -40);
+    }
+}
+mpf_class atan_arguments(std::size_t i, const mpf_class &r, const mpf_class &) {
+    mpf_class x = (i % 3 == 0) ? scaled(r, -30) : (i % 3 == 1) ? r * 10 : scaled(r, 100);
+    return (i % 2) ? mpf_class(-x) : x;
+}
+// tiny x, where exp(x) - exp(-x) cancels, and large x
+mpf_class hyperbolic_arguments(std::size_t i, const mpf_class &r, const mpf_class &) {
+    mpf_class x = (i % 3 == 0) ? scaled(r, -30) : (i % 3 == 1) ? r * 10 : r * 1000;
+    return (i % 2) ? mpf_class(-x) : x;
+}
+
+struct function_case {
+    const char *name;
+    mpf_class (*f)(const mpf_class &);
+    distribution arguments;
+#if defined USE_MPFR
+    int (*mpfr_f)(mpfr_ptr, mpfr_srcptr, mpfr_rnd_t);
+#endif
+};
+#if defined USE_MPFR
+#define FUNCTION_CASE(name, arguments) {#name, [](const mpf_class &x) { return name(x); }, arguments, mpfr_##name}
+#else
+#define FUNCTION_CASE(name, arguments) {#name, [](const mpf_class &x) { return name(x); }, arguments}
+#endif
+const std::vector<function_case> &function_cases() {
+    static const std::vector<function_case> cases = {
+        FUNCTION_CASE(exp, exp_arguments),   FUNCTION_CASE(log, log_arguments),    FUNCTION_CASE(sin, trig_arguments),        FUNCTION_CASE(cos, trig_arguments),
+        FUNCTION_CASE(tan, trig_arguments),  FUNCTION_CASE(atan, atan_arguments),  FUNCTION_CASE(sinh, hyperbolic_arguments), FUNCTION_CASE(cosh, hyperbolic_arguments),
+        FUNCTION_CASE(tanh, hyperbolic_arguments),
+    };
+    return cases;
+}
+
+std::vector<mpf_class> arguments(distribution d, int64_t n, int prec) {
+    gmp_randclass r(gmp_randinit_default);
+    r.seed(42);
+    mpf_class pi = const_pi(prec);
+    std::vector<mpf_class> x;
+    for (int64_t i = 0; i < n; i++)
+        x.push_back(mpf_class(d(i, r.get_f(prec), pi), prec));
+    return x;
+}
+
+#if defined USE_MPFR
+mpf_class mpfr_reference(int (*f)(mpfr_ptr, mpfr_srcptr, mpfr_rnd_t), const mpf_class &x, int prec) {
+    mpfr_t mx, my;
+    mpfr_init2(mx, x.get_prec());
+    mpfr_init2(my, prec + guard_bits);
+    mpfr_set_f(mx, x.get_mpf_t(), MPFR_RNDN);
+    f(my, mx, MPFR_RNDN);
+    mpf_class y(0, prec + guard_bits);
+    mpfr_get_f(y.get_mpf_t(), my, MPFR_RNDN);
+    mpfr_clear(mx);
+    mpfr_clear(my);
+    return y;
+}
+#endif
+mpf_class reference(const function_case &c, const mpf_class &x, int prec) {
+#if defined USE_MPFR
+    return mpfr_reference(c.mpfr_f, x, prec);
+#else
+    mpf_set_default_prec(prec + guard_bits);
+    mpf_class y = c.f(mpf_class(x, prec + guard_bits));
+    mpf_set_default_prec(prec);
+    return y;
+#endif
+}
+
+void run_function(bench::state &st, const function_case &c) {
+    int prec = st.prec();
+    mpf_set_default_prec(prec);
+    std::vector<mpf_class> x = arguments(c.arguments, st.n(), prec), y(x.size(), mpf_class(0, prec));
+    st.run([&] {
+        for (std::size_t i = 0; i < x.size(); i++)
+            y[i] = c.f(x[i]);
+    });
+    double bits = prec;
+    for (std::size_t i = 0; i < x.size(); i++)
+        bits = std::min(bits, accurate_bits(y[i], reference(c, x[i], prec), prec));
+    st.set_accuracy(bits);
+}
+#if defined USE_MPFR
+void run_mpfr_function(bench::state &st, const function_case &c) {
+    int prec = st.prec();
+    mpf_set_default_prec(prec);
+    std::vector<mpf_class> x = arguments(c.arguments, st.n(), prec);
+    std::vector<__mpfr_struct> mx(x.size()), my(x.size());
+    for (std::size_t i = 0; i < x.size(); i++) {
+        mpfr_init2(&mx[i], prec);
+        mpfr_init2(&my[i], prec);
+        mpfr_set_f(&mx[i], x[i].get_mpf_t(), MPFR_RNDN);
+    }
+    st.run([&] {
+        for (std::size_t i = 0; i < x.size(); i++)
+            c.mpfr_f(&my[i], &mx[i], MPFR_RNDN);
+    });
+    double bits = prec;
+    for (std::size_t i = 0; i < x.size(); i++) {
+        mpf_class y(0, prec);
+        mpfr_get_f(y.get_mpf_t(), &my[i], MPFR_RNDN);
+        bits = std::min(bits, accurate_bits(y, mpfr_reference(c.mpfr_f, x[i], prec), prec));
+        mpfr_clear(&mx[i]);
+        mpfr_clear(&my[i]);
+    }
+    st.set_accuracy(bits);
+}
+#endif
+
+const bool registered = [] {
+    for (const function_case &c : function_cases()) {
+        bench::registry().push_back({c.name, [&c](bench::state &st) { run_function(st, c); }});
+#if defined USE_MPFR
+        bench::registry().push_back({std::string("mpfr_") + c.name, [&c](bench::state &st) { run_mpfr_function(st, c); }});
+#endif
+    }
+    return true;
+}();
+
+} // namespace
+
+// x^y for x in [0.5, 2) and |y| < 100, and for huge x with small y
+BENCH_KERNEL(pow) {
+    int prec = st.prec();
+    mpf_set_default_prec(prec);
+    gmp_randclass r(gmp_randinit_default);
+    r.seed(42);
+    std::vector<mpf_class> x, y, z(st.n(), mpf_class(0, prec));
+    for (int64_t i = 0; i < st.n(); i++) {
+        mpf_class a = r.get_f(prec), b = r.get_f(prec);
+        x.push_back((i % 2) ? scaled(a + 0.5, 200) : a * 1.5 + 0.5);
+        y.push_back((i % 2) ? b - 0.5 : (b - 0.5) * 200);
+    }
+    st.run([&] {
+        for (int64_t i = 0; i < st.n(); i++)
+            z[i] = pow(x[i], y[i]);
+    });
+    double bits = prec;
+    for (int64_t i = 0; i < st.n(); i++) {
+#if defined USE_MPFR
+        mpfr_t mx, my, mz;
+        mpfr_inits2(prec + guard_bits, mx, my, mz, static_cast<mpfr_ptr>(nullptr));
+        mpfr_set_f(mx, x[i].get_mpf_t(), MPFR_RNDN);
+        mpfr_set_f(my, y[i].get_mpf_t(), MPFR_RNDN);
+        mpfr_pow(mz, mx, my, MPFR_RNDN);
+        mpf_class ref(0, prec + guard_bits);
+        mpfr_get_f(ref.get_mpf_t(), mz, MPFR_RNDN);
+        mpfr_clears(mx, my, mz, static_cast<mpfr_ptr>(nullptr));
+#else
+        mpf_set_default_prec(prec + guard_bits);
+        mpf_class ref = pow(mpf_class(x[i], prec + guard_bits), mpf_class(y[i], prec + guard_bits));
+        mpf_set_default_prec(prec);
+#endif
+        bits = std::min(bits, accurate_bits(z[i], ref, prec));
+    }
+    st.set_accuracy(bits);
+}
+
+// pi from scratch: const_pi() caches the value of the default precision, const_pi(prec) does not
+BENCH_KERNEL(const_pi) {
+    int prec = st.prec();
+    mpf_set_default_prec(prec);
+    mpf_class pi(0, prec);
+    st.run([&] {
+        for (int64_t i = 0; i < st.n(); i++)
+            pi = const_pi(prec);
+    });
+#if defined USE_MPFR
+    mpfr_t mpi;
+    mpfr_init2(mpi, prec + guard_bits);
+    mpfr_const_pi(mpi, MPFR_RNDN);
+    mpf_class ref(0, prec + guard_bits);
+    mpfr_get_f(ref.get_mpf_t(), mpi, MPFR_RNDN);
+    mpfr_clear(mpi);
+#else
+    mpf_set_default_prec(prec + guard_bits);
+    mpf_class ref = const_pi(prec + guard_bits);
+    mpf_set_default_prec(prec);
+#endif
+    st.set_accuracy(accurate_bits(pi, ref, prec));
+}
+
+int main(int argc, char **argv) {
+#if !defined USE_MPFR
+    std::cerr << "bench_functions: built without MPFR, the accuracy compares each function with itself at " << guard_bits
+              << " more bits and misses errors that do not depend on the precision" << std::endl;
+#endif
+    return bench::main(argc, argv);
+}
@@ -0,0 +1,190 @@
+#include <iostream>
+#include <vector>
+#include <gmp.h>
+
+#if defined USE_ORIGINAL_GMPXX
+#include <gmpxx.h>
+#else
+#include "gmpxx_mkII.h"
+#if !defined ___GMPXX_STRICT_COMPATIBILITY___
+using namespace gmpxx;
+#endif
+#endif
+
+#include "harness.hpp"
+
+#include "../00_Rdot/Rdot.hpp"
+#include "../01_Raxpy/Raxpy.hpp"
+#include "../03_Rgemm/Rgemm.hpp"
+
+// The kernels of benchmarks/0x_*/R*_gmp_kernel_01 and the OpenMP variants of Rdot, on one harness; each is checked
+// against the mpblas reference. Built once per variant (orig, mkII, mkIISR), see benchmarks/harness/go.sh.
+
+static std::vector<mpf_class> random_vector(int64_t n, int prec, unsigned long seed) {
+    gmp_randclass r(gmp_randinit_default);
+    r.seed(seed);
+    std::vector<mpf_class> v(n, mpf_class(0, prec));
+    for (int64_t i = 0; i < n; i++)
+        v[i] = r.get_f(prec);
+    return v;
+}
+
+// |value - reference| small relative to the reference at the working precision
+static bool close(const mpf_class &value, const mpf_class &reference, int prec) {
+    mpf_class diff = abs(value - reference), bound = abs(reference) + 1;
+    mpf_div_2exp(bound.get_mpf_t(), bound.get_mpf_t(), prec / 2);
+    return diff <= bound;
+}
+
+BENCH_KERNEL(Rdot) {
+    int64_t n = st.n();
+    mpf_set_default_prec(st.prec());
+    std::vector<mpf_class> x = random_vector(n, st.prec(), 42), y = random_vector(n, st.prec(), 43);
+    mpf_class ans;
+    st.set_flops(2.0 * n - 1);
+    st.run([&] {
+        mpf_class temp = 0.0;
+        for (int64_t i = 0; i < n; i++)
+            temp += x[i] * y[i];
+        ans = temp;
+    });
+    st.check(close(ans, Rdot(n, x.data(), 1, y.data(), 1), st.prec()));
+}
+
+// the same loop on the GMP C interface: it does not depend on gmpxx_mkII.h, so perfcheck.py uses it to
+// calibrate the speed of the machine
+BENCH_KERNEL(Rdot_C) {
+    int64_t n = st.n();
+    mpf_set_default_prec(st.prec());
+    std::vector<mpf_class> x = random_vector(n, st.prec(), 42), y = random_vector(n, st.prec(), 43);
+    mpf_t temp, product;
+    mpf_init2(temp, st.prec());
+    mpf_init2(product, st.prec());
+    st.set_flops(2.0 * n - 1);
+    st.run([&] {
+        mpf_set_ui(temp, 0);
+        for (int64_t i = 0; i < n; i++) {
+            mpf_mul(product, x[i].get_mpf_t(), y[i].get_mpf_t());
+            mpf_add(temp, temp, product);
+        }
+    });
+    st.check(close(mpf_class(temp), Rdot(n, x.data(), 1, y.data(), 1), st.prec()));
+    mpf_clear(temp);
+    mpf_clear(product);
+}
+
+// exp(1/2) from n terms of its Taylor series by Horner's rule on the GMP C interface: a compute-bound loop on a
+// few values, like the elementary functions, that perfcheck.py uses to calibrate them where Rdot_C streams memory
+BENCH_KERNEL(Rhorner_C) {
+    int64_t n = st.n();
+    mpf_set_default_prec(st.prec());
+    mpf_t x, sum;
+    mpf_init2(x, st.prec());
+    mpf_init2(sum, st.prec());
+    mpf_set_d(x, 0.5);
+    st.set_flops(3.0 * n);
+    st.run([&] {
+        mpf_set_ui(sum, 1);
+        for (int64_t i = n; i >= 1; i--) {
+            mpf_mul(sum, sum, x);
+            mpf_div_ui(sum, sum, static_cast<unsigned long>(i));
+            mpf_add_ui(sum, sum, 1);
+        }
+    });
+    mpf_class reference(1, st.prec()), half(0.5, st.prec());
+    for (int64_t i = n; i >= 1; i--)
+        reference = reference * half / static_cast<unsigned long>(i) + 1;
+    st.check(close(mpf_class(sum), reference, st.prec()));
+    mpf_clear(x);
+    mpf_clear(sum);
+}
+
+BENCH_KERNEL(Rdot_openmp) {
+    int64_t n = st.n();
+    mpf_set_default_prec(st.prec());
+    std::vector<mpf_class> x = random_vector(n, st.prec(), 42), y = random_vector(n, st.prec(), 43);
+    mpf_class ans;
+    st.set_flops(2.0 * n - 1);
+    st.run([&] {
+        mpf_class temp = 0.0;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            mpf_class templ = 0.0;
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+            for (int64_t i = 0; i < n; i++)
+                templ += x[i] * y[i];
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+            temp += templ;
+        }
+        ans = temp;
+    });
+    st.check(close(ans, Rdot(n, x.data(), 1, y.data(), 1), st.prec()));
+}
+
+BENCH_KERNEL(Raxpy) {
+    int64_t n = st.n();
+    mpf_set_default_prec(st.prec());
+    std::vector<mpf_class> x = random_vector(n, st.prec(), 42), y0 = random_vector(n, st.prec(), 43), y(y0), yy(y0);
+    mpf_class alpha = random_vector(1, st.prec(), 44)[0];
+    st.set_flops(2.0 * n);
+    st.run([&] { std::copy(y0.begin(), y0.end(), y.begin()); },
+           [&] {
+               for (int64_t i = 0; i < n; i++)
+                   y[i] += alpha * x[i];
+           });
+    Raxpy(n, alpha, x.data(), 1, yy.data(), 1);
+    for (int64_t i = 0; i < n; i++)
+        st.check(close(y[i], yy[i], st.prec()));
+}
+
+// n x n matrix times vector; the reference is Rgemm with one column
+BENCH_KERNEL(Rgemv) {
+    int64_t n = st.n();
+    mpf_set_default_prec(st.prec());
+    std::vector<mpf_class> A = random_vector(n * n, st.prec(), 42), x = random_vector(n, st.prec(), 43), y0 = random_vector(n, st.prec(), 44), y(y0), yy(y0);
+    mpf_class alpha = random_vector(1, st.prec(), 45)[0], beta = random_vector(1, st.prec(), 46)[0];
+    st.set_flops(2.0 * n * n);
+    st.run([&] { std::copy(y0.begin(), y0.end(), y.begin()); },
+           [&] {
+               for (int64_t i = 0; i < n; i++) {
+                   mpf_class temp = 0;
+                   for (int64_t j = 0; j < n; j++)
+                       temp += A[i + j * n] * x[j];
+                   y[i] = alpha * temp + beta * y[i];
+               }
+           });
+    Rgemm("n", "n", n, 1, n, alpha, A.data(), n, x.data(), n, beta, yy.data(), n);
+    for (int64_t i = 0; i < n; i++)
+        st.check(close(y[i], yy[i], st.prec()));
+}
+
+// n x n matrices
+BENCH_KERNEL(Rgemm) {
+    int64_t n = st.n();
+    mpf_set_default_prec(st.prec());
+    std::vector<mpf_class> A = random_vector(n * n, st.prec(), 42), B = random_vector(n * n, st.prec(), 43), C0 = random_vector(n * n, st.prec(), 44), C(C0), CC(C0);
+    mpf_class alpha = random_vector(1, st.prec(), 45)[0], beta = random_vector(1, st.prec(), 46)[0];
+    st.set_flops(2.0 * n * n * n + 2.0 * n * n);
+    st.run([&] { std::copy(C0.begin(), C0.end(), C.begin()); },
+           [&] {
+               for (int64_t j = 0; j < n; j++) {
+                   for (int64_t i = 0; i < n; i++) {
+                       mpf_class temp = 0;
+                       for (int64_t l = 0; l < n; l++)
+                           temp += A[i + l * n] * B[l + j * n];
+                       C[i + j * n] = alpha * temp + beta * C[i + j * n];
+                   }
+               }
+           });
+    Rgemm("n", "n", n, n, n, alpha, A.data(), n, B.data(), n, beta, CC.data(), n);
+    for (int64_t i = 0; i < n * n; i++)
+        st.check(close(C[i], CC[i], st.prec()));
+}
+
+int main(int argc, char **argv) { return bench::main(argc, argv); }
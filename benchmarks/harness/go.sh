@@ -0,0 +1,35 @@
+# runs bench_kernels of every variant over the same sweep and plots the records, then times the elementary
+# functions of mkII and mkIISR over FUNCTION_PRECS (bench_functions, FUNCTION_SIZE arguments per run).
+# bench_kernels_mkII_stats adds the GMP allocations per element to results/stats_*.
+# SIZES, PRECS, THREADS and REPEAT override the defaults, e.g. SIZES=100,1000 PRECS=512 bash go.sh
+SIZES=${SIZES:-1000,10000,100000}
+PRECS=${PRECS:-128,512,2048}
+THREADS=${THREADS:-1,$(nproc)}
+REPEAT=${REPEAT:-5}
+uname -a
+cat /proc/cpuinfo | grep 'model name' | head -1
+echo
+mkdir -p results
+variants=(
+    "orig"
+    "mkII"
+    "mkIISR"
+)
+for variant in "${variants[@]}"; do
+    # gemv and gemm are O(n^2) and O(n^3): swept at the square roots and cube roots of the vector sizes
+    ./bench_kernels_${variant} --filter Rdot --sizes $SIZES --precs $PRECS --threads $THREADS --repeat $REPEAT --json results/Rdot_${variant}.json --csv results/Rdot_${variant}.csv
+    ./bench_kernels_${variant} --filter Raxpy --sizes $SIZES --precs $PRECS --threads 1 --repeat $REPEAT --json results/Raxpy_${variant}.json --csv results/Raxpy_${variant}.csv
+    ./bench_kernels_${variant} --filter Rgemv --sizes ${GEMV_SIZES:-30,100,300} --precs $PRECS --threads 1 --repeat $REPEAT --json results/Rgemv_${variant}.json --csv results/Rgemv_${variant}.csv
+    ./bench_kernels_${variant} --filter Rgemm --sizes ${GEMM_SIZES:-10,20,50} --precs $PRECS --threads 1 --repeat $REPEAT --json results/Rgemm_${variant}.json --csv results/Rgemm_${variant}.csv
+    echo
+done
+# allocations per element of the kernels; the timings of this build include the counting
+./bench_kernels_mkII_stats --filter Ra --sizes 1000 --precs $PRECS --threads 1 --repeat 1 --warmup 0 --json results/stats_Raxpy_mkII.json --csv results/stats_Raxpy_mkII.csv
+./bench_kernels_mkII_stats --filter Rdot --sizes 1000 --precs $PRECS --threads 1 --repeat 1 --warmup 0 --json results/stats_Rdot_mkII.json --csv results/stats_Rdot_mkII.csv
+./bench_kernels_mkII_stats --filter Rge --sizes 30 --precs $PRECS --threads 1 --repeat 1 --warmup 0 --json results/stats_Rgemx_mkII.json --csv results/stats_Rgemx_mkII.csv
+echo
+for variant in mkII mkIISR; do
+    ./bench_functions_${variant} --sizes ${FUNCTION_SIZE:-16} --precs ${FUNCTION_PRECS:-64,256,1024,4096,16384,65536} --repeat $REPEAT --json results/functions_${variant}.json --csv results/functions_${variant}.csv
+    echo
+done
+python3 plot.py results/R*.csv
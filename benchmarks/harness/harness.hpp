@@ -0,0 +1,301 @@
+// harness.hpp: a small benchmark harness shared by the kernels in benchmarks/.
+// Kernels register themselves once with BENCH_KERNEL(name) and get a bench::state that holds the size, precision
+// and thread count of the current point of the sweep. A kernel sets up its data, states its flop count, and passes
+// the timed body to state::run, which repeats it after warm up runs. bench::main parses
+//   --sizes 1000,10000 --precs 128,512 --threads 1,4 --repeat 5 --warmup 1 --filter dot --json out.json --csv out.csv
+// sweeps every registered kernel whose name contains the filter over all combinations, prints a table with the
+// minimum, median, mean and standard deviation of the repetitions, and writes the same records as JSON and CSV.
+// --clock cpu times the runs in CPU time of the process, summed over its threads, instead of wall time: it leaves
+// out the time other processes on a shared machine take, at the cost of hiding idle threads.
+// Kernels that compute approximations may also report the accuracy they achieved, in bits.
+// Built with -D___GMPXX_MKII_STATS___, the harness also counts the GMP allocations of the timed runs, on all
+// threads, and reports them per run and element (n).
+// The variant (orig, mkII, mkIISR, compat) is taken from the macros the driver was compiled with, so the records of
+// the three builds of one driver can be compared directly.
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#if defined _OPENMP
+#include <omp.h>
+#endif
+
+namespace bench {
+
+#if defined ___GMPXX_MKII_STATS___ && !defined USE_ORIGINAL_GMPXX && !defined ___GMPXX_DONT_USE_NAMESPACE___
+using gmpxx::stats_total;
+#endif
+
+inline const char *variant() {
+#if defined USE_ORIGINAL_GMPXX
+    return "orig";
+#elif defined ___GMPXX_STRICT_COMPATIBILITY___
+    return "compat";
+#elif defined ___GMPXX_MKII_NOPRECCHANGE___
+    return "mkIISR";
+#else
+    return "mkII";
+#endif
+}
+
+struct result {
+    std::string kernel;
+    int64_t n;
+    int prec;
+    int threads;
+    std::vector<double> seconds;
+    double flops;
+    double accuracy;
+    double allocations;
+    bool ok;
+    double min() const { return *std::min_element(seconds.begin(), seconds.end()); }
+    double median() const {
+        std::vector<double> s(seconds);
+        std::sort(s.begin(), s.end());
+        std::size_t h = s.size() / 2;
+        return (s.size() % 2) ? s[h] : (s[h - 1] + s[h]) / 2;
+    }
+    double mean() const {
+        double sum = 0;
+        for (double t : seconds)
+            sum += t;
+        return sum / seconds.size();
+    }
+    // sample standard deviation, 0 for a single repetition
+    double stddev() const {
+        if (seconds.size() < 2)
+            return 0;
+        double m = mean(), sum = 0;
+        for (double t : seconds)
+            sum += (t - m) * (t - m);
+        return std::sqrt(sum / (seconds.size() - 1));
+    }
+    // from the median, 0 when the kernel stated no flop count and negative (no rate) when the median time is 0
+    double mflops() const { return median() > 0 ? flops / median() / 1e6 : -1; }
+};
+
+class state {
+  public:
+    state(int64_t _n, int _prec, int _threads, int _repeat, int _warmup, bool _cpu_time = false)
+        : n_(_n), prec_(_prec), threads_(_threads), repeat(_repeat), warmup(_warmup), cpu_time(_cpu_time) {}
+    int64_t n() const { return n_; }
+    int prec() const { return prec_; }
+    int threads() const { return threads_; }
+    // floating point operations of one run of the body
+    void set_flops(double _flops) { flops_ = _flops; }
+    // a failed check marks the record as NG
+    void check(bool _ok) { ok_ = ok_ && _ok; }
+    // correct bits of the results, the worst case over the inputs; negative when not reported
+    void set_accuracy(double bits) { accuracy_ = bits; }
+    // GMP allocations per timed run and element; negative unless built with -D___GMPXX_MKII_STATS___
+    double allocations() const { return timed_runs ? static_cast<double>(allocations_) / timed_runs / std::max<int64_t>(n_, 1) : -1; }
+    // setup() before every run is not timed, body() is
+    template <typename Setup, typename Body> void run(Setup setup, Body body) {
+        for (int r = 0; r < warmup + repeat; r++) {
+            setup();
+#if defined ___GMPXX_MKII_STATS___ && !defined USE_ORIGINAL_GMPXX
+            uint64_t allocated = stats_total().allocations;
+#endif
+            double start = now();
+            body();
+            double end = now();
+            if (r >= warmup) {
+                seconds_.push_back(end - start);
+#if defined ___GMPXX_MKII_STATS___ && !defined USE_ORIGINAL_GMPXX
+                allocations_ += stats_total().allocations - allocated;
+                timed_runs++;
+#endif
+            }
+        }
+    }
+    template <typename Body> void run(Body body) {
+        run([] {}, body);
+    }
+    const std::vector<double> &seconds() const { return seconds_; }
+    double flops() const { return flops_; }
+    double accuracy() const { return accuracy_; }
+    bool ok() const { return ok_; }
+
+  private:
+    double now() const {
+        if (cpu_time) {
+            timespec t;
+            clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &t);
+            return t.tv_sec + t.tv_nsec * 1e-9;
+        }
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    int64_t n_;
+    int prec_, threads_, repeat, warmup;
+    bool cpu_time;
+    double flops_ = 0, accuracy_ = -1;
+    uint64_t allocations_ = 0;
+    int timed_runs = 0;
+    bool ok_ = true;
+    std::vector<double> seconds_;
+};
+
+struct kernel {
+    std::string name;
+    std::function<void(state &)> body;
+};
+inline std::vector<kernel> &registry() {
+    static std::vector<kernel> kernels;
+    return kernels;
+}
+struct registrar {
+    registrar(const char *name, std::function<void(state &)> body) { registry().push_back({name, body}); }
+};
+#define BENCH_KERNEL(name)                                                                                                                                     \
+    static void bench_kernel_##name(bench::state &);                                                                                                           \
+    static bench::registrar bench_registrar_##name(#name, bench_kernel_##name);                                                                                \
+    static void bench_kernel_##name(bench::state &st)
+
+inline std::string cpu_model() {
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        if (line.compare(0, 10, "model name") == 0) {
+            std::size_t colon = line.find(':');
+            return colon == std::string::npos ? line : line.substr(line.find_first_not_of(' ', colon + 1));
+        }
+    }
+    return "unknown";
+}
+inline std::string json_string(const std::string &s) {
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\')
+            out += '\\';
+        out += c;
+    }
+    return out + "\"";
+}
+// a value of a record that may not have been measured (negative); inf and nan, which JSON cannot hold, count as such
+inline std::string optional_text(double value, const char *none) {
+    if (value < 0 || !std::isfinite(value))
+        return none;
+    std::ostringstream out;
+    out << value;
+    return out.str();
+}
+inline void write_json(const std::string &path, const std::vector<result> &results) {
+    std::ofstream out(path);
+    out << "{\n  \"variant\": " << json_string(variant()) << ",\n  \"cpu\": " << json_string(cpu_model()) << ",\n  \"results\": [\n";
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const result &r = results[i];
+        out << "    {\"kernel\": " << json_string(r.kernel) << ", \"variant\": " << json_string(variant()) << ", \"n\": " << r.n << ", \"prec\": " << r.prec << ", \"threads\": " << r.threads
+            << ", \"repeat\": " << r.seconds.size() << ", \"min\": " << r.min() << ", \"median\": " << r.median() << ", \"mean\": " << r.mean() << ", \"stddev\": " << r.stddev()
+            << ", \"mflops\": " << optional_text(r.mflops(), "null") << ", \"accuracy\": " << optional_text(r.accuracy, "null") << ", \"allocations\": " << optional_text(r.allocations, "null") << ", \"ok\": " << (r.ok ? "true" : "false") << ", \"seconds\": [";
+        for (std::size_t j = 0; j < r.seconds.size(); j++)
+            out << (j ? ", " : "") << r.seconds[j];
+        out << "]}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+inline void write_csv(const std::string &path, const std::vector<result> &results) {
+    std::ofstream out(path);
+    out << "kernel,variant,n,prec,threads,repeat,min,median,mean,stddev,mflops,accuracy,allocations,ok\n";
+    for (const result &r : results)
+        out << r.kernel << "," << variant() << "," << r.n << "," << r.prec << "," << r.threads << "," << r.seconds.size() << "," << r.min() << "," << r.median() << "," << r.mean() << ","
+            << r.stddev() << "," << optional_text(r.mflops(), "") << "," << optional_text(r.accuracy, "") << "," << optional_text(r.allocations, "") << "," << (r.ok ? "OK" : "NG") << "\n";
+}
+
+template <typename T> std::vector<T> parse_list(const std::string &s) {
+    std::vector<T> values;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ','))
+        values.push_back(static_cast<T>(std::atoll(item.c_str())));
+    return values;
+}
+
+inline int main(int argc, char **argv) {
+    std::vector<int64_t> sizes = {1000};
+    std::vector<int> precs = {512}, threads = {1};
+    int repeat = 5, warmup = 1;
+    bool cpu_time = false;
+    std::string filter, json, csv;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--list") {
+            for (const kernel &k : registry())
+                std::cout << k.name << std::endl;
+            return EXIT_SUCCESS;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Usage: " << argv[0] << " [--list] [--sizes n,...] [--precs bits,...] [--threads t,...] [--repeat r] [--warmup w] [--clock wall|cpu] [--filter name] [--json file] [--csv file]" << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::string value = argv[++i];
+        if (arg == "--sizes")
+            sizes = parse_list<int64_t>(value);
+        else if (arg == "--precs")
+            precs = parse_list<int>(value);
+        else if (arg == "--threads")
+            threads = parse_list<int>(value);
+        else if (arg == "--repeat")
+            repeat = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--warmup")
+            warmup = std::max(0, std::atoi(value.c_str()));
+        else if (arg == "--clock" && (value == "wall" || value == "cpu"))
+            cpu_time = value == "cpu";
+        else if (arg == "--filter")
+            filter = value;
+        else if (arg == "--json")
+            json = value;
+        else if (arg == "--csv")
+            csv = value;
+        else {
+            std::cerr << "unknown option " << arg << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::vector<result> results;
+    std::printf("variant %s, %s\n", variant(), cpu_model().c_str());
+    std::printf("%-24s %12s %6s %4s %12s %12s %12s %10s %12s %8s %9s %3s\n", "kernel", "n", "prec", "thr", "min [s]", "median [s]", "mean [s]", "stddev", "MFLOPS", "bits", "allocs/n", "");
+    for (const kernel &k : registry()) {
+        if (k.name.find(filter) == std::string::npos)
+            continue;
+        for (int t : threads) {
+#if defined _OPENMP
+            omp_set_num_threads(t);
+#endif
+            for (int prec : precs) {
+                for (int64_t n : sizes) {
+                    state st(n, prec, t, repeat, warmup, cpu_time);
+                    k.body(st);
+                    if (st.seconds().empty())
+                        continue;
+                    result r{k.name, n, prec, t, st.seconds(), st.flops(), st.accuracy(), st.allocations(), st.ok()};
+                    std::printf("%-24s %12lld %6d %4d %12.6g %12.6g %12.6g %10.3g %12s %8s %9s %3s\n", r.kernel.c_str(), static_cast<long long>(n), prec, t, r.min(), r.median(), r.mean(),
+                                r.stddev(), optional_text(r.mflops(), "-").c_str(), optional_text(r.accuracy, "-").c_str(), optional_text(r.allocations, "-").c_str(), r.ok ? "OK" : "NG");
+                    std::fflush(stdout);
+                    results.push_back(r);
+                }
+            }
+        }
+    }
+    if (!json.empty())
+        write_json(json, results);
+    if (!csv.empty())
+        write_csv(csv, results);
+    for (const result &r : results)
+        if (!r.ok)
+            return EXIT_FAILURE;
+    return EXIT_SUCCESS;
+}
+
+} // namespace bench
@@ -0,0 +1,203 @@
+import argparse
+import json
+import math
+import os
+import re
+import subprocess
+import sys
+
+# Performance regression gate: reruns a fixed, short subset of the harness kernels and elementary functions and
+# compares every point to the baseline of this machine class in baselines/<class>.json.
+# Shared machines drift in speed by tens of percent within seconds, so times are not compared directly: the suite
+# runs --rounds times, every entry next to a calibration kernel on the GMP C interface that does not depend on
+# gmpxx_mkII.h, and each round gives the best time of the entry over the best time of the calibration at the same
+# precision. The calibration has to load the machine the way the entry does: a competing process slows memory-bound
+# and compute-bound loops by different factors, and it preempts runs longer than a scheduler time slice but not
+# shorter ones. The BLAS kernels run after Rdot_C, a dot product that streams its vectors and takes about as long as
+# they do. The elementary functions are followed by Rhorner_C, a Taylor series on a few values, with as many terms
+# as take as long as the point, and their ratios are over the time of one term.
+# A point regresses when the median of these ratios is more than --threshold above the baseline and a one-sided
+# Mann-Whitney U test over the rounds says the slowdown is not noise (p < --alpha), or when it lost more than one
+# bit of accuracy.
+#   python3 perfcheck.py            # compare, exit status 1 on a regression, 2 without a baseline
+#   python3 perfcheck.py --update   # record the baseline of this machine class
+# The machine class is the CPU model name, or --machine / PERFCHECK_MACHINE.
+
+# (executable, arguments, calibration). A calibration with --sizes runs once before its entry, one without runs
+# after every point of the entry at the point's precision, sized to the point.
+MEMORY_CALIBRATION = ('bench_kernels_mkII', ['--filter', 'Rdot_C', '--sizes', '10000', '--precs', '512', '--threads', '1'])
+COMPUTE_CALIBRATION = ('bench_kernels_mkII', ['--filter', 'Rhorner_C'])
+SUITE = [
+    ('bench_kernels_mkII', ['--filter', 'Rdot', '--sizes', '10000', '--precs', '512', '--threads', '1'], MEMORY_CALIBRATION),
+    ('bench_kernels_mkII', ['--filter', 'Raxpy', '--sizes', '10000', '--precs', '512'], MEMORY_CALIBRATION),
+    ('bench_kernels_mkII', ['--filter', 'Rgemv', '--sizes', '50', '--precs', '512'], MEMORY_CALIBRATION),
+    ('bench_kernels_mkII', ['--filter', 'Rgemm', '--sizes', '16', '--precs', '512'], MEMORY_CALIBRATION),
+]
+FUNCTIONS = ['exp', 'log', 'sin', 'cos', 'atan', 'pow', 'const_pi']
+SUITE += [('bench_functions_mkII', ['--filter', f, '--sizes', '8', '--precs', '256,1024'], COMPUTE_CALIBRATION) for f in FUNCTIONS]
+
+# exit status when there is no baseline to compare against, distinct from a regression
+NO_BASELINE = 2
+
+
+def cpu_model():
+    try:
+        with open('/proc/cpuinfo') as cpuinfo:
+            for line in cpuinfo:
+                if line.startswith('model name'):
+                    return line.split(':', 1)[1].strip()
+    except OSError:
+        pass
+    return 'unknown'
+
+
+def median(values):
+    s = sorted(values)
+    h = len(s) // 2
+    return s[h] if len(s) % 2 else (s[h - 1] + s[h]) / 2
+
+
+def machine_class(name):
+    return re.sub(r'[^A-Za-z0-9]+', '_', name).strip('_')
+
+
+def run(exe, args, repeat, warmup):
+    out = 'perfcheck_tmp.json'
+    command = ['./' + exe] + args + ['--repeat', str(repeat), '--warmup', str(warmup), '--clock', 'cpu', '--json', out]
+    # the notes the benchmarks print on stderr would repeat for every run: show them only when a run fails
+    process = subprocess.run(command, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE, text=True)
+    if process.returncode != 0:
+        sys.stderr.write(process.stderr)
+        process.check_returncode()
+    with open(out) as file:
+        records = json.load(file)['results']
+    os.remove(out)
+    # exact matches of the filter only: bench_kernels --filter Rdot also runs Rdot_C and Rdot_openmp
+    name = args[args.index('--filter') + 1]
+    return [r for r in records if r['kernel'] == name]
+
+
+# the time per term of a sized calibration at prec, for a point that took seconds
+def sized_calibration(calibration, prec, seconds, per_term, repeat, warmup):
+    exe, args = calibration
+    if prec not in per_term:
+        probe = run(exe, args + ['--sizes', '1000', '--precs', str(prec)], repeat, warmup)[0]
+        per_term[prec] = min(probe['seconds']) / probe['n']
+    terms = max(100, round(seconds / per_term[prec]))
+    c = run(exe, args + ['--sizes', str(terms), '--precs', str(prec)], repeat, warmup)[0]
+    per_term[prec] = min(c['seconds']) / c['n']
+    return per_term[prec]
+
+
+def run_suite(rounds, repeat, warmup):
+    points = {}
+    per_term = {}
+    for _ in range(rounds):
+        for exe, args, calibration_run in SUITE:
+            sized = '--sizes' not in calibration_run[1]
+            if not sized:
+                calibration = {c['prec']: min(c['seconds']) for c in run(*calibration_run, repeat, warmup)}
+            for r in run(exe, args, repeat, warmup):
+                point = points.setdefault(key(r), {'kernel': r['kernel'], 'n': r['n'], 'prec': r['prec'], 'threads': r['threads'], 'accuracy': r['accuracy'], 'ratios': [], 'seconds': []})
+                seconds = min(r['seconds'])
+                if sized:
+                    unit = sized_calibration(calibration_run, r['prec'], seconds, per_term, repeat, warmup)
+                else:
+                    unit = calibration.get(r['prec'], min(calibration.values()))
+                point['ratios'].append(seconds / unit)
+                point['seconds'].append(seconds)
+    return list(points.values())
+
+
+def key(record):
+    return (record['kernel'], record['n'], record['prec'], record['threads'])
+
+
+# P(U >= u) for the baseline sample a against the current sample b, normal approximation with tie correction
+def mann_whitney_greater(a, b):
+    values = sorted([(x, 0) for x in a] + [(x, 1) for x in b])
+    ranks = [0.0] * len(values)
+    ties = 0.0
+    i = 0
+    while i < len(values):
+        j = i
+        while j + 1 < len(values) and values[j + 1][0] == values[i][0]:
+            j += 1
+        for k in range(i, j + 1):
+            ranks[k] = (i + j) / 2 + 1
+        t = j - i + 1
+        ties += t ** 3 - t
+        i = j + 1
+    n1, n2 = len(a), len(b)
+    n = n1 + n2
+    u = sum(r for r, (_, sample) in zip(ranks, values) if sample == 1) - n2 * (n2 + 1) / 2
+    mean = n1 * n2 / 2
+    variance = n1 * n2 / 12 * ((n + 1) - ties / (n * (n - 1)))
+    if variance <= 0:
+        return 1.0
+    z = (u - mean - 0.5) / math.sqrt(variance)
+    return 0.5 * math.erfc(z / math.sqrt(2))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='compare the harness subset against the stored baseline')
+    parser.add_argument('--update', action='store_true', help='record the baseline of this machine class')
+    parser.add_argument('--machine', default=os.environ.get('PERFCHECK_MACHINE', ''), help='machine class, default: the CPU model')
+    parser.add_argument('--threshold', type=float, default=0.10, help='relative slowdown of the median that counts (0.10)')
+    parser.add_argument('--alpha', type=float, default=0.01, help='significance level of the U test (0.01)')
+    parser.add_argument('--rounds', type=int, default=11)
+    parser.add_argument('--repeat', type=int, default=5)
+    parser.add_argument('--warmup', type=int, default=1)
+    options = parser.parse_args()
+
+    cpu = cpu_model()
+    machine = options.machine or machine_class(cpu)
+    path = os.path.join('baselines', machine + '.json')
+    records = run_suite(options.rounds, options.repeat, options.warmup)
+
+    if options.update:
+        os.makedirs('baselines', exist_ok=True)
+        with open(path, 'w') as file:
+            json.dump({'machine': machine, 'cpu': cpu, 'results': records}, file, indent=1)
+            file.write('\n')
+        print(f'baseline of {machine} written to {path} ({len(records)} points)')
+        return 0
+    if not os.path.exists(path):
+        print(f'perfcheck: NOTHING WAS CHECKED, there is no baseline for machine class {machine} ({path}); record one with make perfcheck_baseline', file=sys.stderr)
+        return NO_BASELINE
+
+    with open(path) as file:
+        baseline = {key(r): r for r in json.load(file)['results']}
+    print(f'machine class {machine}, threshold {options.threshold:.0%}, alpha {options.alpha}')
+    print(f'{"kernel":<12} {"n":>7} {"prec":>5} {"thr":>3} {"base":>8} {"now":>8} {"now [s]":>11} {"ratio":>6} {"p":>8} {"bits":>13}')
+    regressions = 0
+    for r in records:
+        b = baseline.get(key(r))
+        if b is None:
+            print(f'{r["kernel"]:<12} {r["n"]:>7} {r["prec"]:>5} {r["threads"]:>3}  not in the baseline')
+            continue
+        # times relative to the calibration
+        base, now = median(b['ratios']), median(r['ratios'])
+        ratio = now / base
+        p = mann_whitney_greater(b['ratios'], r['ratios'])
+        slower = ratio > 1 + options.threshold and p < options.alpha
+        bits = ''
+        lost_bits = False
+        if r.get('accuracy') is not None and b.get('accuracy') is not None:
+            bits = f'{b["accuracy"]:.0f}->{r["accuracy"]:.0f}'
+            lost_bits = r['accuracy'] < b['accuracy'] - 1
+        verdict = 'SLOWER' if slower else ''
+        if lost_bits:
+            verdict += ' LESS ACCURATE'
+        if slower or lost_bits:
+            regressions += 1
+        print(f'{r["kernel"]:<12} {r["n"]:>7} {r["prec"]:>5} {r["threads"]:>3} {base:>8.4g} {now:>8.4g} {median(r["seconds"]):>11.4g} {ratio:>6.3f} {p:>8.2g} {bits:>13} {verdict}')
+    if regressions:
+        print(f'{regressions} regression(s) against {path}')
+        return 1
+    print(f'no regression against {path}')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
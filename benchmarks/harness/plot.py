@@ -0,0 +1,46 @@
+import csv
+import sys
+from collections import defaultdict
+
+import matplotlib.pyplot as plt
+
+# Plots the CSV records written by bench_kernels --csv: MFLOPS over the size for every kernel, precision and
+# thread count, one line per variant, with the spread of the repetitions as error bars.
+if len(sys.argv) < 2:
+    print("Usage: python plot.py results/*.csv")
+    sys.exit(1)
+
+colors = {'orig': 'blue', 'mkII': 'green', 'mkIISR': 'red', 'compat': 'gray'}
+
+series = defaultdict(list)
+for file_path in sys.argv[1:]:
+    with open(file_path, newline='') as file:
+        for row in csv.DictReader(file):
+            # no rate for a point whose median time was 0
+            if not row['mflops']:
+                continue
+            key = (row['kernel'], int(row['prec']), int(row['threads']))
+            series[key].append(row)
+
+for (kernel, prec, threads), rows in sorted(series.items()):
+    plt.figure(figsize=(8, 5))
+    by_variant = defaultdict(list)
+    for row in rows:
+        by_variant[row['variant']].append(row)
+    for variant, points in sorted(by_variant.items()):
+        points.sort(key=lambda row: int(row['n']))
+        n = [int(row['n']) for row in points]
+        mflops = [float(row['mflops']) for row in points]
+        # the standard deviation of the time as a relative spread of MFLOPS
+        spread = [float(row['mflops']) * float(row['stddev']) / float(row['median']) if float(row['median']) > 0 else 0 for row in points]
+        plt.errorbar(n, mflops, yerr=spread, marker='o', capsize=3, label=variant, color=colors.get(variant))
+    plt.xscale('log')
+    plt.xlabel('n')
+    plt.ylabel('MFLOPS (median)')
+    plt.title(f'{kernel}, {prec} bits, {threads} threads')
+    plt.legend()
+    plt.grid(True, which='both', linestyle=':')
+    output = f'results/{kernel}_{prec}_{threads}.png'
+    plt.savefig(output, bbox_inches='tight')
+    plt.close()
+    print(f'Wrote {output}')
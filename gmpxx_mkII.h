@@ -38,6 +38,7 @@
 #include <gmp.h>
 #include <limits>
 #include <iostream>
+#include <locale>
 #include <utility>
 #include <cassert>
 #include <cstring>
@@ -48,9 +49,61 @@
 #include <tuple>
 #include <iomanip>
 #include <type_traits>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <charconv>
+#include <cctype>
+#include <exception>
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <new>
+#include <cstddef>
+#include <atomic>
+#if defined _OPENMP
+#include <omp.h>
+#endif
+#if defined ___GMPXX_MKII_USE_NUMA___
+#include <numa.h>
+#include <sched.h>
+#endif
+#if defined ___GMPXX_MKII_USE_HUGETLB___ && !defined ___GMPXX_MKII_USE_HUGEPAGES___
+#define ___GMPXX_MKII_USE_HUGEPAGES___
+#endif
+#if defined ___GMPXX_MKII_MPQ_SMALL___ && !defined ___GMPXX_MKII_MPZ_SMALL___
+#define ___GMPXX_MKII_MPZ_SMALL___
+#endif
+#if defined ___GMPXX_MKII_USE_HUGEPAGES___
+#include <sys/mman.h>
+#endif
+#if defined ___GMPXX_MKII_PROFILE___
+#include <chrono>
+#endif
+#if __cplusplus >= 202002L && __has_include(<format>)
+#include <format>
+#endif
+#if __cplusplus >= 202002L && __has_include(<span>)
+#include <span>
+#endif
+#if defined ___GMPXX_MKII_USE_FMT___
+#include <fmt/format.h>
+#endif
 
 #define ___MPF_CLASS_EXPLICIT___ explicit
 
+// function multiversioning for the batch kernels: one clone per instruction set, chosen at load time through an ifunc.
+// GCC only vectorizes the lane loops at -O3, so the kernels ask for it.
+#if defined __clang__ && defined __x86_64__ && defined __ELF__ && !defined ___GMPXX_MKII_NO_TARGET_CLONES___
+#define ___GMPXX_MKII_TARGET_CLONES___ __attribute__((target_clones("avx512f", "avx2", "default")))
+#elif defined __GNUC__ && defined __x86_64__ && defined __ELF__ && !defined ___GMPXX_MKII_NO_TARGET_CLONES___
+#define ___GMPXX_MKII_TARGET_CLONES___ __attribute__((target_clones("avx512f", "avx2", "default"), optimize("O3")))
+#elif defined __GNUC__ && !defined __clang__
+#define ___GMPXX_MKII_TARGET_CLONES___ __attribute__((optimize("O3")))
+#else
+#define ___GMPXX_MKII_TARGET_CLONES___
+#endif
+
 #if defined ___GMPXX_STRICT_COMPATIBILITY___
 #define ___GMPXX_DONT_USE_NAMESPACE___
 #define ___GMPXX_UDL_CHAR___
@@ -91,12 +144,309 @@ namespace gmpxx {
 class mpz_class;
 class mpq_class;
 class mpf_class;
+class mpz_view;
+class mpf_view;
 
 struct gmpxx_defaults {
     static void set_default_prec(int prec) { mpf_set_default_prec(prec); }
     static mp_bitcnt_t get_default_prec() { return mpf_get_default_prec(); }
     inline static int base = 10;
 };
+#if defined ___GMPXX_MKII_STATS___
+// allocation statistics (-D___GMPXX_MKII_STATS___): the GMP memory functions are wrapped to count, per thread, the
+// allocations, reallocations and frees and the bytes they move. stats() returns the counters of the calling thread
+// and stats_total() their sum over all threads so far. A stats_scope measures a region of code on its thread:
+//   { gmpxx::stats_scope scope("dot"); ... }   // adds what the block did to region "dot", see stats_regions()
+//   gmpxx::stats_scope scope; ...; scope.counters().allocations
+// A realloc counts its new size as allocated and its old size as freed.
+struct stats_counters {
+    uint64_t allocations = 0, reallocations = 0, frees = 0;
+    uint64_t bytes_allocated = 0, bytes_freed = 0;
+    stats_counters &operator+=(const stats_counters &other) {
+        allocations += other.allocations;
+        reallocations += other.reallocations;
+        frees += other.frees;
+        bytes_allocated += other.bytes_allocated;
+        bytes_freed += other.bytes_freed;
+        return *this;
+    }
+    stats_counters operator-(const stats_counters &other) const {
+        return {allocations - other.allocations, reallocations - other.reallocations, frees - other.frees, bytes_allocated - other.bytes_allocated, bytes_freed - other.bytes_freed};
+    }
+};
+namespace helper {
+class stats_hooks {
+  public:
+    static void install() {
+        static stats_hooks hooks;
+        (void)hooks;
+    }
+    static stats_counters thread_counters() { return local().get(); }
+    static stats_counters total() {
+        std::lock_guard<std::mutex> guard(threads().lock);
+        stats_counters sum;
+        for (const block *b : threads().blocks)
+            sum += b->get();
+        return sum;
+    }
+    static void add_region(const char *name, const stats_counters &counters) {
+        std::lock_guard<std::mutex> guard(threads().lock);
+        for (auto &region : threads().regions) {
+            if (region.first == name) {
+                region.second += counters;
+                return;
+            }
+        }
+        threads().regions.emplace_back(name, counters);
+    }
+    static std::vector<std::pair<std::string, stats_counters>> regions() {
+        std::lock_guard<std::mutex> guard(threads().lock);
+        return threads().regions;
+    }
+
+  private:
+    // written by its thread only, read by total() from any thread
+    struct block {
+        std::atomic<uint64_t> allocations{0}, reallocations{0}, frees{0}, bytes_allocated{0}, bytes_freed{0};
+        stats_counters get() const {
+            return {allocations.load(std::memory_order_relaxed), reallocations.load(std::memory_order_relaxed), frees.load(std::memory_order_relaxed), bytes_allocated.load(std::memory_order_relaxed),
+                    bytes_freed.load(std::memory_order_relaxed)};
+        }
+    };
+    // the blocks outlive their threads so that stats_total() keeps what finished threads did
+    struct registry {
+        std::mutex lock;
+        std::vector<block *> blocks;
+        std::vector<std::pair<std::string, stats_counters>> regions;
+    };
+    static registry &threads() {
+        // never destroyed: limbs may be freed after the end of main
+        static registry *r = new registry;
+        return *r;
+    }
+    static block &local() {
+        thread_local block *b = [] {
+            block *fresh = new block;
+            std::lock_guard<std::mutex> guard(threads().lock);
+            threads().blocks.push_back(fresh);
+            return fresh;
+        }();
+        return *b;
+    }
+    static void bump(std::atomic<uint64_t> &counter, uint64_t n) { counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+    static inline void *(*original_alloc)(std::size_t);
+    static inline void *(*original_realloc)(void *, std::size_t, std::size_t);
+    static inline void (*original_free)(void *, std::size_t);
+    stats_hooks() {
+        mp_get_memory_functions(&original_alloc, &original_realloc, &original_free);
+        mp_set_memory_functions(stats_alloc, stats_realloc, stats_free);
+    }
+    static void *stats_alloc(std::size_t size) {
+        block &b = local();
+        bump(b.allocations, 1);
+        bump(b.bytes_allocated, size);
+        return original_alloc(size);
+    }
+    static void *stats_realloc(void *p, std::size_t old_size, std::size_t new_size) {
+        block &b = local();
+        bump(b.reallocations, 1);
+        bump(b.bytes_allocated, new_size);
+        bump(b.bytes_freed, old_size);
+        return original_realloc(p, old_size, new_size);
+    }
+    static void stats_free(void *p, std::size_t size) {
+        block &b = local();
+        bump(b.frees, 1);
+        bump(b.bytes_freed, size);
+        original_free(p, size);
+    }
+};
+} // namespace helper
+inline stats_counters stats() {
+    helper::stats_hooks::install();
+    return helper::stats_hooks::thread_counters();
+}
+inline stats_counters stats_total() {
+    helper::stats_hooks::install();
+    return helper::stats_hooks::total();
+}
+// the regions of named stats_scope objects with what they counted, in order of first use
+inline std::vector<std::pair<std::string, stats_counters>> stats_regions() { return helper::stats_hooks::regions(); }
+class stats_scope {
+  public:
+    explicit stats_scope(const char *_region = nullptr) : region(_region), start(stats()) {}
+    ~stats_scope() {
+        if (region)
+            helper::stats_hooks::add_region(region, counters());
+    }
+    stats_scope(const stats_scope &) = delete;
+    stats_scope &operator=(const stats_scope &) = delete;
+    // what this thread did since the scope was opened
+    stats_counters counters() const { return stats() - start; }
+
+  private:
+    const char *region;
+    stats_counters start;
+};
+inline std::ostream &operator<<(std::ostream &os, const stats_counters &counters) {
+    return os << counters.allocations << " allocations, " << counters.reallocations << " reallocations, " << counters.frees << " frees, " << counters.bytes_allocated << " bytes allocated, "
+              << counters.bytes_freed << " bytes freed";
+}
+#endif
+#if defined ___GMPXX_MKII_PROFILE___
+// profiling counters (-D___GMPXX_MKII_PROFILE___): the entry points marked with GMPXX_MKII_PROFILE count their calls,
+// wall time (inclusive of the calls they make) and operand limbs, and GMPXX_MKII_PROFILE_COUNT adds to event counters
+// such as AGM iterations or cache hits. Each thread counts into its own table; profile_report() and profile_json()
+// merge the tables of all threads, sorted by total time. At exit the report goes to stderr, or to the file named by
+// GMPXX_MKII_PROFILE (JSON if the name ends in .json). Without the macro both markers expand to nothing.
+struct profile_entry {
+    std::string name;
+    uint64_t calls = 0, nanoseconds = 0, limbs = 0, count = 0;
+};
+namespace helper {
+class profile_registry {
+  public:
+    static constexpr int max_sites = 256;
+    static profile_registry &instance() {
+        // never destroyed: the report at exit and static objects of other translation units still use it
+        static profile_registry *registry = new profile_registry;
+        return *registry;
+    }
+    // the id of a named counter, the same for every call site with that name; -1 when the table is full
+    int site(const char *name) {
+        std::lock_guard<std::mutex> guard(lock);
+        for (int id = 0; id < static_cast<int>(names.size()); id++)
+            if (names[id] == name)
+                return id;
+        if (static_cast<int>(names.size()) == max_sites)
+            return -1;
+        names.emplace_back(name);
+        return static_cast<int>(names.size()) - 1;
+    }
+    void add(int id, uint64_t nanoseconds, uint64_t limbs) {
+        slot &s = local().slots[id];
+        bump(s.calls, 1);
+        bump(s.nanoseconds, nanoseconds);
+        bump(s.limbs, limbs);
+    }
+    void count(int id, uint64_t n) { bump(local().slots[id].count, n); }
+    std::vector<profile_entry> entries() {
+        std::lock_guard<std::mutex> guard(lock);
+        std::vector<profile_entry> merged(names.size());
+        for (std::size_t id = 0; id < names.size(); id++) {
+            merged[id].name = names[id];
+            for (const table *t : tables) {
+                merged[id].calls += t->slots[id].calls.load(std::memory_order_relaxed);
+                merged[id].nanoseconds += t->slots[id].nanoseconds.load(std::memory_order_relaxed);
+                merged[id].limbs += t->slots[id].limbs.load(std::memory_order_relaxed);
+                merged[id].count += t->slots[id].count.load(std::memory_order_relaxed);
+            }
+        }
+        std::stable_sort(merged.begin(), merged.end(), [](const profile_entry &a, const profile_entry &b) { return a.nanoseconds > b.nanoseconds; });
+        return merged;
+    }
+    void reset() {
+        std::lock_guard<std::mutex> guard(lock);
+        for (table *t : tables)
+            for (slot &s : t->slots)
+                s.calls = s.nanoseconds = s.limbs = s.count = 0;
+    }
+
+  private:
+    // written by its thread only; the tables outlive their threads
+    struct slot {
+        std::atomic<uint64_t> calls{0}, nanoseconds{0}, limbs{0}, count{0};
+    };
+    struct table {
+        slot slots[max_sites];
+    };
+    std::mutex lock;
+    std::vector<std::string> names;
+    std::vector<table *> tables;
+    profile_registry() { std::atexit(report_at_exit); }
+    table &local() {
+        thread_local table *t = [this] {
+            table *fresh = new table;
+            std::lock_guard<std::mutex> guard(lock);
+            tables.push_back(fresh);
+            return fresh;
+        }();
+        return *t;
+    }
+    static void bump(std::atomic<uint64_t> &counter, uint64_t n) { counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+    static void report_at_exit();
+};
+// times one call from construction to destruction
+class profile_scope {
+  public:
+    profile_scope(int _id, uint64_t _limbs) : id(_id), limbs(_limbs), start(std::chrono::steady_clock::now()) {}
+    ~profile_scope() {
+        if (id >= 0)
+            profile_registry::instance().add(id, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count(), limbs);
+    }
+    profile_scope(const profile_scope &) = delete;
+    profile_scope &operator=(const profile_scope &) = delete;
+
+  private:
+    int id;
+    uint64_t limbs;
+    std::chrono::steady_clock::time_point start;
+};
+// the largest limb count of the operands
+template <typename... T> uint64_t profile_limbs(const T &...ops) { return std::max({static_cast<uint64_t>(std::abs(ops.get_mpf_t()->_mp_size))...}); }
+} // namespace helper
+#define GMPXX_MKII_PROFILE(name, limbs)                                                                                                                                          \
+    static const int ___gmpxx_mkII_profile_site = helper::profile_registry::instance().site(name);                                                                              \
+    helper::profile_scope ___gmpxx_mkII_profile_scope(___gmpxx_mkII_profile_site, limbs)
+#define GMPXX_MKII_PROFILE_COUNT(name, n)                                                                                                                                        \
+    do {                                                                                                                                                                         \
+        static const int ___gmpxx_mkII_profile_site = helper::profile_registry::instance().site(name);                                                                          \
+        if (___gmpxx_mkII_profile_site >= 0)                                                                                                                                     \
+            helper::profile_registry::instance().count(___gmpxx_mkII_profile_site, n);                                                                                           \
+    } while (0)
+// the counters of all threads so far, by total time
+inline std::vector<profile_entry> profile_entries() { return helper::profile_registry::instance().entries(); }
+inline void profile_reset() { helper::profile_registry::instance().reset(); }
+inline void profile_report(std::ostream &os) {
+    std::ios_base::fmtflags flags = os.flags();
+    os << std::left << std::setw(32) << "function" << std::right << std::setw(12) << "calls" << std::setw(14) << "total [ms]" << std::setw(12) << "ns/call" << std::setw(12) << "limbs/call"
+       << std::setw(14) << "count" << "\n";
+    for (const profile_entry &e : profile_entries()) {
+        if (e.calls == 0 && e.count == 0)
+            continue;
+        os << std::left << std::setw(32) << e.name << std::right << std::setw(12) << e.calls << std::setw(14) << std::fixed << std::setprecision(3) << e.nanoseconds / 1e6 << std::setw(12)
+           << std::setprecision(1) << (e.calls ? static_cast<double>(e.nanoseconds) / e.calls : 0.0) << std::setw(12) << (e.calls ? static_cast<double>(e.limbs) / e.calls : 0.0) << std::setw(14)
+           << e.count << "\n";
+    }
+    os.flags(flags);
+}
+inline void profile_json(std::ostream &os) {
+    os << "{\n  \"profile\": [\n";
+    std::vector<profile_entry> entries = profile_entries();
+    for (std::size_t i = 0; i < entries.size(); i++) {
+        const profile_entry &e = entries[i];
+        os << "    {\"name\": \"" << e.name << "\", \"calls\": " << e.calls << ", \"nanoseconds\": " << e.nanoseconds << ", \"limbs\": " << e.limbs << ", \"count\": " << e.count << "}"
+           << (i + 1 < entries.size() ? "," : "") << "\n";
+    }
+    os << "  ]\n}\n";
+}
+inline void helper::profile_registry::report_at_exit() {
+    const char *path = std::getenv("GMPXX_MKII_PROFILE");
+    if (!path || !*path) {
+        profile_report(std::cerr);
+        return;
+    }
+    std::ofstream out(path);
+    std::string name(path);
+    if (name.size() >= 5 && name.compare(name.size() - 5, 5, ".json") == 0)
+        profile_json(out);
+    else
+        profile_report(out);
+}
+#else
+#define GMPXX_MKII_PROFILE(name, limbs)
+#define GMPXX_MKII_PROFILE_COUNT(name, n)
+#endif
 class mpf_class_initializer {
   public:
     mpf_class_initializer() {
@@ -115,6 +465,9 @@ class mpf_class_initializer {
                 std::exit(EXIT_FAILURE);
             }
         }
+#if defined ___GMPXX_MKII_STATS___
+        helper::stats_hooks::install();
+#endif
         mpf_set_default_prec(prec);
         gmpxx_defaults::base = 10;
     }
@@ -154,8 +507,7 @@ template <typename T> mpf_class caches<T>::log2_cached;
 
 namespace helper {
 // helper function for mpz_import from various integer types
-template <typename U, std::enable_if_t<std::is_integral_v<U>, int> = 0> void mpz_init_import(mpz_t &value, const U &op) {
-    mpz_init(value);
+template <typename U, std::enable_if_t<std::is_integral_v<U>, int> = 0> void mpz_set_import(mpz_t &value, const U &op) {
     if constexpr (std::is_signed_v<U>) {
         using UnsignedT = std::make_unsigned_t<U>;
         UnsignedT absOp = static_cast<UnsignedT>(op < 0 ? -op : op);
@@ -164,7 +516,7 @@ template <typename U, std::enable_if_t<std::is_integral_v<U>, int> = 0> void mpz
 #elif defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
         mpz_import(value, 1, 1, sizeof(U), 0, 0, &absOp);
 #else
-        static_assert(false, "mpz_init_import: Unsupported endianness");
+        static_assert(false, "mpz_set_import: Unsupported endianness");
 #endif
         if (op < 0) {
             mpz_neg(value, value);
@@ -175,10 +527,241 @@ template <typename U, std::enable_if_t<std::is_integral_v<U>, int> = 0> void mpz
 #elif defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
         mpz_import(value, 1, 1, sizeof(U), 0, 0, &op);
 #else
-        static_assert(false, "mpz_init_import: Unsupported endianness");
+        static_assert(false, "mpz_set_import: Unsupported endianness");
+#endif
+    }
+}
+#if defined ___GMPXX_MKII_MPZ_SMALL___
+// small value mode (-D___GMPXX_MKII_MPZ_SMALL___): every mpz_class owns one limb right after its mpz_t and starts
+// with _mp_alloc == 1 and _mp_d pointing to it, so values that fit in a limb never touch the heap.
+// GMP grows and frees limbs through its memory functions, which are wrapped once: a one limb block preceded by
+// its own address (the _mp_d of its mpz_class, or a dedicated pointer in mpq_class) is copied instead of
+// reallocated and is never freed.
+// No block from an allocator is preceded by its own address.
+// Two constraints follow for code in this mode:
+// - mp_set_memory_functions must not be called once an mpz_class exists, unless the new functions forward to the
+//   ones they replace as the stats and arena wrappers do; otherwise GMP hands the inline limbs to the new free.
+// - mpz_class and mpq_class values are swapped with swap() or std::swap, never with mpz_swap or mpq_swap on
+//   get_mpz_t() or get_mpq_t(), which would leave each object pointing into the inline limb of the other.
+class mpz_small_hooks {
+  public:
+    static void install() {
+        static mpz_small_hooks hooks;
+        (void)hooks;
+    }
+
+  private:
+    static inline void *(*original_alloc)(std::size_t);
+    static inline void *(*original_realloc)(void *, std::size_t, std::size_t);
+    static inline void (*original_free)(void *, std::size_t);
+    mpz_small_hooks() {
+        mp_get_memory_functions(&original_alloc, &original_realloc, &original_free);
+        mp_set_memory_functions(original_alloc, small_realloc, small_free);
+    }
+#if defined __GNUC__
+    __attribute__((no_sanitize_address))
+#endif
+    static bool is_inline(void *p, std::size_t size) {
+        return size == sizeof(mp_limb_t) && *(reinterpret_cast<void *const *>(p) - 1) == p;
+    }
+    static void *small_realloc(void *p, std::size_t old_size, std::size_t new_size) {
+        if (!is_inline(p, old_size))
+            return original_realloc(p, old_size, new_size);
+        void *q = original_alloc(new_size);
+        std::memcpy(q, p, std::min(old_size, new_size));
+        return q;
+    }
+    static void small_free(void *p, std::size_t size) {
+        if (!is_inline(p, size))
+            original_free(p, size);
+    }
+};
+#endif
+#if defined ___GMPXX_MKII_MPQ_SMALL___
+// binary gcd; gcd(0, b) == b
+inline uint64_t gcd_u64(uint64_t a, uint64_t b) {
+    if (a == 0)
+        return b;
+    if (b == 0)
+        return a;
+    int shift = __builtin_ctzll(a | b);
+    a >>= __builtin_ctzll(a);
+    do {
+        b >>= __builtin_ctzll(b);
+        if (a > b)
+            std::swap(a, b);
+        b -= a;
+    } while (b != 0);
+    return a << shift;
+}
 #endif
+// a double as an mpf on the stack, for mixed mpf_class/double arithmetic without a heap temporary.
+// mpf_set_d stores the value exactly in LIMBS_PER_DOUBLE limbs (two 64 bit, or three 32 bit limbs) whatever _mp_prec is.
+class mpf_double {
+  public:
+    explicit mpf_double(double d) {
+        value->_mp_prec = 2;
+        value->_mp_size = 0;
+        value->_mp_exp = 0;
+        value->_mp_d = limbs;
+        mpf_set_d(value, d);
     }
+    mpf_srcptr get_mpf_t() const { return value; }
+
+  private:
+    mp_limb_t limbs[3];
+    mpf_t value;
+};
+// exact comparison of an mpf and an mpq, the sign first
+inline int mpf_cmp_q(mpf_srcptr op1, mpq_srcptr op2) {
+    int sign1 = mpf_sgn(op1), sign2 = mpq_sgn(op2);
+    if (sign1 != sign2 || sign1 == 0)
+        return (sign1 > sign2) - (sign1 < sign2);
+    mpq_t q;
+    mpq_init(q);
+    mpq_set_f(q, op1);
+    int result = mpq_cmp(q, op2);
+    mpq_clear(q);
+    return result;
 }
+// a NUL terminated character buffer that lives on the stack for usual sizes; used for operator>> tokens
+// and std::format output
+class char_buffer {
+  public:
+    char_buffer() { buf[0] = '\0'; }
+    void push_back(char ch) {
+        if (spill.empty() && len + 1 < sizeof(buf)) {
+            buf[len++] = ch;
+            buf[len] = '\0';
+            return;
+        }
+        if (spill.empty())
+            spill.assign(buf, len);
+        spill += ch;
+        len++;
+    }
+    void append(const char *str, std::size_t n) {
+        for (std::size_t i = 0; i < n; i++)
+            push_back(str[i]);
+    }
+    void append(std::size_t n, char ch) {
+        for (std::size_t i = 0; i < n; i++)
+            push_back(ch);
+    }
+    void truncate(std::size_t n) {
+        if (n >= len)
+            return;
+        len = n;
+        if (spill.empty())
+            buf[len] = '\0';
+        else
+            spill.resize(len);
+    }
+    // n chars, the new ones unspecified, for writers such as mpz_get_str that fill data() directly
+    void resize(std::size_t n) {
+        if (spill.empty() && n < sizeof(buf)) {
+            len = n;
+            buf[len] = '\0';
+            return;
+        }
+        if (spill.empty())
+            spill.assign(buf, len);
+        spill.resize(n);
+        len = n;
+    }
+    char *data() { return spill.empty() ? buf : &spill[0]; }
+    const char *c_str() const { return spill.empty() ? buf : spill.c_str(); }
+    std::size_t size() const { return len; }
+    char operator[](std::size_t i) const { return c_str()[i]; }
+    char &operator[](std::size_t i) { return data()[i]; }
+
+  private:
+    char buf[256];
+    std::size_t len = 0;
+    std::string spill;
+};
+// operator>> support: a single pass scanner that peeks and consumes directly on the streambuf,
+// so no unget()/putback() is needed; tokens are collected in a char_buffer.
+// The grammar and the fail/eof semantics follow the original gmpxx (cxx/ismpz.cc, ismpq.cc, ismpf.cc).
+class istream_scanner {
+  public:
+    using traits_type = std::istream::traits_type;
+    explicit istream_scanner(std::istream &stream) : sb(stream.rdbuf()), ctype(std::use_facet<std::ctype<char>>(stream.getloc())) { ch = sb->sgetc(); }
+    bool eof() const { return traits_type::eq_int_type(ch, traits_type::eof()); }
+    char peek() const { return eof() ? '\0' : traits_type::to_char_type(ch); }
+    void next() {
+        if (!eof())
+            ch = sb->snextc();
+    }
+    bool is_space() const { return !eof() && ctype.is(std::ctype_base::space, peek()); }
+    bool is_digit(int base) const {
+        char c = peek();
+        if (base == 16)
+            return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+        return c >= '0' && c < '0' + (base == 8 ? 8 : 10);
+    }
+    void skip_leading_space(std::ios_base::fmtflags flags) {
+        if (flags & std::ios::skipws)
+            while (is_space())
+                next();
+    }
+    void read_sign(char_buffer &number) {
+        char c = peek();
+        if (c == '-' || c == '+') {
+            if (c == '-')
+                number.push_back('-');
+            next();
+        }
+    }
+    // basefield selects the base; if it is empty a leading "0" means octal and "0x" hexadecimal
+    int read_base(std::ios_base::fmtflags flags, bool &zero) {
+        zero = false;
+        switch (flags & std::ios::basefield) {
+        case std::ios::dec:
+            return 10;
+        case std::ios::hex:
+            return 16;
+        case std::ios::oct:
+            return 8;
+        default:
+            break;
+        }
+        if (peek() != '0')
+            return 10;
+        next();
+        if (peek() == 'x' || peek() == 'X') {
+            next();
+            return 16;
+        }
+        zero = true; // if no other digit is read, the "0" counts
+        return 8;
+    }
+    void read_digits(char_buffer &number, bool &ok, int base) {
+        while (is_digit(base)) {
+            ok = true;
+            number.push_back(peek());
+            next();
+        }
+    }
+    // [+-] [0|0x] digits; op is left untouched and false is returned when no digit is read
+    bool read_integer(std::ios_base::fmtflags flags, mpz_ptr op) {
+        char_buffer number;
+        bool ok = false, zero;
+        read_sign(number);
+        int base = read_base(flags, zero);
+        read_digits(number, ok, base);
+        if (ok)
+            mpz_set_str(op, number.c_str(), base);
+        else if (zero)
+            mpz_set_ui(op, 0UL);
+        return ok || zero;
+    }
+
+  private:
+    std::streambuf *sb;
+    const std::ctype<char> &ctype;
+    traits_type::int_type ch;
+};
 } // namespace helper
 class mpz_class {
   public:
@@ -187,11 +770,11 @@ class mpz_class {
     // cf. https://gmplib.org/manual/C_002b_002b-Interface-Integers
     ////////////////////////////////////////////////////////////////////////////////////////
     // constructors and destructors
-    mpz_class() { mpz_init(value); }
+    mpz_class() { init(); }
     // The rule of 0/3/5
     // The rule 1 of 5 copy constructor
     mpz_class(const mpz_class &op) {
-        mpz_init(value);
+        init();
         mpz_set(value, op.value);
     }
     // The rule 2 of 5 copy assignment operator
@@ -202,69 +785,87 @@ class mpz_class {
         return *this;
     }
     // The rule 3 of 5 default deconstructor
-    ~mpz_class() { mpz_clear(value); }
+    // limbs borrowed through mpz_roinit_n (mpz_view) have no allocation to free
+#if defined ___GMPXX_MKII_MPZ_SMALL___
+    ~mpz_class() {
+        if (value->_mp_d != &small && value->_mp_alloc != 0)
+            mpz_clear(value);
+    }
+#else
+    ~mpz_class() {
+        if (value->_mp_alloc != 0)
+            mpz_clear(value);
+    }
+#endif
     // The rule 4 of 5 move constructor
     mpz_class(mpz_class &&op) noexcept {
-        mpz_init(value);
-        mpz_swap(value, op.value);
+        init();
+        swap_value(op);
     }
     // The rule 5 of 5 move assignment operator
     mpz_class &operator=(mpz_class &&op) noexcept {
         if (this != &op) {
-            mpz_swap(value, op.value);
+            swap_value(op);
         }
         return *this;
     }
     // constructors
     explicit mpz_class(const mpz_t z) {
-        mpz_init(value);
+        init();
         mpz_set(value, z);
     }
     mpz_class(const mpq_t op) {
-        mpz_init(value);
+        init();
         mpz_set_q(value, op);
     }
     mpz_class(const mpf_t op) {
-        mpz_init(value);
+        init();
         mpz_set_f(value, op);
     }
+    // from the other view type, which would otherwise need two user-defined conversions; explicit, as an implicit
+    // one would make every function overloaded on mpz_class and mpf_class, sgn(view) say, ambiguous
+    explicit mpz_class(const mpf_view &op);
     mpz_class(const char *str, int base = 0) {
-        mpz_init(value);
+        init();
         if (mpz_set_str(value, str, base) != 0) {
             throw std::invalid_argument("");
         }
     }
     mpz_class(const std::string &str, int base = 0) {
-        mpz_init(value);
+        init();
         if (mpz_set_str(value, str.c_str(), base) != 0) {
             throw std::invalid_argument("");
         }
     }
     // constructor for various integer types
     template <typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0> mpz_class(T op) {
+        init();
         if constexpr (std::is_same_v<T, int64_t>) {
             if constexpr (___gmpxx_mkII___long_is_same_as_int64_v || ___gmpxx_mkII___long_is_greater_than_int64_v) {
-                mpz_init_set_si(value, static_cast<long int>(op));
+                mpz_set_si(value, static_cast<long int>(op));
             } else {
-                helper::mpz_init_import(value, op);
+                helper::mpz_set_import(value, op);
             }
         } else if constexpr (std::is_same_v<T, uint64_t>) {
             if constexpr (___gmpxx_mkII___ulong_is_same_as_uint64_v || ___gmpxx_mkII___ulong_is_greater_than_uint64_v) {
-                mpz_init_set_ui(value, static_cast<unsigned long int>(op));
+                mpz_set_ui(value, static_cast<unsigned long int>(op));
             } else {
-                helper::mpz_init_import(value, op);
+                helper::mpz_set_import(value, op);
             }
         } else if constexpr (std::is_signed_v<T> && ___gmpxx_mkII__smaller_or_equal_than_long<T>::value) {
-            mpz_init_set_si(value, static_cast<long int>(op));
+            mpz_set_si(value, static_cast<long int>(op));
         } else if constexpr (!std::is_signed_v<T> && ___gmpxx_mkII__smaller_or_equal_than_long<T>::value) {
-            mpz_init_set_ui(value, static_cast<unsigned long int>(op));
+            mpz_set_ui(value, static_cast<unsigned long int>(op));
         }
         // For larger types, use mpz_import
         else {
-            helper::mpz_init_import(value, op);
+            helper::mpz_set_import(value, op);
         }
     }
-    mpz_class(double op) { mpz_init_set_d(value, op); }
+    mpz_class(double op) {
+        init();
+        mpz_set_d(value, op);
+    }
 
     // assignments from other objects
     // assignments from various integers
@@ -355,22 +956,48 @@ class mpz_class {
 
     // mpz_class arithmetic operators
     inline friend mpz_class &operator+=(mpz_class &lhs, const mpz_class &rhs) {
+#if defined ___GMPXX_MKII_MPZ_SMALL___
+        int64_t a, b, r;
+        if (lhs.get_small(a) && rhs.get_small(b) && !__builtin_add_overflow(a, b, &r) && lhs.set_small(r))
+            return lhs;
+#endif
         mpz_add(lhs.value, lhs.value, rhs.value);
         return lhs;
     }
     inline friend mpz_class &operator-=(mpz_class &lhs, const mpz_class &rhs) {
+#if defined ___GMPXX_MKII_MPZ_SMALL___
+        int64_t a, b, r;
+        if (lhs.get_small(a) && rhs.get_small(b) && !__builtin_sub_overflow(a, b, &r) && lhs.set_small(r))
+            return lhs;
+#endif
         mpz_sub(lhs.value, lhs.value, rhs.value);
         return lhs;
     }
     inline friend mpz_class &operator*=(mpz_class &lhs, const mpz_class &rhs) {
+#if defined ___GMPXX_MKII_MPZ_SMALL___
+        int64_t a, b, r;
+        if (lhs.get_small(a) && rhs.get_small(b) && !__builtin_mul_overflow(a, b, &r) && lhs.set_small(r))
+            return lhs;
+#endif
         mpz_mul(lhs.value, lhs.value, rhs.value);
         return lhs;
     }
     inline friend mpz_class &operator/=(mpz_class &lhs, const mpz_class &rhs) {
+#if defined ___GMPXX_MKII_MPZ_SMALL___
+        // |a| < 2^63, so a / b cannot overflow; division by zero is left to GMP
+        int64_t a, b;
+        if (lhs.get_small(a) && rhs.get_small(b) && b != 0 && lhs.set_small(a / b))
+            return lhs;
+#endif
         mpz_tdiv_q(lhs.value, lhs.value, rhs.value);
         return lhs;
     }
     inline friend mpz_class &operator%=(mpz_class &lhs, const mpz_class &rhs) {
+#if defined ___GMPXX_MKII_MPZ_SMALL___
+        int64_t a, b;
+        if (lhs.get_small(a) && rhs.get_small(b) && b != 0 && lhs.set_small(a % b))
+            return lhs;
+#endif
         mpz_tdiv_r(lhs.value, lhs.value, rhs.value);
         return lhs;
     }
@@ -433,12 +1060,12 @@ class mpz_class {
         return result;
     }
     // mpz_class comparison operators
-    inline friend bool operator==(const mpz_class &op1, const mpz_class &op2) { return mpz_cmp(op1.value, op2.value) == 0; }
-    inline friend bool operator!=(const mpz_class &op1, const mpz_class &op2) { return mpz_cmp(op1.value, op2.value) != 0; }
-    inline friend bool operator<(const mpz_class &op1, const mpz_class &op2) { return mpz_cmp(op1.value, op2.value) < 0; }
-    inline friend bool operator>(const mpz_class &op1, const mpz_class &op2) { return mpz_cmp(op1.value, op2.value) > 0; }
-    inline friend bool operator<=(const mpz_class &op1, const mpz_class &op2) { return mpz_cmp(op1.value, op2.value) <= 0; }
-    inline friend bool operator>=(const mpz_class &op1, const mpz_class &op2) { return mpz_cmp(op1.value, op2.value) >= 0; }
+    inline friend bool operator==(const mpz_class &op1, const mpz_class &op2) { return op1.compare(op2) == 0; }
+    inline friend bool operator!=(const mpz_class &op1, const mpz_class &op2) { return op1.compare(op2) != 0; }
+    inline friend bool operator<(const mpz_class &op1, const mpz_class &op2) { return op1.compare(op2) < 0; }
+    inline friend bool operator>(const mpz_class &op1, const mpz_class &op2) { return op1.compare(op2) > 0; }
+    inline friend bool operator<=(const mpz_class &op1, const mpz_class &op2) { return op1.compare(op2) <= 0; }
+    inline friend bool operator>=(const mpz_class &op1, const mpz_class &op2) { return op1.compare(op2) >= 0; }
 
     inline friend bool operator==(const mpz_class &op1, const double &op2) { return mpz_cmp_d(op1.value, op2) == 0; }
     inline friend bool operator!=(const mpz_class &op1, const double &op2) { return mpz_cmp_d(op1.value, op2) != 0; }
@@ -733,9 +1360,9 @@ class mpz_class {
 
     // void mpz_class::swap (mpz_class& op)
     // void swap (mpz_class& op1, mpz_class& op2)
-    void swap(mpz_class &op) { mpz_swap(this->value, op.value); }
+    void swap(mpz_class &op) { swap_value(op); }
 #if !defined ___GMPXX_STRICT_COMPATIBILITY___
-    friend void swap(mpz_class &op1, mpz_class &op2) { mpz_swap(op1.value, op2.value); }
+    friend void swap(mpz_class &op1, mpz_class &op2) { op1.swap_value(op2); }
 #endif
     friend std::ostream &operator<<(std::ostream &os, const mpz_class &op);
     friend std::ostream &operator<<(std::ostream &os, const mpz_t op);
@@ -752,10 +1379,68 @@ class mpz_class {
     operator signed int() const { return static_cast<signed int>(mpz_get_si(this->value)); }
 
     mpz_srcptr get_mpz_t() const { return value; }
+    // in small value mode, swap through swap() rather than mpz_swap, which would leave a pointer to the other object
     mpz_ptr get_mpz_t() { return value; }
 
+  private:
+    friend class mpz_view;
+    struct roinit_tag {};
+    // read-only view of n limbs, the sign of n being the sign of the value (see mpz_view)
+    mpz_class(roinit_tag, const mp_limb_t *d, mp_size_t n) noexcept { mpz_roinit_n(value, d, n); }
+
   private:
     mpz_t value;
+#if defined ___GMPXX_MKII_MPZ_SMALL___
+    mp_limb_t small;
+    void init() {
+        // the hooks recognise the inline limb by the pointer stored right in front of it
+        static_assert(offsetof(__mpz_struct, _mp_d) + sizeof(mp_limb_t *) == sizeof(__mpz_struct));
+        static_assert(offsetof(mpz_class, small) == offsetof(mpz_class, value) + sizeof(__mpz_struct));
+        helper::mpz_small_hooks::install();
+        value->_mp_alloc = 1;
+        value->_mp_size = 0;
+        value->_mp_d = &small;
+    }
+    void swap_value(mpz_class &op) noexcept {
+        mpz_swap(value, op.value);
+        std::swap(small, op.small);
+        if (value->_mp_d == &op.small)
+            value->_mp_d = &small;
+        if (op.value->_mp_d == &small)
+            op.value->_mp_d = &op.small;
+    }
+    // the value as int64_t if it has at most one limb and |value| < 2^63
+    bool get_small(int64_t &v) const {
+        mp_size_t n = value->_mp_size;
+        if (n == 0) {
+            v = 0;
+            return true;
+        }
+        if (n > 1 || n < -1 || value->_mp_d[0] > static_cast<mp_limb_t>(std::numeric_limits<int64_t>::max()))
+            return false;
+        v = (n > 0) ? static_cast<int64_t>(value->_mp_d[0]) : -static_cast<int64_t>(value->_mp_d[0]);
+        return true;
+    }
+    // stores v in the limb the object already has (there is always at least one); false if v needs more
+    bool set_small(int64_t v) {
+        uint64_t magnitude = (v < 0) ? -static_cast<uint64_t>(v) : static_cast<uint64_t>(v);
+        if (magnitude > GMP_NUMB_MAX)
+            return false;
+        value->_mp_d[0] = static_cast<mp_limb_t>(magnitude);
+        value->_mp_size = (v > 0) ? 1 : (v < 0) ? -1 : 0;
+        return true;
+    }
+    int compare(const mpz_class &op) const {
+        int64_t a, b;
+        if (get_small(a) && op.get_small(b))
+            return (a > b) - (a < b);
+        return mpz_cmp(value, op.value);
+    }
+#else
+    void init() { mpz_init(value); }
+    void swap_value(mpz_class &op) noexcept { mpz_swap(value, op.value); }
+    int compare(const mpz_class &op) const { return mpz_cmp(value, op.value); }
+#endif
 };
 // +
 template <typename T> inline UNSIGNED_INT_COND(T, mpz_class) operator+(const mpz_class &op1, const T op2) {
@@ -1287,116 +1972,19 @@ inline std::ostream &operator<<(std::ostream &os, const mpz_t &op) {
     print_mpz(os, op);
     return os;
 }
-inline std::istream &read_nofmtflags_mpz_from_stream(std::istream &stream, mpz_t op) {
-    char ch;
-    std::string number;
-    bool negative = false;
-    bool is_space = false;
-    int base = 10;
-
-    std::ios_base::fmtflags current_flags = stream.flags();
-    int counter = 0;
-    while (stream >> ch && isspace(ch)) {
-        is_space = true;
-        counter++;
-    }
-    if (!(current_flags & std::ios::skipws) && is_space == true) {
-        for (int i = 0; i <= counter; i++)
-            stream.unget();
-        stream.setstate(std::ios::failbit);
-        return stream;
-    }
-    if (ch == '+' || ch == '-') {
-        negative = (ch == '-');
-        stream.get(ch);
-    }
-    if (ch == '0') {
-        stream.get(ch);
-        if (ch == 'x' || ch == 'X') {
-            base = 16;
-            stream.get(ch);
-        } else if (isdigit(ch) && ch != '8' && ch != '9') {
-            base = 8;
-        } else {
-            // retake zero again
-            stream.unget();
-            stream.unget();
-            stream.get(ch);
-        }
-    }
-    while (isdigit(ch) || (base == 16 && isxdigit(ch))) {
-        number += ch;
-        if (!stream.get(ch))
-            break;
-    }
-    if (!stream.eof())
-        stream.unget();
-    int ret = mpz_set_str(op, number.c_str(), base);
-    if (ret != 0) {
-        stream.setstate(stream.rdstate() & ~std::ios::goodbit);
-        stream.setstate(std::ios::failbit);
-    } else {
-        stream.clear(stream.rdstate() & ~std::ios::failbit);
-        stream.setstate(std::ios::goodbit);
-    }
-    if (negative) {
-        mpz_neg(op, op);
-    }
-    return stream;
-}
-inline std::istream &read_base_mpz_from_stream(std::istream &stream, mpz_t op, int base = 10) {
-    char ch;
-    std::string number;
-    bool negative = false;
-    bool number_started = false;
-    while (stream >> ch && isspace(ch))
-        ;
-    if (!stream) {
-        stream.setstate(std::ios::failbit);
+inline std::istream &read_mpz_from_stream(std::istream &stream, mpz_t op) {
+    std::istream::sentry sentry(stream, true);
+    if (!sentry)
         return stream;
-    }
-    if (ch == '+' || ch == '-') {
-        negative = (ch == '-');
-        stream.get(ch);
-    }
-    while ((base <= 10 && isdigit(ch) && ch < '0' + base) || (base == 16 && isxdigit(ch))) {
-        if (base == 16 && isalpha(ch)) {
-            ch = tolower(ch);
-        }
-        number += ch;
-        number_started = true;
-        if (!stream.get(ch))
-            break;
-    }
-    if (number_started && (ch < '0' || (ch > '9' && base <= 10) || (ch > 'f' && base == 16))) {
-        stream.unget();
-    }
-    if (negative && !number.empty())
-        number = "-" + number;
-    if (number.empty()) {
-        stream.setstate(std::ios::failbit);
-    }
-    int ret = mpz_set_str(op, number.c_str(), base);
-    if (ret != 0) {
+    helper::istream_scanner in(stream);
+    in.skip_leading_space(stream.flags());
+    bool ok = in.read_integer(stream.flags(), op);
+    if (in.eof())
+        stream.setstate(std::ios::eofbit);
+    if (!ok)
         stream.setstate(std::ios::failbit);
-    } else {
-        stream.clear(stream.rdstate() & ~std::ios::failbit);
-        stream.setstate(std::ios::goodbit);
-    }
     return stream;
 }
-inline std::istream &read_mpz_from_stream(std::istream &stream, mpz_t op) {
-    std::ios_base::fmtflags current_flags = stream.flags();
-    if (current_flags == std::ios_base::fmtflags(0)) {
-        return read_nofmtflags_mpz_from_stream(stream, op);
-    }
-    if (current_flags & std::ios::oct) {
-        return read_base_mpz_from_stream(stream, op, 8);
-    } else if (current_flags & std::ios::hex) {
-        return read_base_mpz_from_stream(stream, op, 16);
-    }
-    return read_base_mpz_from_stream(stream, op);
-}
 inline std::istream &operator>>(std::istream &stream, mpz_t op) { return read_mpz_from_stream(stream, op); }
 inline std::istream &operator>>(std::istream &stream, mpz_class &op) { return read_mpz_from_stream(stream, op.get_mpz_t()); }
 class mpq_class {
@@ -1406,11 +1994,11 @@ class mpq_class {
     // cf. https://gmplib.org/manual/C_002b_002b-Interface-Rationals
     ////////////////////////////////////////////////////////////////////////////////////////
     // constructors and destructors
-    mpq_class() { mpq_init(value); }
+    mpq_class() { init(); }
     // The rule of 0/3/5
     // The rule 1 of 5 copy constructor
     mpq_class(const mpq_class &op) {
-        mpq_init(value);
+        init();
         mpq_set(value, op.value);
     }
     // The rule 2 of 5 copy assignment operator
@@ -1421,34 +2009,42 @@ class mpq_class {
         return *this;
     }
     // The rule 3 of 5 default deconstructor
+#if defined ___GMPXX_MKII_MPQ_SMALL___
+    ~mpq_class() {
+        if (mpq_numref(value)->_mp_d != &num_small || mpq_denref(value)->_mp_d != &den_small)
+            mpq_clear(value);
+    }
+#else
     ~mpq_class() { mpq_clear(value); }
+#endif
     // The rule 4 of 5 move constructor
     mpq_class(mpq_class &&op) noexcept {
-        mpq_init(value);
-        mpq_swap(value, op.value);
+        init();
+        swap_value(op);
     }
     // The rule 5 of 5 move assignment operator
     mpq_class &operator=(mpq_class &&op) noexcept {
         if (this != &op) {
-            mpq_swap(value, op.value);
+            swap_value(op);
         }
         return *this;
     }
     // constructors
     explicit mpq_class(const mpq_t q) {
-        mpq_init(value);
+        init();
         mpq_set(value, q);
     }
     mpq_class(const mpz_t op) {
-        mpq_init(value);
+        init();
         mpq_set_z(value, op);
     }
     mpq_class(const mpf_t op) {
-        mpq_init(value);
+        init();
         mpq_set_f(value, op);
     }
+    explicit mpq_class(const mpf_view &op);
     mpq_class(const mpz_class &op1, const mpz_class &op2) {
-        mpq_init(value);
+        init();
         mpq_set_num(value, op1.get_mpz_t());
         mpq_set_den(value, op2.get_mpz_t());
         if (op2 == 0) {
@@ -1458,23 +2054,23 @@ class mpq_class {
         mpq_canonicalize(value);
     }
     mpq_class(const mpz_class &op) {
-        mpq_init(value);
+        init();
         mpq_set_z(value, op.get_mpz_t());
     }
     mpq_class(const char *str, int base = 0) {
-        mpq_init(value);
+        init();
         if (mpq_set_str(value, str, base) != 0) {
             throw std::invalid_argument("");
         }
     }
     mpq_class(const std::string &str, int base = 0) {
-        mpq_init(value);
+        init();
         if (mpq_set_str(value, str.c_str(), base) != 0) {
             throw std::invalid_argument("");
         }
     }
     mpq_class(int64_t op1, int64_t op2) {
-        mpq_init(this->value);
+        init();
         if constexpr (___gmpxx_mkII___long_is_same_as_int64_v) {
             mpq_set_si(this->value, op1, op2);
         } else {
@@ -1497,7 +2093,7 @@ class mpq_class {
         }
     }
     mpq_class(uint64_t op1, uint64_t op2) {
-        mpq_init(this->value);
+        init();
         if constexpr (___gmpxx_mkII___ulong_is_same_as_uint64_v) {
             mpq_set_ui(this->value, op1, op2);
         } else {
@@ -1520,7 +2116,7 @@ class mpq_class {
         }
     }
     mpq_class(int32_t op1, int32_t op2) {
-        mpq_init(this->value);
+        init();
         if constexpr (___gmpxx_mkII___long_is_same_as_int32_v) {
             mpq_set_si(this->value, op1, op2);
         } else if constexpr (___gmpxx_mkII___long_is_greater_than_int32_v) {
@@ -1530,7 +2126,7 @@ class mpq_class {
         }
     }
     mpq_class(uint32_t op1, uint32_t op2) {
-        mpq_init(this->value);
+        init();
         if constexpr (___gmpxx_mkII___ulong_is_same_as_uint32_v) {
             mpq_set_ui(this->value, op1, op2);
         } else if constexpr (___gmpxx_mkII___ulong_is_greater_than_uint32_v) {
@@ -1540,7 +2136,7 @@ class mpq_class {
         }
     }
     mpq_class(int64_t op) {
-        mpq_init(this->value);
+        init();
         if constexpr (___gmpxx_mkII___long_is_same_as_int64_v) {
             mpq_set_si(this->value, op, 1);
         } else {
@@ -1561,7 +2157,7 @@ class mpq_class {
         }
     }
     mpq_class(uint64_t op) {
-        mpq_init(this->value);
+        init();
         if constexpr (___gmpxx_mkII___ulong_is_same_as_uint64_v) {
             mpq_set_ui(this->value, op, 1);
         } else {
@@ -1582,15 +2178,15 @@ class mpq_class {
         }
     }
     mpq_class(unsigned int op) {
-        mpq_init(value);
+        init();
         mpq_set_ui(value, static_cast<unsigned long int>(op), static_cast<unsigned long int>(1));
     }
     mpq_class(int op) {
-        mpq_init(value);
+        init();
         mpq_set_si(value, static_cast<signed long int>(op), static_cast<signed long int>(1));
     }
     mpq_class(double op) {
-        mpq_init(value);
+        init();
         mpq_set_d(value, op);
     }
 
@@ -1662,12 +2258,12 @@ class mpq_class {
     inline friend mpq_class operator/(const mpq_class &op1, const mpq_class &op2);
 
     // mpq_class comparison operators
-    inline friend bool operator==(const mpq_class &op1, const mpq_class &op2) { return mpq_cmp(op1.value, op2.value) == 0; }
-    inline friend bool operator!=(const mpq_class &op1, const mpq_class &op2) { return mpq_cmp(op1.value, op2.value) != 0; }
-    inline friend bool operator<(const mpq_class &op1, const mpq_class &op2) { return mpq_cmp(op1.value, op2.value) < 0; }
-    inline friend bool operator>(const mpq_class &op1, const mpq_class &op2) { return mpq_cmp(op1.value, op2.value) > 0; }
-    inline friend bool operator<=(const mpq_class &op1, const mpq_class &op2) { return mpq_cmp(op1.value, op2.value) <= 0; }
-    inline friend bool operator>=(const mpq_class &op1, const mpq_class &op2) { return mpq_cmp(op1.value, op2.value) >= 0; }
+    inline friend bool operator==(const mpq_class &op1, const mpq_class &op2) { return op1.compare(op2) == 0; }
+    inline friend bool operator!=(const mpq_class &op1, const mpq_class &op2) { return op1.compare(op2) != 0; }
+    inline friend bool operator<(const mpq_class &op1, const mpq_class &op2) { return op1.compare(op2) < 0; }
+    inline friend bool operator>(const mpq_class &op1, const mpq_class &op2) { return op1.compare(op2) > 0; }
+    inline friend bool operator<=(const mpq_class &op1, const mpq_class &op2) { return op1.compare(op2) <= 0; }
+    inline friend bool operator>=(const mpq_class &op1, const mpq_class &op2) { return op1.compare(op2) >= 0; }
 
     inline friend bool operator==(const mpq_class &op1, const mpz_class &op2) { return mpq_cmp_z(op1.value, op2.get_mpz_t()) == 0; }
     inline friend bool operator!=(const mpq_class &op1, const mpz_class &op2) { return mpq_cmp_z(op1.value, op2.get_mpz_t()) != 0; }
@@ -1778,10 +2374,10 @@ class mpq_class {
     // int sgn (mpq_class op)
     // void mpq_class::swap (mpq_class& op)
     // void swap (mpq_class& op1, mpq_class& op2)
-    void swap(mpq_class &op) { mpq_swap(this->value, op.value); }
+    void swap(mpq_class &op) { swap_value(op); }
     friend int sgn(const mpq_class &op) { return mpq_sgn(op.value); }
 #if !defined ___GMPXX_STRICT_COMPATIBILITY___
-    friend void swap(mpq_class &op1, mpq_class &op2) { mpq_swap(op1.value, op2.value); }
+    friend void swap(mpq_class &op1, mpq_class &op2) { op1.swap_value(op2); }
 #endif
 
     // mpz_class& mpq_class::get_num ()
@@ -1811,10 +2407,128 @@ class mpq_class {
     operator mpf_class() const;
     operator mpz_class() const;
     mpq_srcptr get_mpq_t() const { return value; }
+    // in small value mode, swap through swap() rather than mpq_swap, which would leave pointers to the other object
     mpq_ptr get_mpq_t() { return value; }
 
   private:
     mpq_t value;
+#if defined ___GMPXX_MKII_MPQ_SMALL___
+    // each inline limb is preceded by a pointer to itself, which is how helper::mpz_small_hooks recognises it.
+    // Unlike mpz_class, _mp_d cannot serve as that pointer: mpq_inv and mpq_div exchange the two _mp_d.
+    mp_limb_t *num_self;
+    mp_limb_t num_small;
+    mp_limb_t *den_self;
+    mp_limb_t den_small;
+    void init() {
+        static_assert(offsetof(mpq_class, num_small) == offsetof(mpq_class, num_self) + sizeof(mp_limb_t *));
+        static_assert(offsetof(mpq_class, den_small) == offsetof(mpq_class, den_self) + sizeof(mp_limb_t *));
+        helper::mpz_small_hooks::install();
+        num_self = &num_small;
+        den_self = &den_small;
+        mpq_numref(value)->_mp_alloc = 1;
+        mpq_numref(value)->_mp_size = 0;
+        mpq_numref(value)->_mp_d = &num_small;
+        mpq_denref(value)->_mp_alloc = 1;
+        mpq_denref(value)->_mp_size = 1;
+        mpq_denref(value)->_mp_d = &den_small;
+        den_small = 1;
+    }
+    // pointers into op's inline limbs now belong to this object (mpq_inv may have exchanged them)
+    void take_inline(mpq_class &op) noexcept {
+        for (mpz_ptr z : {mpq_numref(value), mpq_denref(value)}) {
+            if (z->_mp_d == &op.num_small)
+                z->_mp_d = &num_small;
+            else if (z->_mp_d == &op.den_small)
+                z->_mp_d = &den_small;
+        }
+    }
+    void swap_value(mpq_class &op) noexcept {
+        mpq_swap(value, op.value);
+        std::swap(num_small, op.num_small);
+        std::swap(den_small, op.den_small);
+        take_inline(op);
+        op.take_inline(*this);
+    }
+    // num/den with |num| and den below 2^63, i.e. a limb each
+    bool get_small(int64_t &num, int64_t &den) const {
+        mpz_srcptr n = mpq_numref(value), d = mpq_denref(value);
+        constexpr mp_limb_t max = static_cast<mp_limb_t>(std::numeric_limits<int64_t>::max());
+        if (n->_mp_size > 1 || n->_mp_size < -1 || d->_mp_size != 1 || d->_mp_d[0] > max)
+            return false;
+        if (n->_mp_size == 0) {
+            num = 0;
+        } else {
+            if (n->_mp_d[0] > max)
+                return false;
+            num = (n->_mp_size > 0) ? static_cast<int64_t>(n->_mp_d[0]) : -static_cast<int64_t>(n->_mp_d[0]);
+        }
+        den = static_cast<int64_t>(d->_mp_d[0]);
+        return true;
+    }
+    // stores the canonical num/den (den > 0) in the limbs the object already has; false if either needs more
+    bool set_small(__int128 num, __int128 den) {
+        unsigned __int128 magnitude = (num < 0) ? -static_cast<unsigned __int128>(num) : static_cast<unsigned __int128>(num);
+        mpz_ptr n = mpq_numref(value), d = mpq_denref(value);
+        if (magnitude > GMP_NUMB_MAX || static_cast<unsigned __int128>(den) > GMP_NUMB_MAX || n->_mp_alloc < 1 || d->_mp_alloc < 1)
+            return false;
+        n->_mp_d[0] = static_cast<mp_limb_t>(magnitude);
+        n->_mp_size = (num > 0) ? 1 : (num < 0) ? -1 : 0;
+        d->_mp_d[0] = static_cast<mp_limb_t>(den);
+        d->_mp_size = 1;
+        return true;
+    }
+    // rop = op1 + sign * op2 as GMP does it: with g = gcd(b, d), a/b + c/d = (a*(d/g) + c*(b/g)) / (b/g * d),
+    // and only gcd(numerator, g) remains to be cancelled. All products fit in 127 bits.
+    static bool add_small(mpq_class &rop, const mpq_class &op1, const mpq_class &op2, int sign) {
+        int64_t a, b, c, d;
+        if (!op1.get_small(a, b) || !op2.get_small(c, d))
+            return false;
+        uint64_t g = helper::gcd_u64(static_cast<uint64_t>(b), static_cast<uint64_t>(d));
+        __int128 num = static_cast<__int128>(a) * (d / g) + static_cast<__int128>(sign * c) * (b / g);
+        __int128 den = static_cast<__int128>(b / g) * d;
+        if (g != 1) {
+            __int128 r = num % static_cast<__int128>(g);
+            uint64_t g2 = helper::gcd_u64(static_cast<uint64_t>(r < 0 ? -r : r), g);
+            num /= g2;
+            den /= g2;
+        }
+        if (num == 0)
+            den = 1;
+        return rop.set_small(num, den);
+    }
+    // a/b * c/d with the cross cancellations gcd(a, d) and gcd(c, b)
+    static bool mul_small(mpq_class &rop, const mpq_class &op1, const mpq_class &op2) {
+        int64_t a, b, c, d;
+        if (!op1.get_small(a, b) || !op2.get_small(c, d))
+            return false;
+        return mul_small(rop, a, b, c, d);
+    }
+    static bool div_small(mpq_class &rop, const mpq_class &op1, const mpq_class &op2) {
+        int64_t a, b, c, d;
+        if (!op1.get_small(a, b) || !op2.get_small(c, d) || c == 0)
+            return false;
+        return (c < 0) ? mul_small(rop, -a, b, d, -c) : mul_small(rop, a, b, d, c);
+    }
+    static bool mul_small(mpq_class &rop, int64_t a, int64_t b, int64_t c, int64_t d) {
+        if (a == 0 || c == 0)
+            return rop.set_small(0, 1);
+        int64_t g1 = static_cast<int64_t>(helper::gcd_u64(static_cast<uint64_t>(a < 0 ? -a : a), static_cast<uint64_t>(d)));
+        int64_t g2 = static_cast<int64_t>(helper::gcd_u64(static_cast<uint64_t>(c < 0 ? -c : c), static_cast<uint64_t>(b)));
+        return rop.set_small(static_cast<__int128>(a / g1) * (c / g2), static_cast<__int128>(b / g2) * (d / g1));
+    }
+    int compare(const mpq_class &op) const {
+        int64_t a, b, c, d;
+        if (get_small(a, b) && op.get_small(c, d)) {
+            __int128 lhs = static_cast<__int128>(a) * d, rhs = static_cast<__int128>(c) * b;
+            return (lhs > rhs) - (lhs < rhs);
+        }
+        return mpq_cmp(value, op.value);
+    }
+#else
+    void init() { mpq_init(value); }
+    void swap_value(mpq_class &op) noexcept { mpq_swap(value, op.value); }
+    int compare(const mpq_class &op) const { return mpq_cmp(value, op.value); }
+#endif
 };
 
 inline mpq_class &mpq_class::operator=(const mpz_class &op) {
@@ -1873,18 +2587,34 @@ inline mpq_class &mpq_class::operator=(const std::string &op) {
 }
 
 inline mpq_class &operator+=(mpq_class &op1, const mpq_class &op2) {
+#if defined ___GMPXX_MKII_MPQ_SMALL___
+    if (mpq_class::add_small(op1, op1, op2, 1))
+        return op1;
+#endif
     mpq_add(op1.value, op1.value, op2.value);
     return op1;
 }
 inline mpq_class &operator-=(mpq_class &op1, const mpq_class &op2) {
+#if defined ___GMPXX_MKII_MPQ_SMALL___
+    if (mpq_class::add_small(op1, op1, op2, -1))
+        return op1;
+#endif
     mpq_sub(op1.value, op1.value, op2.value);
     return op1;
 }
 inline mpq_class &operator/=(mpq_class &op1, const mpq_class &op2) {
+#if defined ___GMPXX_MKII_MPQ_SMALL___
+    if (mpq_class::div_small(op1, op1, op2))
+        return op1;
+#endif
     mpq_div(op1.value, op1.value, op2.value);
     return op1;
 }
 inline mpq_class &operator*=(mpq_class &op1, const mpq_class &op2) {
+#if defined ___GMPXX_MKII_MPQ_SMALL___
+    if (mpq_class::mul_small(op1, op1, op2))
+        return op1;
+#endif
     mpq_mul(op1.value, op1.value, op2.value);
     return op1;
 }
@@ -1896,21 +2626,37 @@ inline mpq_class operator-(const mpq_class &op) {
 }
 inline mpq_class operator+(const mpq_class &op1, const mpq_class &op2) {
     mpq_class result;
+#if defined ___GMPXX_MKII_MPQ_SMALL___
+    if (mpq_class::add_small(result, op1, op2, 1))
+        return result;
+#endif
     mpq_add(result.value, op1.value, op2.value);
     return result;
 }
 inline mpq_class operator-(const mpq_class &op1, const mpq_class &op2) {
     mpq_class result;
+#if defined ___GMPXX_MKII_MPQ_SMALL___
+    if (mpq_class::add_small(result, op1, op2, -1))
+        return result;
+#endif
     mpq_sub(result.value, op1.value, op2.value);
     return result;
 }
 inline mpq_class operator*(const mpq_class &op1, const mpq_class &op2) {
     mpq_class result;
+#if defined ___GMPXX_MKII_MPQ_SMALL___
+    if (mpq_class::mul_small(result, op1, op2))
+        return result;
+#endif
     mpq_mul(result.value, op1.value, op2.value);
     return result;
 }
 inline mpq_class operator/(const mpq_class &op1, const mpq_class &op2) {
     mpq_class result;
+#if defined ___GMPXX_MKII_MPQ_SMALL___
+    if (mpq_class::div_small(result, op1, op2))
+        return result;
+#endif
     mpq_div(result.value, op1.value, op2.value);
     return result;
 }
@@ -2106,117 +2852,593 @@ inline std::ostream &operator<<(std::ostream &os, const mpq_t &op) {
     print_mpq(os, op);
     return os;
 }
-inline std::istream &read_base_mpq_from_stream(std::istream &stream, mpq_t op, int base = 10) {
-    char ch;
-    std::string number;
-    mpz_ptr _numerator = mpq_numref(op);
-    mpz_ptr _denominator = mpq_denref(op);
-    mpq_class result;
-    bool has_slash = false;
-
-    read_base_mpz_from_stream(stream, _numerator, base);
-    if (!stream.eof()) {
-        while (true) {
-            if (stream.get(ch)) {
-                if (ch == '/') {
-                    has_slash = true;
-                    break;
-                } else {
-                    stream.unget();
-                    break;
-                }
-            } else {
-                break;
-            }
-        }
-    }
-    if (has_slash) {
-        char _ch = stream.peek();
-        if (isxdigit(_ch)) {
-            read_base_mpz_from_stream(stream, _denominator, base);
-        } else {
-            stream.setstate(std::ios::failbit);
-        }
-    } else {
-        mpz_set_ui(_denominator, 1UL);
-    }
-    return stream;
-}
-inline std::istream &read_nofmtflags_mpq_from_stream(std::istream &stream, mpq_t op) {
-    char ch;
-    std::string number;
-    mpz_ptr _numerator = mpq_numref(op);
-    mpz_ptr _denominator = mpq_denref(op);
-    mpq_class result;
-    bool has_slash = false;
-    read_nofmtflags_mpz_from_stream(stream, _numerator);
-    if (!stream.eof()) {
-        stream.get(ch);
-        if (ch == '/') {
-            has_slash = true;
+inline std::istream &read_mpq_from_stream(std::istream &stream, mpq_t op) {
+    std::istream::sentry sentry(stream, true);
+    if (!sentry)
+        return stream;
+    helper::istream_scanner in(stream);
+    in.skip_leading_space(stream.flags());
+    bool ok = in.read_integer(stream.flags(), mpq_numref(op));
+    if (ok) {
+        if (in.peek() == '/') {
+            // the denominator is read like an mpz, including its own sign and base prefix
+            in.next();
+            ok = in.read_integer(stream.flags(), mpq_denref(op));
         } else {
-            stream.unget();
+            mpz_set_ui(mpq_denref(op), 1UL);
         }
     }
-    if (has_slash) {
-        char _ch = stream.peek();
-        if (isxdigit(_ch)) {
-            read_nofmtflags_mpz_from_stream(stream, _denominator);
-        } else {
-            stream.setstate(std::ios::failbit);
-        }
-    } else
-        mpz_set_ui(_denominator, 1UL);
+    if (in.eof())
+        stream.setstate(std::ios::eofbit);
+    if (!ok)
+        stream.setstate(std::ios::failbit);
     return stream;
 }
-inline std::istream &read_mpq_from_stream(std::istream &stream, mpq_t op) {
-    std::ios_base::fmtflags current_flags = stream.flags();
-    if (current_flags == std::ios_base::fmtflags(0)) {
-        return read_nofmtflags_mpq_from_stream(stream, op);
-    }
-    if (current_flags & std::ios::oct) {
-        return read_base_mpq_from_stream(stream, op, 8);
-    } else if (current_flags & std::ios::hex) {
-        return read_base_mpq_from_stream(stream, op, 16);
-    }
-    return read_base_mpq_from_stream(stream, op);
-}
 inline std::istream &operator>>(std::istream &stream, mpq_t op) { return read_mpq_from_stream(stream, op); }
 inline std::istream &operator>>(std::istream &stream, mpq_class &op) { return read_mpq_from_stream(stream, op.get_mpq_t()); }
-class mpf_class {
+// radix conversion of mpf values with many digits.
+// mpf_get_str/mpf_set_str recompute the powers of the base on every call; here the numbers are split
+// divide and conquer by base^(2^k), which are computed once per base and kept for later conversions.
+// The powers are exact integers, so one cache serves every precision. Subtrees run as OpenMP tasks
+// for huge values. Below radix_dc_threshold digits GMP's own conversion is used as it is.
+namespace helper {
+constexpr std::size_t radix_dc_threshold = 2000;
+constexpr std::size_t radix_parallel_threshold = 1 << 17;
+// base^(2^k) kept as odd * 2^shift, so that divisions and products work on the odd part only
+struct radix_power {
+    mpz_class odd;
+    mp_bitcnt_t shift;
+};
+class radix_power_cache {
   public:
-    ////////////////////////////////////////////////////////////////////////////////////////
-    // 12.4 C++ Interface Floats
-    // https://gmplib.org/manual/C_002b_002b-Interface-Floats
-    ////////////////////////////////////////////////////////////////////////////////////////
-    // constructors and destructors
-    mpf_class() { mpf_init(value); } // a default precision has already been established during initialization by a call to mpf_set_default_prec.
-    // The rule of 0/3/5
-    // The rule 1 of 5 copy constructor
-    mpf_class(const mpf_class &op) {
-        mpf_init2(value, mpf_get_prec(op.value));
-        mpf_set(value, op.value);
+    static radix_power_cache &instance() {
+        static radix_power_cache cache;
+        return cache;
+    }
+    // base^(2^k); the reference stays valid until clear()
+    const radix_power &get(int base, int k) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::deque<radix_power> &powers = table[base];
+        if (powers.empty()) {
+            mp_bitcnt_t shift = 0;
+            while ((base >> shift) % 2 == 0)
+                shift++;
+            powers.push_back({mpz_class(static_cast<unsigned long>(base >> shift)), shift});
+        }
+        while (static_cast<int>(powers.size()) <= k) {
+            radix_power square;
+            mpz_mul(square.odd.get_mpz_t(), powers.back().odd.get_mpz_t(), powers.back().odd.get_mpz_t());
+            square.shift = 2 * powers.back().shift;
+            powers.push_back(std::move(square));
+        }
+        return powers[k];
     }
-    mpf_class(const mpf_class &op, mp_bitcnt_t prec) {
-        mpf_init2(value, prec);
-        mpf_set(value, op.value);
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto &powers : table)
+            powers.clear();
     }
-    // The rule 2 of 5 copy assignment operator
-    mpf_class &operator=(const mpf_class &op) noexcept {
-        if (this != &op) {
-            mpf_set(value, op.value);
+
+  private:
+    std::mutex mutex;
+    std::deque<radix_power> table[63];
+};
+// rop = base^e
+inline void radix_pow(mpz_class &rop, int base, std::size_t e) {
+    if (e <= radix_dc_threshold) {
+        // small powers are cheaper to compute than to look up
+        mpz_ui_pow_ui(rop.get_mpz_t(), static_cast<unsigned long>(base), e);
+        return;
+    }
+    mp_bitcnt_t shift = 0;
+    rop = 1;
+    for (int k = 0; e != 0; k++, e >>= 1) {
+        if (e & 1) {
+            const radix_power &power = radix_power_cache::instance().get(base, k);
+            mpz_mul(rop.get_mpz_t(), rop.get_mpz_t(), power.odd.get_mpz_t());
+            shift += power.shift;
         }
-        return *this;
     }
-    // The rule 3 of 5 default deconstructor
-    ~mpf_class() { mpf_clear(value); }
-    // The rule 4 of 5 move constructor
-    mpf_class(mpf_class &&op) noexcept {
-        mpf_init(value);
-        mpf_swap(value, op.value);
+    mpz_mul_2exp(rop.get_mpz_t(), rop.get_mpz_t(), shift);
+}
+// k with 2^k < len <= 2^(k+1); the low part of a split gets 2^k digits
+inline int radix_split(std::size_t len) {
+    int k = 0;
+    while ((std::size_t(2) << k) < len)
+        k++;
+    return k;
+}
+// writes exactly len digits of 0 <= op < |base|^len to dst, zero padded on the left
+inline void radix_get_digits(char *dst, std::size_t len, const mpz_class &op, int base) {
+    if (len <= radix_dc_threshold) {
+        char buf[radix_dc_threshold + 3];
+        mpz_get_str(buf, base, op.get_mpz_t());
+        std::size_t n = std::strlen(buf);
+        std::memset(dst, '0', len - n);
+        std::memcpy(dst + len - n, buf, n);
+        return;
+    }
+    int k = radix_split(len);
+    std::size_t lo = std::size_t(1) << k;
+    const radix_power &power = radix_power_cache::instance().get(std::abs(base), k);
+    // op = q * odd * 2^shift + r * 2^shift + low
+    mpz_class q, r, low;
+    mpz_fdiv_q_2exp(q.get_mpz_t(), op.get_mpz_t(), power.shift);
+    mpz_fdiv_r_2exp(low.get_mpz_t(), op.get_mpz_t(), power.shift);
+    mpz_tdiv_qr(q.get_mpz_t(), r.get_mpz_t(), q.get_mpz_t(), power.odd.get_mpz_t());
+    mpz_mul_2exp(r.get_mpz_t(), r.get_mpz_t(), power.shift);
+    mpz_add(r.get_mpz_t(), r.get_mpz_t(), low.get_mpz_t());
+#if defined _OPENMP
+#pragma omp task shared(q) if (len >= radix_parallel_threshold)
+#endif
+    radix_get_digits(dst, len - lo, q, base);
+    radix_get_digits(dst + len - lo, lo, r, base);
+#if defined _OPENMP
+#pragma omp taskwait
+#endif
+}
+// rop = the integer written by the len digits at src (all valid in base)
+inline void radix_set_digits(mpz_class &rop, const char *src, std::size_t len, int base) {
+    if (len <= radix_dc_threshold) {
+        char buf[radix_dc_threshold + 1];
+        std::memcpy(buf, src, len);
+        buf[len] = '\0';
+        mpz_set_str(rop.get_mpz_t(), buf, base);
+        return;
+    }
+    int k = radix_split(len);
+    std::size_t lo = std::size_t(1) << k;
+    mpz_class hi;
+#if defined _OPENMP
+#pragma omp task shared(hi) if (len >= radix_parallel_threshold)
+#endif
+    radix_set_digits(hi, src, len - lo, base);
+    radix_set_digits(rop, src + len - lo, lo, base);
+#if defined _OPENMP
+#pragma omp taskwait
+#endif
+    const radix_power &power = radix_power_cache::instance().get(base, k);
+    mpz_mul(hi.get_mpz_t(), hi.get_mpz_t(), power.odd.get_mpz_t());
+    mpz_mul_2exp(hi.get_mpz_t(), hi.get_mpz_t(), power.shift);
+    mpz_add(rop.get_mpz_t(), rop.get_mpz_t(), hi.get_mpz_t());
+}
+// runs f in a parallel region (if not already in one) so that the OpenMP tasks above have threads to run on
+template <typename F> void radix_parallel(std::size_t len, F f) {
+#if defined _OPENMP
+    if (len >= radix_parallel_threshold && !omp_in_parallel()) {
+#pragma omp parallel
+#pragma omp single
+        f();
+        return;
     }
-    // The rule 5 of 5 move assignment operator
-    mpf_class &operator=(mpf_class &&op) noexcept {
+#endif
+    (void)len;
+    f();
+}
+inline const char *radix_digit_chars(int base) {
+    if (base > 36)
+        return "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+    return base > 0 ? "0123456789abcdefghijklmnopqrstuvwxyz" : "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+}
+// value of digit c in base, or -1
+inline int radix_digit_value(char c, int base) {
+    int v = -1;
+    if (c >= '0' && c <= '9')
+        v = c - '0';
+    else if (c >= 'A' && c <= 'Z')
+        v = c - 'A' + 10;
+    else if (c >= 'a' && c <= 'z')
+        v = c - 'a' + (base > 36 ? 36 : 10);
+    return v < base ? v : -1;
+}
+// digits needed for prec bits; what mpf_get_str(..., n_digits = 0, ...) produces for mpf_get_prec() == prec
+inline std::size_t radix_significant_digits(mp_bitcnt_t prec, int base) { return static_cast<std::size_t>(static_cast<double>(prec) * std::log(2.0) / std::log(static_cast<double>(base))) + 2; }
+// n digits of |op| in base into digits (a std::string or a char_buffer), rounded half up (or half to even) from the
+// exact binary value, where the last digit of mpf_get_str may be off by one; trailing zeros are removed, none for
+// op == 0, and |op| = 0.ddd * base^exp; n is not limited by the precision of op
+template <typename Digits> void radix_get_digits_exact(Digits &digits, mp_exp_t &exp, int base, std::size_t n, mpf_srcptr op, bool ties_to_even = false) {
+    int abase = std::abs(base);
+    exp = 0;
+    digits.resize(0);
+    if (mpf_sgn(op) == 0)
+        return;
+    // |op| = M * 2^E, M being the limbs of op
+    mpz_t M;
+    mpz_roinit_n(M, op->_mp_d, std::abs(op->_mp_size));
+    long E = static_cast<long>(op->_mp_exp - std::abs(op->_mp_size)) * GMP_NUMB_BITS;
+    // n + 1 digits D = floor(|op| * base^t), t = n + 1 - k, k the number of integral digits; k is an estimate
+    long k = static_cast<long>(std::floor(static_cast<double>(E + static_cast<long>(mpz_sizeinbase(M, 2)) - 1) * std::log(2.0) / std::log(static_cast<double>(abase)))) + 1;
+    mpz_class D, P;
+    bool exact;
+    while (true) {
+        long t = static_cast<long>(n + 1) - k;
+        if (t >= 0) {
+            radix_pow(P, abase, static_cast<std::size_t>(t));
+            mpz_mul(D.get_mpz_t(), M, P.get_mpz_t());
+            exact = (E >= 0) || mpz_divisible_2exp_p(D.get_mpz_t(), static_cast<mp_bitcnt_t>(-E));
+            if (E >= 0)
+                mpz_mul_2exp(D.get_mpz_t(), D.get_mpz_t(), static_cast<mp_bitcnt_t>(E));
+            else
+                mpz_fdiv_q_2exp(D.get_mpz_t(), D.get_mpz_t(), static_cast<mp_bitcnt_t>(-E));
+        } else {
+            radix_pow(P, abase, static_cast<std::size_t>(-t));
+            if (E >= 0) {
+                mpz_mul_2exp(D.get_mpz_t(), M, static_cast<mp_bitcnt_t>(E));
+            } else {
+                mpz_set(D.get_mpz_t(), M);
+                mpz_mul_2exp(P.get_mpz_t(), P.get_mpz_t(), static_cast<mp_bitcnt_t>(-E));
+            }
+            exact = mpz_divisible_p(D.get_mpz_t(), P.get_mpz_t());
+            mpz_fdiv_q(D.get_mpz_t(), D.get_mpz_t(), P.get_mpz_t());
+        }
+        std::size_t len = mpz_sizeinbase(D.get_mpz_t(), abase);
+        if (len <= radix_dc_threshold) {
+            digits.resize(len + 2);
+            mpz_get_str(&digits[0], base, D.get_mpz_t());
+            digits.resize(std::strlen(&digits[0]));
+        } else {
+            digits.resize(len);
+            std::memset(&digits[0], '0', len);
+            radix_power_cache::instance().get(abase, radix_split(len));
+            radix_parallel(len, [&]() { radix_get_digits(&digits[0], len, D, base); });
+        }
+        std::size_t skip = 0;
+        while (skip < digits.size() && digits[skip] == '0')
+            skip++;
+        if (skip != 0) {
+            std::memmove(&digits[0], &digits[0] + skip, digits.size() - skip);
+            digits.resize(digits.size() - skip);
+        }
+        if (digits.size() >= n + 1) {
+            // k was too small: the extra low digits are dropped, which is floor() again
+            k += static_cast<long>(digits.size() - (n + 1));
+            for (std::size_t i = n + 1; exact && i < digits.size(); i++)
+                exact = digits[i] == '0';
+            digits.resize(n + 1);
+            break;
+        }
+        k -= static_cast<long>(n + 1 - digits.size());
+    }
+    // round the last digit away, carrying to the left; an exact tie goes to even if asked
+    const char *chars = radix_digit_chars(base);
+    bool round_up = 2 * radix_digit_value(digits[n], abase) >= abase;
+    if (ties_to_even && exact && 2 * radix_digit_value(digits[n], abase) == abase)
+        round_up = n > 0 && radix_digit_value(digits[n - 1], abase) % 2 == 1;
+    digits.resize(n);
+    if (round_up) {
+        std::size_t i = n;
+        while (i > 0 && digits[i - 1] == chars[abase - 1])
+            digits[--i] = '0';
+        if (i == 0) {
+            digits.resize(1);
+            digits[0] = '1';
+            k++;
+        } else {
+            digits[i - 1] = chars[radix_digit_value(digits[i - 1], abase) + 1];
+        }
+    }
+    std::size_t last = digits.size();
+    while (last > 0 && digits[last - 1] == '0')
+        last--;
+    digits.resize(last);
+    exp = k;
+}
+// the same as a string with '-' for negative op, as mpf_get_str
+inline std::string radix_get_str_exact(mp_exp_t &exp, int base, std::size_t n, mpf_srcptr op, bool ties_to_even = false) {
+    std::string digits;
+    radix_get_digits_exact(digits, exp, base, n, op, ties_to_even);
+    if (mpf_sgn(op) < 0)
+        digits.insert(0, 1, '-');
+    return digits;
+}
+} // namespace helper
+
+// std::string version of mpf_get_str(nullptr, &exp, base, n_digits, op): the digits of op rounded to n_digits
+// (0: as many as the precision of op warrants), '-' for negative op, trailing zeros removed; op = 0.ddd * base^exp.
+inline std::string mpf_get_str_dc(mp_exp_t &exp, int base, std::size_t n_digits, mpf_srcptr op) {
+    int abase = std::abs(base);
+    if (base > 62 || base < -36 || abase < 2)
+        throw std::invalid_argument("mpf_get_str_dc: base must be in 2..62 or -36..-2");
+    // like mpf_get_str, never more digits than the precision of op warrants
+    std::size_t n = helper::radix_significant_digits(mpf_get_prec(op), abase);
+    if (n_digits != 0 && n_digits < n)
+        n = n_digits;
+    if (n <= helper::radix_dc_threshold) {
+        char *temp = mpf_get_str(nullptr, &exp, base, n_digits, op);
+        std::string result = temp;
+        void (*freefunc)(void *, size_t);
+        mp_get_memory_functions(nullptr, nullptr, &freefunc);
+        freefunc(temp, std::strlen(temp) + 1);
+        return result;
+    }
+    return helper::radix_get_str_exact(exp, base, n, op);
+}
+// mpf_set_str with the same syntax; returns 0 on success and -1 if str is not a valid number (rop is then unchanged)
+inline int mpf_set_str_dc(mpf_ptr rop, const char *str, int base) {
+    int abase = std::abs(base);
+    if (base > 62 || base < -62 || abase < 2)
+        return -1;
+    if (std::strlen(str) <= helper::radix_dc_threshold)
+        return mpf_set_str(rop, str, base);
+    // [-]digits[.digits][(@|e|E)[-+]exponent] with the quirks of mpf_set_str: white space may lead and may
+    // appear among the digits, the exponent must follow its marker directly and anything after it is ignored
+    const char *p = str;
+    while (std::isspace(static_cast<unsigned char>(*p)))
+        p++;
+    bool negative = (*p == '-');
+    if (negative)
+        p++;
+    if (*p != '.' && helper::radix_digit_value(*p, abase) < 0)
+        return -1;
+    std::string mantissa;
+    long fraction_digits = 0;
+    for (bool seen_point = false;; p++) {
+        if (std::isspace(static_cast<unsigned char>(*p)))
+            continue;
+        if (*p == '.' && !seen_point) {
+            seen_point = true;
+            continue;
+        }
+        if (helper::radix_digit_value(*p, abase) < 0)
+            break;
+        mantissa += *p;
+        fraction_digits += seen_point;
+    }
+    if (mantissa.empty())
+        return -1;
+    long exponent = 0;
+    if (*p == '@' || (abase <= 10 && (*p == 'e' || *p == 'E'))) {
+        p++;
+        bool exponent_negative = (*p == '-');
+        if (*p == '-' || *p == '+')
+            p++;
+        int exponent_base = (base < 0) ? 10 : abase;
+        const char *exponent_begin = p;
+        for (int v; (v = helper::radix_digit_value(*p, exponent_base)) >= 0; p++) {
+            if (exponent > (std::numeric_limits<long>::max() - v) / exponent_base / 2)
+                return -1;
+            exponent = exponent * exponent_base + v;
+        }
+        if (p == exponent_begin)
+            return -1;
+        if (exponent_negative)
+            exponent = -exponent;
+    } else if (*p != '\0') {
+        return -1;
+    }
+    // digits beyond what the precision can use are dropped (truncation, as mpf_set_str)
+    mp_bitcnt_t prec = mpf_get_prec(rop);
+    std::size_t first = mantissa.find_first_not_of('0');
+    if (first == std::string::npos) {
+        mpf_set_ui(rop, 0UL);
+        return 0;
+    }
+    std::size_t used = std::min(mantissa.size() - first, helper::radix_significant_digits(prec + 2 * GMP_NUMB_BITS, abase));
+    long scale = exponent - fraction_digits + static_cast<long>(mantissa.size() - first - used);
+    mpz_class N;
+    helper::radix_power_cache::instance().get(abase, helper::radix_split(used));
+    helper::radix_parallel(used, [&]() { helper::radix_set_digits(N, mantissa.data() + first, used, abase); });
+    const unsigned long abs_scale = static_cast<unsigned long>(scale < 0 ? -scale : scale);
+    if (abs_scale > used) {
+        // the exact power would be longer than the mantissa, without bound for exponents such as e30000000:
+        // scale by base^|scale| at the working precision, with guard bits for the roundings of the powering
+        mp_bitcnt_t guard = 2 * GMP_NUMB_BITS + mpz_sizeinbase(mpz_class(abs_scale).get_mpz_t(), 2) + GMP_NUMB_BITS;
+        mpf_t num, power;
+        mpf_init2(num, prec + guard);
+        mpf_init2(power, prec + guard);
+        mpf_set_z(num, N.get_mpz_t());
+        mpf_set_ui(power, static_cast<unsigned long>(abase));
+        mpf_pow_ui(power, power, abs_scale);
+        if (scale >= 0)
+            mpf_mul(rop, num, power);
+        else
+            mpf_div(rop, num, power);
+        mpf_clear(num);
+        mpf_clear(power);
+        if (negative)
+            mpf_neg(rop, rop);
+        return 0;
+    }
+    mpz_class P;
+    if (scale >= 0) {
+        helper::radix_pow(P, abase, static_cast<std::size_t>(scale));
+        mpz_mul(N.get_mpz_t(), N.get_mpz_t(), P.get_mpz_t());
+        mpf_set_z(rop, N.get_mpz_t());
+    } else {
+        helper::radix_pow(P, abase, static_cast<std::size_t>(-scale));
+        mpf_t num, den;
+        mpf_init2(num, prec + 2 * GMP_NUMB_BITS);
+        mpf_init2(den, prec + 2 * GMP_NUMB_BITS);
+        mpf_set_z(num, N.get_mpz_t());
+        mpf_set_z(den, P.get_mpz_t());
+        mpf_div(rop, num, den);
+        mpf_clear(num);
+        mpf_clear(den);
+    }
+    if (negative)
+        mpf_neg(rop, rop);
+    return 0;
+}
+// releases the cached powers
+inline void clear_radix_cache() { helper::radix_power_cache::instance().clear(); }
+// hexadecimal floating point ("%a", std::hexfloat): [-]0x1.hhhp[+-]d, exact in both directions.
+// The digits are the bits of the limbs, so no conversion arithmetic is needed.
+namespace helper {
+// the four bits N[lo + 3 .. lo] of the integer held in d[0 .. size - 1]; bits below 0 read as zero
+inline unsigned hexfloat_nibble(const mp_limb_t *d, long lo) {
+    if (lo < 0)
+        return static_cast<unsigned>(d[0] << (-lo)) & 15;
+    long i = lo / GMP_NUMB_BITS, shift = lo % GMP_NUMB_BITS;
+    mp_limb_t bits = d[i] >> shift;
+    // lo + 3 never exceeds the leading bit, so d[i + 1] exists when the nibble crosses a limb boundary
+    if (shift > GMP_NUMB_BITS - 4)
+        bits |= d[i + 1] << (GMP_NUMB_BITS - shift);
+    return static_cast<unsigned>(bits) & 15;
+}
+inline int hexfloat_digit_value(char c) {
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+} // namespace helper
+
+// op as [-]0x1.hhhp[+-]d with all significant digits (0x0p+0 for zero)
+inline std::string mpf_get_hexfloat(mpf_srcptr op, bool uppercase = false) {
+    std::string result = (mpf_sgn(op) < 0) ? "-0x" : "0x";
+    long size = std::abs(op->_mp_size);
+    if (size == 0) {
+        result += "0p+0";
+    } else {
+        const mp_limb_t *d = op->_mp_d;
+        long top_bits = static_cast<long>(mpn_sizeinbase(d + size - 1, 1, 2));
+        long leading = (size - 1) * GMP_NUMB_BITS + top_bits - 1;
+        // trailing zero limbs and bits do not produce digits
+        long lowest = static_cast<long>(mpn_scan1(d, 0));
+        result += '1';
+        if (lowest < leading) {
+            result += '.';
+            result.reserve(result.size() + (leading - lowest) / 4 + 24);
+            for (long lo = leading - 4; lo + 3 >= lowest; lo -= 4)
+                result += "0123456789abcdef"[helper::hexfloat_nibble(d, lo)];
+        }
+        long exp = static_cast<long>(op->_mp_exp - 1) * GMP_NUMB_BITS + top_bits - 1;
+        char buf[24];
+        char *end = std::to_chars(buf, buf + sizeof(buf), exp < 0 ? -exp : exp).ptr;
+        result += (exp < 0) ? "p-" : "p+";
+        result.append(buf, end);
+    }
+    if (uppercase)
+        std::transform(result.begin(), result.end(), result.begin(), [](unsigned char c) { return std::toupper(c); });
+    return result;
+}
+// [+-][0x]hhh[.hhh][p[+-]ddd], the exponent in decimal; returns 0 or -1 like mpf_set_str (rop is unchanged on failure).
+// The result is exact when the digits fit in rop, so mpf_set_hexfloat(mpf_get_hexfloat(x)) == x at the precision of x.
+// Digits beyond the precision of rop are truncated.
+inline int mpf_set_hexfloat(mpf_ptr rop, const char *str) {
+    const char *p = str;
+    bool negative = (*p == '-');
+    if (*p == '-' || *p == '+')
+        p++;
+    if (p[0] == '0' && (p[1] == 'x' || p[1] == 'X') && (helper::hexfloat_digit_value(p[2]) >= 0 || (p[2] == '.' && helper::hexfloat_digit_value(p[3]) >= 0)))
+        p += 2;
+    // keep at most the digits that fit in the _mp_prec + 1 limbs of rop, plus one for the leading digit
+    const std::size_t max_digits = static_cast<std::size_t>(mpf_get_prec(rop) / 4) + GMP_NUMB_BITS / 2 + 1;
+    std::string digits;
+    long exp = 0;
+    bool seen_digit = false, seen_point = false;
+    for (;; p++) {
+        if (*p == '.' && !seen_point) {
+            seen_point = true;
+            continue;
+        }
+        if (helper::hexfloat_digit_value(*p) < 0)
+            break;
+        seen_digit = true;
+        if (digits.empty() && *p == '0') {
+            exp -= 4 * seen_point;
+            continue;
+        }
+        if (digits.size() < max_digits) {
+            digits += *p;
+            exp -= 4 * seen_point;
+        } else {
+            exp += 4 * !seen_point;
+        }
+    }
+    if (!seen_digit)
+        return -1;
+    if (*p == 'p' || *p == 'P') {
+        p++;
+        bool exp_negative = (*p == '-');
+        if (*p == '-' || *p == '+')
+            p++;
+        if (*p < '0' || *p > '9')
+            return -1;
+        long e = 0;
+        for (; *p >= '0' && *p <= '9'; p++) {
+            if (e > (std::numeric_limits<long>::max() - 9) / 10 / 2)
+                return -1;
+            e = e * 10 + (*p - '0');
+        }
+        exp += exp_negative ? -e : e;
+    }
+    if (*p != '\0')
+        return -1;
+    if (digits.empty()) {
+        mpf_set_ui(rop, 0UL);
+        return 0;
+    }
+    // value = N * 2^exp; shifting N left by exp mod GMP_NUMB_BITS makes the exponent a whole number of limbs, so
+    // the shifted limbs are the mantissa of an mpf as is and mpf_set only drops the limbs rop cannot hold
+    const long shift = ((exp % GMP_NUMB_BITS) + GMP_NUMB_BITS) % GMP_NUMB_BITS;
+    const long limb_exp = (exp - shift) / GMP_NUMB_BITS;
+    const int per_limb = GMP_NUMB_BITS / 4;
+    mp_size_t size = static_cast<mp_size_t>((digits.size() + per_limb - 1) / per_limb);
+    std::vector<mp_limb_t> limbs(size + 1, 0);
+    for (std::size_t k = 0; k < digits.size(); k++) {
+        std::size_t pos = digits.size() - 1 - k;
+        limbs[k / per_limb] |= static_cast<mp_limb_t>(helper::hexfloat_digit_value(digits[pos])) << (4 * (k % per_limb));
+    }
+    if (shift != 0)
+        limbs[size] = mpn_lshift(limbs.data(), limbs.data(), size, static_cast<unsigned>(shift));
+    if (limbs[size] != 0)
+        size++;
+    // skip the zero limbs at the bottom, they are not part of an mpf mantissa
+    mp_size_t low = 0;
+    while (limbs[low] == 0)
+        low++;
+    __mpf_struct exact;
+    exact._mp_prec = static_cast<int>(size - low);
+    exact._mp_size = static_cast<int>(size - low);
+    exact._mp_exp = static_cast<mp_exp_t>(limb_exp + size);
+    exact._mp_d = limbs.data() + low;
+    if (negative)
+        exact._mp_size = -exact._mp_size;
+    mpf_set(rop, &exact);
+    return 0;
+}
+class mpf_class {
+  public:
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // 12.4 C++ Interface Floats
+    // https://gmplib.org/manual/C_002b_002b-Interface-Floats
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // constructors and destructors
+    mpf_class() { mpf_init(value); } // a default precision has already been established during initialization by a call to mpf_set_default_prec.
+    // The rule of 0/3/5
+    // The rule 1 of 5 copy constructor
+    mpf_class(const mpf_class &op) {
+        mpf_init2(value, mpf_get_prec(op.value));
+        mpf_set(value, op.value);
+    }
+    mpf_class(const mpf_class &op, mp_bitcnt_t prec) {
+        mpf_init2(value, prec);
+        mpf_set(value, op.value);
+    }
+    // The rule 2 of 5 copy assignment operator
+    mpf_class &operator=(const mpf_class &op) noexcept {
+        if (this != &op) {
+            mpf_set(value, op.value);
+        }
+        return *this;
+    }
+    // The rule 3 of 5 default deconstructor
+    ~mpf_class() {
+        // limbs borrowed by mpf_view are released to their owner
+        if (value->_mp_d != nullptr)
+            mpf_clear(value);
+    }
+    // The rule 4 of 5 move constructor
+    mpf_class(mpf_class &&op) noexcept {
+        mpf_init(value);
+        mpf_swap(value, op.value);
+    }
+    // The rule 5 of 5 move assignment operator
+    mpf_class &operator=(mpf_class &&op) noexcept {
         if (this != &op) {
 #if !defined ___GMPXX_MKII_NOPRECCHANGE___
             if (mpf_get_prec(this->get_mpf_t()) == mpf_get_prec(op.value)) {
@@ -2240,6 +3462,7 @@ class mpf_class {
         mpf_init(value);
         mpf_set_z(value, op);
     }
+    explicit mpf_class(const mpz_view &op) noexcept;
     mpf_class(const mpq_t op) noexcept {
         mpf_init(value);
         mpf_set_q(value, op);
@@ -2296,13 +3519,13 @@ class mpf_class {
     }
     mpf_class(const char *str, mp_bitcnt_t prec, int base = gmpxx_defaults::base) {
         mpf_init2(value, prec);
-        if (mpf_set_str(value, str, base) != 0) {
+        if (mpf_set_str_dc(value, str, base) != 0) {
             throw std::invalid_argument("");
         }
     }
     mpf_class(const std::string &str, mp_bitcnt_t prec, int base = gmpxx_defaults::base) {
         mpf_init2(value, prec);
-        if (mpf_set_str(value, str.c_str(), base) != 0) {
+        if (mpf_set_str_dc(value, str.c_str(), base) != 0) {
             throw std::invalid_argument("");
         }
     }
@@ -2329,13 +3552,13 @@ class mpf_class {
         return *this;
     }
     mpf_class &operator=(const char *str) {
-        if (mpf_set_str(value, str, gmpxx_defaults::base) != 0) {
+        if (mpf_set_str_dc(value, str, gmpxx_defaults::base) != 0) {
             throw std::invalid_argument("");
         }
         return *this;
     }
     mpf_class &operator=(const std::string &str) {
-        if (mpf_set_str(value, str.c_str(), gmpxx_defaults::base) != 0) {
+        if (mpf_set_str_dc(value, str.c_str(), gmpxx_defaults::base) != 0) {
             throw std::invalid_argument("");
         }
         return *this;
@@ -2476,19 +3699,19 @@ class mpf_class {
     inline friend bool operator<=(const mpz_class &op1, const mpf_class &op2) { return mpf_cmp_z(op2.value, op1.get_mpz_t()) >= 0; }
     inline friend bool operator>=(const mpz_class &op1, const mpf_class &op2) { return mpf_cmp_z(op2.value, op1.get_mpz_t()) <= 0; }
 
-    inline friend bool operator==(const mpf_class &op1, const mpq_class &op2) { return mpf_cmp(op1.value, mpf_class(op2).value) == 0; }
-    inline friend bool operator!=(const mpf_class &op1, const mpq_class &op2) { return mpf_cmp(op1.value, mpf_class(op2).value) != 0; }
-    inline friend bool operator<(const mpf_class &op1, const mpq_class &op2) { return mpf_cmp(op1.value, mpf_class(op2).value) < 0; }
-    inline friend bool operator>(const mpf_class &op1, const mpq_class &op2) { return mpf_cmp(op1.value, mpf_class(op2).value) > 0; }
-    inline friend bool operator<=(const mpf_class &op1, const mpq_class &op2) { return mpf_cmp(op1.value, mpf_class(op2).value) <= 0; }
-    inline friend bool operator>=(const mpf_class &op1, const mpq_class &op2) { return mpf_cmp(op1.value, mpf_class(op2).value) >= 0; }
+    inline friend bool operator==(const mpf_class &op1, const mpq_class &op2) { return helper::mpf_cmp_q(op1.value, op2.get_mpq_t()) == 0; }
+    inline friend bool operator!=(const mpf_class &op1, const mpq_class &op2) { return helper::mpf_cmp_q(op1.value, op2.get_mpq_t()) != 0; }
+    inline friend bool operator<(const mpf_class &op1, const mpq_class &op2) { return helper::mpf_cmp_q(op1.value, op2.get_mpq_t()) < 0; }
+    inline friend bool operator>(const mpf_class &op1, const mpq_class &op2) { return helper::mpf_cmp_q(op1.value, op2.get_mpq_t()) > 0; }
+    inline friend bool operator<=(const mpf_class &op1, const mpq_class &op2) { return helper::mpf_cmp_q(op1.value, op2.get_mpq_t()) <= 0; }
+    inline friend bool operator>=(const mpf_class &op1, const mpq_class &op2) { return helper::mpf_cmp_q(op1.value, op2.get_mpq_t()) >= 0; }
 
-    inline friend bool operator==(const mpq_class &op1, const mpf_class &op2) { return mpf_cmp(op2.value, mpf_class(op1).value) == 0; }
-    inline friend bool operator!=(const mpq_class &op1, const mpf_class &op2) { return mpf_cmp(op2.value, mpf_class(op1).value) != 0; }
-    inline friend bool operator<(const mpq_class &op1, const mpf_class &op2) { return mpf_cmp(op2.value, mpf_class(op1).value) > 0; }
-    inline friend bool operator>(const mpq_class &op1, const mpf_class &op2) { return mpf_cmp(op2.value, mpf_class(op1).value) < 0; }
-    inline friend bool operator<=(const mpq_class &op1, const mpf_class &op2) { return mpf_cmp(op2.value, mpf_class(op1).value) >= 0; }
-    inline friend bool operator>=(const mpq_class &op1, const mpf_class &op2) { return mpf_cmp(op2.value, mpf_class(op1).value) <= 0; }
+    inline friend bool operator==(const mpq_class &op1, const mpf_class &op2) { return helper::mpf_cmp_q(op2.value, op1.get_mpq_t()) == 0; }
+    inline friend bool operator!=(const mpq_class &op1, const mpf_class &op2) { return helper::mpf_cmp_q(op2.value, op1.get_mpq_t()) != 0; }
+    inline friend bool operator<(const mpq_class &op1, const mpf_class &op2) { return helper::mpf_cmp_q(op2.value, op1.get_mpq_t()) > 0; }
+    inline friend bool operator>(const mpq_class &op1, const mpf_class &op2) { return helper::mpf_cmp_q(op2.value, op1.get_mpq_t()) < 0; }
+    inline friend bool operator<=(const mpq_class &op1, const mpf_class &op2) { return helper::mpf_cmp_q(op2.value, op1.get_mpq_t()) >= 0; }
+    inline friend bool operator>=(const mpq_class &op1, const mpf_class &op2) { return helper::mpf_cmp_q(op2.value, op1.get_mpq_t()) <= 0; }
 
     inline friend bool operator==(const mpf_class &op1, double op2) { return mpf_cmp_d(op1.value, op2) == 0; }
     inline friend bool operator!=(const mpf_class &op1, double op2) { return mpf_cmp_d(op1.value, op2) != 0; }
@@ -2562,12 +3785,7 @@ class mpf_class {
     unsigned long get_ui() const { return mpf_get_ui(value); }
     long get_si() const { return mpf_get_si(value); }
     std::string get_str(mp_exp_t &exp, int base = 10, size_t digits = 0) const {
-        char *temp = mpf_get_str(nullptr, &exp, base, digits, value);
-        std::string result = temp;
-        void (*freefunc)(void *, size_t);
-        mp_get_memory_functions(nullptr, nullptr, &freefunc);
-        freefunc(temp, std::strlen(temp) + 1);
-        return result;
+        return mpf_get_str_dc(exp, base, digits, value);
     }
     void div_2exp(mp_bitcnt_t exp) {
         mpf_ptr non_const_ptr = const_cast<mpf_ptr>(this->get_mpf_t());
@@ -2584,8 +3802,8 @@ class mpf_class {
     }
     // int mpf_class::set_str (const char *str, int base)
     // int mpf_class::set_str (const string& str, int base)
-    int set_str(const char *str, int base) { return mpf_set_str(value, str, base); }
-    int set_str(const std::string &str, int base) { return mpf_set_str(value, str.c_str(), base); }
+    int set_str(const char *str, int base) { return mpf_set_str_dc(value, str, base); }
+    int set_str(const std::string &str, int base) { return mpf_set_str_dc(value, str.c_str(), base); }
 
     // int sgn (mpf_class op)
     // mpf_class sqrt (mpf_class op)
@@ -2638,6 +3856,23 @@ class mpf_class {
     mpf_srcptr get_mpf_t() const { return value; }
     mpf_ptr get_mpf_t() { return value; }
 
+  private:
+    friend class mpf_view;
+    struct roinit_tag {};
+    // read-only view of n limbs with exponent exp in limbs, the sign of n being the sign of the value (see mpf_view).
+    // GMP has no mpf_roinit_n; high zero limbs are dropped here since mpf operands must have a nonzero top limb.
+    mpf_class(roinit_tag, const mp_limb_t *d, mp_size_t n, mp_exp_t exp, mp_bitcnt_t prec) noexcept {
+        mp_size_t size = std::abs(n);
+        while (size > 0 && d[size - 1] == 0) {
+            size--;
+            exp--;
+        }
+        value->_mp_prec = static_cast<int>((prec + 2 * GMP_NUMB_BITS - 1) / GMP_NUMB_BITS);
+        value->_mp_size = static_cast<int>(n < 0 ? -size : size);
+        value->_mp_exp = size == 0 ? 0 : exp;
+        value->_mp_d = const_cast<mp_limb_t *>(d);
+    }
+
   private:
     mpf_t value;
 };
@@ -2661,22 +3896,27 @@ inline int preccmp(const mpf_class &op1, const mpf_class &op2) {
     }
 }
 inline mpf_class &operator+=(mpf_class &lhs, const mpf_class &rhs) {
+    GMPXX_MKII_PROFILE("operator+=", helper::profile_limbs(lhs, rhs));
     mpf_add(lhs.value, lhs.value, rhs.value);
     return lhs;
 }
 inline mpf_class &operator-=(mpf_class &lhs, const mpf_class &rhs) {
+    GMPXX_MKII_PROFILE("operator-=", helper::profile_limbs(lhs, rhs));
     mpf_sub(lhs.value, lhs.value, rhs.value);
     return lhs;
 }
 inline mpf_class &operator*=(mpf_class &lhs, const mpf_class &rhs) {
+    GMPXX_MKII_PROFILE("operator*=", helper::profile_limbs(lhs, rhs));
     mpf_mul(lhs.value, lhs.value, rhs.value);
     return lhs;
 }
 inline mpf_class &operator/=(mpf_class &lhs, const mpf_class &rhs) {
+    GMPXX_MKII_PROFILE("operator/=", helper::profile_limbs(lhs, rhs));
     mpf_div(lhs.value, lhs.value, rhs.value);
     return lhs;
 }
 inline mpf_class operator+(const mpf_class &op1, const mpf_class &op2) {
+    GMPXX_MKII_PROFILE("operator+", helper::profile_limbs(op1, op2));
 #if !defined ___GMPXX_MKII_NOPRECCHANGE___
     mp_bitcnt_t max_prec = std::max(op1.get_prec(), op2.get_prec());
     mpf_class result(0, max_prec);
@@ -2687,6 +3927,7 @@ inline mpf_class operator+(const mpf_class &op1, const mpf_class &op2) {
     return result;
 }
 inline mpf_class operator-(const mpf_class &op1, const mpf_class &op2) {
+    GMPXX_MKII_PROFILE("operator-", helper::profile_limbs(op1, op2));
 #if defined ___GMPXX_MKII_NOPRECCHANGE___
     mpf_class result(op1);
     mpf_sub(result.value, result.value, op2.value);
@@ -2705,6 +3946,7 @@ inline mpf_class operator-(const mpf_class &op1, const mpf_class &op2) {
 #endif
 }
 inline mpf_class operator*(const mpf_class &op1, const mpf_class &op2) {
+    GMPXX_MKII_PROFILE("operator*", helper::profile_limbs(op1, op2));
 #if !defined ___GMPXX_MKII_NOPRECCHANGE___
     mp_bitcnt_t max_prec = std::max(op1.get_prec(), op2.get_prec());
     mpf_class result(0, max_prec);
@@ -2715,6 +3957,7 @@ inline mpf_class operator*(const mpf_class &op1, const mpf_class &op2) {
     return result;
 }
 inline mpf_class operator/(const mpf_class &op1, const mpf_class &op2) {
+    GMPXX_MKII_PROFILE("operator/", helper::profile_limbs(op1, op2));
 #if defined ___GMPXX_MKII_NOPRECCHANGE___
     mpf_class result(op1);
     mpf_div(result.value, result.value, op2.value);
@@ -2764,8 +4007,8 @@ template <typename T> inline NON_INT_COND(T, int) cmp(const T op1, mpq_class &op
 
 // mpf_class cmp
 inline int cmp(const mpf_class &op1, const mpf_class &op2) { return mpf_cmp(op1.get_mpf_t(), op2.get_mpf_t()); }
-inline int cmp(const mpf_class &op1, const mpq_class &op2) { return mpf_cmp(op1.get_mpf_t(), mpf_class(op2).get_mpf_t()); }
-inline int cmp(const mpq_class &op1, const mpf_class &op2) { return mpf_cmp(mpf_class(op1).get_mpf_t(), op2.get_mpf_t()); }
+inline int cmp(const mpf_class &op1, const mpq_class &op2) { return helper::mpf_cmp_q(op1.get_mpf_t(), op2.get_mpq_t()); }
+inline int cmp(const mpq_class &op1, const mpf_class &op2) { return -helper::mpf_cmp_q(op2.get_mpf_t(), op1.get_mpq_t()); }
 inline int cmp(const mpf_class &op1, const mpz_class &op2) { return mpf_cmp_z(op1.get_mpf_t(), op2.get_mpz_t()); }
 inline int cmp(const mpz_class &op1, const mpf_class &op2) { return -mpf_cmp_z(op2.get_mpf_t(), op1.get_mpz_t()); }
 inline int cmp(const mpf_class &op1, const double op2) { return mpf_cmp_d(op1.get_mpf_t(), op2); }
@@ -2774,13 +4017,13 @@ template <typename T> inline UNSIGNED_INT_COND(T, int) cmp(const mpf_class &op1,
 template <typename T> inline UNSIGNED_INT_COND(T, int) cmp(const T op1, mpf_class &op2) { return -mpf_cmp_ui(op2.get_mpf_t(), static_cast<unsigned long int>(op1)); }
 template <typename T> inline SIGNED_INT_COND(T, int) cmp(const mpf_class &op1, T op2) { return mpf_cmp_si(op1.get_mpf_t(), static_cast<signed long int>(op2)); }
 template <typename T> inline SIGNED_INT_COND(T, int) cmp(const T op1, mpf_class &op2) { return -mpf_cmp_si(op2.get_mpf_t(), static_cast<signed long int>(op1)); }
-template <typename T> inline NON_INT_COND(T, int) cmp(const mpf_class &op1, T op2) { return mpf_cmp(op1.get_mpf_t(), mpf_class(op2).get_mpf_t()); }
-template <typename T> inline NON_INT_COND(T, int) cmp(const T op1, mpf_class &op2) { return -mpf_cmp(op2.get_mpf_t(), mpf_class(op1).get_mpf_t()); }
+template <typename T> inline NON_INT_COND(T, int) cmp(const mpf_class &op1, T op2) { return mpf_cmp_d(op1.get_mpf_t(), static_cast<double>(op2)); }
+template <typename T> inline NON_INT_COND(T, int) cmp(const T op1, mpf_class &op2) { return -mpf_cmp_d(op2.get_mpf_t(), static_cast<double>(op1)); }
 
 // implimentation of mpf_class operators
-// improvements can be done using mpf_XXX_ui (note that they are not _si)
+// integers go through mpf_XXX_ui (note that they are not _si), floating point values through a helper::mpf_double
+// on the stack; neither allocates a temporary. Results have the precision they had with an mpf_class(op) temporary.
 template <typename T> inline SIGNED_INT_COND(T, mpf_class &) operator+=(mpf_class &lhs, const T rhs) {
-    mpf_class _rhs(rhs);
     if (rhs >= 0) {
         mpf_add_ui(lhs.value, lhs.value, static_cast<unsigned long int>(rhs));
     } else {
@@ -2919,8 +4162,7 @@ template <typename T> inline UNSIGNED_INT_COND(T, mpf_class) operator/(const T o
     return result;
 }
 template <typename T> inline NON_INT_COND(T, mpf_class &) operator+=(mpf_class &lhs, const T rhs) {
-    mpf_class _rhs(rhs);
-    mpf_add(lhs.value, lhs.value, _rhs.value);
+    mpf_add(lhs.value, lhs.value, helper::mpf_double(rhs).get_mpf_t());
     return lhs;
 }
 template <typename T> inline NON_INT_COND(T, mpf_class) operator+(const mpf_class &op1, const T op2) {
@@ -2930,44 +4172,41 @@ template <typename T> inline NON_INT_COND(T, mpf_class) operator+(const mpf_clas
 }
 template <typename T> inline NON_INT_COND(T, mpf_class) operator+(const T op1, const mpf_class &op2) { return op2 + op1; }
 template <typename T> inline NON_INT_COND(T, mpf_class &) operator-=(mpf_class &lhs, const T rhs) {
-    mpf_class _rhs(rhs);
-    mpf_sub(lhs.value, lhs.value, _rhs.value);
+    mpf_sub(lhs.value, lhs.value, helper::mpf_double(rhs).get_mpf_t());
     return lhs;
 }
 template <typename T> inline NON_INT_COND(T, mpf_class) operator-(const mpf_class &op1, const T op2) {
-    mpf_class result(op2);
-    mpf_sub(result.value, op1.value, result.value);
+    mpf_class result;
+    mpf_sub(result.value, op1.value, helper::mpf_double(op2).get_mpf_t());
     return result;
 }
 template <typename T> inline NON_INT_COND(T, mpf_class) operator-(const T op1, const mpf_class &op2) {
-    mpf_class result(op1);
-    mpf_sub(result.value, result.value, op2.value);
+    mpf_class result;
+    mpf_sub(result.value, helper::mpf_double(op1).get_mpf_t(), op2.value);
     return result;
 }
 template <typename T> inline NON_INT_COND(T, mpf_class &) operator*=(mpf_class &lhs, const T rhs) {
-    mpf_class _rhs(rhs);
-    mpf_mul(lhs.value, lhs.value, _rhs.value);
+    mpf_mul(lhs.value, lhs.value, helper::mpf_double(rhs).get_mpf_t());
     return lhs;
 }
 template <typename T> inline NON_INT_COND(T, mpf_class) operator*(const mpf_class &op1, const T op2) {
-    mpf_class result(op2);
-    mpf_mul(result.value, op1.value, result.value);
+    mpf_class result;
+    mpf_mul(result.value, op1.value, helper::mpf_double(op2).get_mpf_t());
     return result;
 }
 template <typename T> inline NON_INT_COND(T, mpf_class) operator*(const T op1, const mpf_class &op2) { return op2 * op1; }
 template <typename T> inline NON_INT_COND(T, mpf_class &) operator/=(mpf_class &lhs, const T rhs) {
-    mpf_class _rhs(rhs);
-    mpf_div(lhs.value, lhs.value, _rhs.value);
+    mpf_div(lhs.value, lhs.value, helper::mpf_double(rhs).get_mpf_t());
     return lhs;
 }
 template <typename T> inline NON_INT_COND(T, mpf_class) operator/(const mpf_class &op1, const T op2) {
-    mpf_class result(op2);
-    mpf_div(result.value, op1.value, result.value);
+    mpf_class result;
+    mpf_div(result.value, op1.value, helper::mpf_double(op2).get_mpf_t());
     return result;
 }
 template <typename T> inline NON_INT_COND(T, mpf_class) operator/(const T op1, const mpf_class &op2) {
-    mpf_class result(op1);
-    mpf_div(result.value, result.value, op2.value);
+    mpf_class result;
+    mpf_div(result.value, helper::mpf_double(op1).get_mpf_t(), op2.value);
     return result;
 }
 inline mpf_class &operator+=(mpf_class &lhs, const mpz_class &rhs) {
@@ -3121,6 +4360,7 @@ inline mpf_class trunc(const mpf_class &op) {
     return rop;
 }
 inline mpf_class sqrt(const mpf_class &op) {
+    GMPXX_MKII_PROFILE("sqrt", helper::profile_limbs(op));
     mpf_class rop(op);
     mpf_sqrt(rop.value, op.get_mpf_t());
     return rop;
@@ -3170,9 +4410,7 @@ inline int sgn(const mpf_class &op) {
 inline std::string mpf_to_base_string_default(const mpf_t value, int base, int flags, int width, int prec, char fill) {
     mp_exp_t exp;
     int effective_prec = (prec == 0) ? 6 : prec;
-    char *base_cstr = mpf_get_str(nullptr, &exp, base, effective_prec, value);
-    std::string base_str(base_cstr);
-    free(base_cstr);
+    std::string base_str = mpf_get_str_dc(exp, base, effective_prec, value);
 
     bool is_showbase = flags & std::ios::showbase;
     bool is_showpoint = flags & std::ios::showpoint;
@@ -3277,9 +4515,7 @@ inline std::string mpf_to_base_string_fixed(const mpf_t value, int base, int fla
     mp_exp_t exp;
     int effective_prec = (prec == 0) ? 6 : prec;
     mp_exp_t digits = integraldigits_in_base(value, base);
-    char *base_cstr = mpf_get_str(nullptr, &exp, base, digits + effective_prec, value);
-    std::string base_str(base_cstr);
-    free(base_cstr);
+    std::string base_str = mpf_get_str_dc(exp, base, digits + effective_prec, value);
     bool is_showbase = flags & std::ios::showbase;
     bool is_showpoint = flags & std::ios::showpoint;
     bool is_uppercase = flags & std::ios::uppercase;
@@ -3356,9 +4592,7 @@ inline std::string mpf_to_base_string_scientific(const mpf_t value, int base, in
     // TODO obtain correct # of digits in the given base, check rounding of the negative exp part
     mp_exp_t exp;
     int effective_prec = (prec == 0) ? 6 : prec;
-    char *base_cstr = mpf_get_str(nullptr, &exp, base, effective_prec + 1, value);
-    std::string base_str(base_cstr);
-    free(base_cstr);
+    std::string base_str = mpf_get_str_dc(exp, base, effective_prec + 1, value);
     bool is_showbase = flags & std::ios::showbase;
     bool is_uppercase = flags & std::ios::uppercase;
     std::string formatted_base;
@@ -3450,7 +4684,10 @@ inline void print_mpf(std::ostream &os, const mpf_t op) {
     }
     std::string format;
     std::string base_string;
-    if (is_fixed) {
+    if (is_fixed && is_scientific) {
+        // std::hexfloat
+        base_string = mpf_get_hexfloat(op, flags & std::ios::uppercase);
+    } else if (is_fixed) {
         base_string = mpf_to_base_string_fixed(op, base, flags, width, prec, fill);
     } else if (is_scientific) {
         base_string = mpf_to_base_string_scientific(op, base, flags, width, prec, fill);
@@ -3486,7 +4723,6 @@ inline std::ostream &operator<<(std::ostream &os, const mpf_t &op) {
     print_mpf(os, op);
     return os;
 }
-inline bool is_valid_number_char(char ch) { return std::isxdigit(ch) || ch == '.' || ch == 'p' || ch == 'P' || ch == '-' || ch == '+'; }
 inline void print_format_flags(std::ios_base::fmtflags flags) {
     std::cout << "Current Format Flags:" << std::endl;
     if (flags & std::ios_base::dec)
@@ -3523,97 +4759,64 @@ inline void print_format_flags(std::ios_base::fmtflags flags) {
 }
 inline std::istream &read_mpf_from_stream(std::istream &stream, mpf_t op) {
     std::ios_base::fmtflags current_flags = stream.flags();
-    if (current_flags & std::ios_base::oct || current_flags & std::ios_base::hex) {
+    if (current_flags & std::ios_base::oct) {
         throw std::runtime_error("Unsupported number base for mpf_t");
     }
-    char ch;
-    std::string number;
-    bool negative = false;
-    bool is_space = false;
-    int base = 10;
-    int counter = 0;
-    while (stream >> ch && isspace(ch)) {
-        is_space = true;
-        counter++;
-    }
-    if (!(current_flags & std::ios::skipws) && is_space == true) {
-        for (int i = 0; i <= counter; i++)
-            stream.unget();
-        stream.setstate(std::ios::failbit);
+    // std::hex or std::hexfloat read the hexadecimal floating point format of mpf_get_hexfloat; the exponent of the
+    // positional std::hex output ("c.9f2cae+24", "1.4484c0@-25") is not part of it and sets failbit
+    const bool hexfloat = (current_flags & std::ios_base::hex) || (current_flags & std::ios_base::floatfield) == std::ios_base::floatfield;
+    // the decimal point of the stream's locale, as in GMP's operator>>; thousands separators are not read
+    const char point = std::use_facet<std::numpunct<char>>(stream.getloc()).decimal_point();
+    std::istream::sentry sentry(stream, true);
+    if (!sentry)
         return stream;
-    }
-    if (ch == '+' || ch == '-') {
-        negative = (ch == '-');
-        if (!stream.get(ch)) {
-            stream.setstate(std::ios::failbit);
-            return stream;
-        }
-        if (ch == '+' || ch == '-') {
-            stream.unget();
-            stream.setstate(std::ios::failbit);
-            return stream;
-        }
-    }
-    if (ch == '.') {
-        if (!stream.get(ch)) {
-            stream.setstate(std::ios::failbit);
-            return stream;
+    helper::istream_scanner in(stream);
+    helper::char_buffer number;
+    bool ok = false;
+    const int base = hexfloat ? 16 : 10;
+
+    in.skip_leading_space(current_flags);
+    in.read_sign(number);
+    if (hexfloat && in.peek() == '0') {
+        ok = true;
+        number.push_back('0');
+        in.next();
+        if (in.peek() == 'x' || in.peek() == 'X') {
+            // "0x" is a prefix, digits must follow
+            ok = false;
+            number.push_back('x');
+            in.next();
         }
-        if (ch == 'e' || ch == 'E') {
-            stream.unget();
-            stream.setstate(std::ios::failbit);
-            return stream;
-        }
-    }
-    if (ch == 'e' || ch == 'E') {
-        stream.unget();
-        stream.setstate(std::ios::failbit);
-        return stream;
-    }
-    if (!std::isdigit(ch) && ch != '.') {
-        stream.setstate(std::ios::failbit);
-        return stream;
-    }
-    while (is_valid_number_char(ch)) {
-        number += ch;
-        if (!stream.get(ch))
-            break;
     }
-    // The following code detects invalid +-, -+, --, ++
-    std::size_t pos_plus_minus = number.find("+-");
-    std::size_t pos_minus_plus = number.find("-+");
-    std::size_t pos_minus_minus = number.find("--");
-    std::size_t pos_plus_plus = number.find("++");
-    std::size_t invalid_pos = std::string::npos;
-    if (pos_plus_minus != std::string::npos) {
-        invalid_pos = pos_plus_minus;
-    } else if (pos_minus_plus != std::string::npos) {
-        invalid_pos = pos_minus_plus;
-    } else if (pos_minus_minus != std::string::npos) {
-        invalid_pos = pos_minus_minus;
-    } else if (pos_plus_plus != std::string::npos) {
-        invalid_pos = pos_plus_plus;
-    }
-    if (invalid_pos != std::string::npos) {
-        if (stream.eof())
-            stream.clear();
-        for (std::size_t i = number.size(); i > invalid_pos + 1; --i) {
-            stream.unget();
+    in.read_digits(number, ok, base);
+    if (in.peek() == point) {
+        number.push_back('.');
+        in.next();
+        in.read_digits(number, ok, base);
+    }
+    const char exponent_mark = hexfloat ? 'p' : 'e';
+    if (ok && std::tolower(static_cast<unsigned char>(in.peek())) == exponent_mark) {
+        // at least one exponent digit is required; it is decimal in both formats
+        number.push_back(exponent_mark);
+        in.next();
+        ok = false;
+        if (in.peek() == '-' || in.peek() == '+') {
+            number.push_back(in.peek());
+            in.next();
         }
+        in.read_digits(number, ok, 10);
+    } else if (hexfloat && (in.peek() == '@' || in.peek() == '+' || in.peek() == '-')) {
+        // the "@+05" or "+24" exponent of the positional std::hex output, which this format does not read
+        ok = false;
+    }
+    if (in.eof())
+        stream.setstate(std::ios::eofbit);
+    if (ok && hexfloat)
+        mpf_set_hexfloat(op, number.c_str());
+    else if (ok)
+        mpf_set_str_dc(op, number.c_str(), base);
+    else
         stream.setstate(std::ios::failbit);
-        return stream;
-    }
-    int ret = mpf_set_str(op, number.c_str(), base);
-    if (ret != 0) {
-        stream.setstate(stream.rdstate() & ~std::ios::goodbit);
-        stream.setstate(std::ios::failbit);
-    } else {
-        stream.clear(stream.rdstate() & ~std::ios::failbit);
-        stream.setstate(std::ios::goodbit);
-    }
-    if (negative) {
-        mpf_neg(op, op);
-    }
     return stream;
 }
 inline std::istream &operator>>(std::istream &stream, mpf_t op) { return read_mpf_from_stream(stream, op); }
@@ -3622,7 +4825,9 @@ inline mpf_class const_pi() {
     static bool calculated = false;
     static mp_bitcnt_t calculated_pi_precision = 0;
     mp_bitcnt_t _default_prec = mpf_get_default_prec();
+    GMPXX_MKII_PROFILE("const_pi()", (_default_prec + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS);
     if (!calculated || (calculated && calculated_pi_precision != _default_prec)) {
+        GMPXX_MKII_PROFILE_COUNT("const_pi().cache_misses", 1);
         calculated_pi_precision = mpf_get_default_prec();
         // calculating approximate pi using arithmetic-geometric mean
         mpf_class zero(0.0, _default_prec);
@@ -3661,14 +4866,16 @@ inline mpf_class const_pi() {
                 converged = true;
             }
         }
+        GMPXX_MKII_PROFILE_COUNT("const_pi().agm_iterations", iteration);
         calculated = true;
         caches<>::pi_cached = tmp_pi;
     } else {
-        //      std::cout << "pi cached\n";
+        GMPXX_MKII_PROFILE_COUNT("const_pi().cache_hits", 1);
     }
     return caches<>::pi_cached;
 }
 inline mpf_class const_pi(mp_bitcnt_t req_precision) {
+    GMPXX_MKII_PROFILE("const_pi(prec)", (req_precision + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS);
 #if defined ___GMPXX_MKII_NOPRECCHANGE___
     assert(req_precision == mpf_get_default_prec());
 #endif
@@ -3724,6 +4931,7 @@ inline mpf_class const_pi(mp_bitcnt_t req_precision) {
             converged = true;
         }
     }
+    GMPXX_MKII_PROFILE_COUNT("const_pi(prec).agm_iterations", iteration);
     calculated_pi = tmp_pi;
     assert(calculated_pi.get_prec() == req_precision);
     assert(a.get_prec() == req_precision);
@@ -3785,6 +4993,7 @@ inline mpf_class const_log2() {
     return log2_cached;
 }
 inline mpf_class const_log2(mp_bitcnt_t req_precision) {
+    GMPXX_MKII_PROFILE("const_log2(prec)", (req_precision + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS);
 #if defined ___GMPXX_MKII_NOPRECCHANGE___
     assert(req_precision == mpf_get_default_prec());
 #endif
@@ -3845,6 +5054,7 @@ inline mpf_class const_log2(mp_bitcnt_t req_precision) {
     return log2;
 }
 inline mpf_class log(const mpf_class &x) {
+    GMPXX_MKII_PROFILE("log", helper::profile_limbs(x));
     mp_bitcnt_t req_precision = x.get_prec();
 #if defined ___GMPXX_MKII_NOPRECCHANGE___
     assert(req_precision == mpf_get_default_prec());
@@ -3882,7 +5092,10 @@ inline mpf_class log(const mpf_class &x) {
     mpf_get_d_2exp(&m, s.get_mpf_t());
 
     b = one;
-    b.mul_2exp(m);
+    if (m >= 0)
+        b.mul_2exp(m);
+    else
+        b.div_2exp(-m);
     s = x * b;
 
     b = four / s;
@@ -3900,6 +5113,7 @@ inline mpf_class log(const mpf_class &x) {
         a = a_next;
         b = b_next;
     }
+    GMPXX_MKII_PROFILE_COUNT("log.agm_iterations", counter);
     _log = _pi / (two * b) - m * _log2;
 
     assert(_log.get_prec() == req_precision);
@@ -3916,6 +5130,7 @@ inline mpf_class log(const mpf_class &x) {
     return _log;
 }
 inline mpf_class exp(const mpf_class &x) {
+    GMPXX_MKII_PROFILE("exp", helper::profile_limbs(x));
     // https://www.mpfr.org/algorithms.pdf section 4.4
     mp_bitcnt_t req_precision = x.get_prec();
 #if defined ___GMPXX_MKII_NOPRECCHANGE___
@@ -4039,6 +5254,7 @@ inline mpf_class cos_taylor_naive(const mpf_class &x) {
 }
 // Internal use only. calculate cos(x) where x is [-pi/2, pi/2).
 inline mpf_class cos_taylor_reduced(const mpf_class &x, bool addprec = false) {
+    GMPXX_MKII_PROFILE("cos_taylor_reduced", helper::profile_limbs(x));
     mp_bitcnt_t _req_precision = x.get_prec();
 #if defined ___GMPXX_MKII_NOPRECCHANGE___
     assert(_req_precision == mpf_get_default_prec());
@@ -4083,6 +5299,7 @@ inline mpf_class cos_taylor_reduced(const mpf_class &x, bool addprec = false) {
         l = l + 1;
         counter++;
     }
+    GMPXX_MKII_PROFILE_COUNT("cos_taylor_reduced.terms", counter);
     s += one;
     for (mp_bitcnt_t i = 0; i < k; i++) {
         s *= two * s;
@@ -4094,6 +5311,7 @@ inline mpf_class cos_taylor_reduced(const mpf_class &x, bool addprec = false) {
     return _s;
 }
 inline mpf_class cos_taylor(const mpf_class &x) {
+    GMPXX_MKII_PROFILE("cos", helper::profile_limbs(x));
     mp_bitcnt_t req_precision = x.get_prec();
 #if defined ___GMPXX_MKII_NOPRECCHANGE___
     assert(req_precision == mpf_get_default_prec());
@@ -4121,7 +5339,7 @@ inline mpf_class cos_taylor(const mpf_class &x) {
     x_reduced -= pi;
     // Furthur reduce x to  [-pi/2, pi/2)
     if (x_reduced > pi_over_2) {
-        x_reduced = pi - x;
+        x_reduced = pi - x_reduced;
         symm_sign = -1;
     } else if (x_reduced < -pi_over_2) {
         x_reduced = -pi - x_reduced;
@@ -4224,6 +5442,7 @@ inline mpf_class sinx_from_cos_internal(const mpf_class &x, bool addprec = false
     return _s;
 }
 inline mpf_class sin_from_cos(const mpf_class &x) {
+    GMPXX_MKII_PROFILE("sin", helper::profile_limbs(x));
     mp_bitcnt_t req_precision = x.get_prec();
 #if defined ___GMPXX_MKII_NOPRECCHANGE___
     assert(req_precision == mpf_get_default_prec());
@@ -4269,24 +5488,22 @@ inline mpf_class sin_from_cos(const mpf_class &x) {
 }
 inline mpf_class sin(const mpf_class &x) { return sin_from_cos(x); }
 inline mpf_class tan_from_sin_cos(const mpf_class &x) {
+    GMPXX_MKII_PROFILE("tan", helper::profile_limbs(x));
     mp_bitcnt_t req_precision = x.get_prec();
 #if defined ___GMPXX_MKII_NOPRECCHANGE___
     assert(req_precision == mpf_get_default_prec());
 #endif
     // Constants and variables
     mpf_class _PI(0.0, req_precision);
-    mpf_class two_pi(0.0, req_precision);
     mpf_class pi_over_2(0.0, req_precision);
     mpf_class x_reduced(0.0, req_precision);
     mpf_class zero(0.0, req_precision);
     mpf_class one(1.0, req_precision);
     mpf_class two(2.0, req_precision);
-    mpf_class three(3.0, req_precision);
     mpf_class n(0.0, req_precision);
     int symm_sign = 1;
     // Setting some constants
     _PI = const_pi(req_precision);
-    two_pi = two * _PI;
     pi_over_2 = _PI / two;
     // tan(-x) = -tan(x)
     x_reduced = x;
@@ -4294,18 +5511,10 @@ inline mpf_class tan_from_sin_cos(const mpf_class &x) {
         x_reduced = -x_reduced;
         symm_sign = -1;
     }
-    // Reduce x to [0, 2pi)
-    x_reduced = mpf_remainder(x_reduced, two_pi);
-    // Furthur reduce x to [0, pi/2)
-    if ((pi_over_2 < x_reduced) && (x_reduced <= _PI)) {
+    // tan has period pi: reduce x to [0, pi), then to [0, pi/2] with tan(pi - x) = -tan(x)
+    x_reduced = mpf_remainder(x_reduced, _PI);
+    if (pi_over_2 < x_reduced) {
         x_reduced = _PI - x_reduced;
-    }
-    if ((_PI < x_reduced) && (x_reduced <= three * two_pi)) {
-        x_reduced = three * two_pi - x_reduced;
-        symm_sign *= -1;
-    }
-    if ((three * two_pi < x_reduced) && (x_reduced <= two_pi)) {
-        x_reduced = two_pi - x_reduced;
         symm_sign *= -1;
     }
     // Calculate tan(x) using Taylor series
@@ -4322,8 +5531,8 @@ inline mpf_class tan_from_sin_cos(const mpf_class &x) {
     mpf_class sinx(0.0, _req_precision);
     mpf_class tanx(0.0, _req_precision);
 
-    cosx = cos_taylor_reduced(x, true);
-    sinx = sinx_from_cos_internal(x, true);
+    cosx = cos_taylor_reduced(x_reduced, true);
+    sinx = sinx_from_cos_internal(x_reduced, true);
     tanx = (sinx / cosx);
     tanx *= symm_sign;
     return tanx;
@@ -4348,6 +5557,7 @@ inline mpf_class pow_from_exp_log(const mpf_class &x, const mpf_class &y) {
     return result;
 }
 inline mpf_class pow(const mpf_class &x, const mpf_class &y) {
+    GMPXX_MKII_PROFILE("pow", helper::profile_limbs(x, y));
     if (mpf_integer_p(y.get_mpf_t()) != 0) {
         if (y > 0) {
             unsigned long int y_uint = mpf_get_ui(y.get_mpf_t());
@@ -4390,6 +5600,7 @@ inline mpf_class log10_from_log(const mpf_class &x) {
 }
 inline mpf_class log10(const mpf_class &x) { return log10_from_log(x); }
 inline mpf_class atan_AGM(const mpf_class &_x) {
+    GMPXX_MKII_PROFILE("atan", helper::profile_limbs(_x));
     mp_bitcnt_t req_precision = _x.get_prec();
 #if defined ___GMPXX_MKII_NOPRECCHANGE___
     assert(req_precision == mpf_get_default_prec());
@@ -4433,6 +5644,7 @@ inline mpf_class atan_AGM(const mpf_class &_x) {
 
     si = s, vi = v, qi = q;
     while (one - si >= epsilon) {
+        GMPXX_MKII_PROFILE_COUNT("atan.agm_iterations", 1);
         qi = two * qi / (one + si);
         ai = two * si * vi / (one + vi * vi);
         bi = ai / (one + sqrt(one - ai * ai));
@@ -4750,6 +5962,2652 @@ class gmp_randclass {
         }
     }
 }; // gmp_randclass
+namespace helper {
+// containers smaller than this are initialized by the calling thread
+constexpr std::size_t first_touch_threshold = 1 << 14;
+#if defined ___GMPXX_MKII_USE_NUMA___
+// pins the calling thread to the NUMA node it is running on, so that it stays next to the pages it touches first
+inline void numa_bind_thread() {
+    thread_local bool bound = false;
+    if (bound)
+        return;
+    bound = true;
+    if (numa_available() < 0)
+        return;
+    int node = numa_node_of_cpu(sched_getcpu());
+    if (node >= 0) {
+        numa_run_on_node(node);
+        numa_set_localalloc();
+    }
+}
+#endif
+// runs body(i) for i in [0, n) on the thread that gets i in a "#pragma omp for schedule(static)" loop over [0, n)
+template <typename F> void parallel_static_for(std::size_t n, F body) {
+#if defined _OPENMP
+#pragma omp parallel if (n >= first_touch_threshold)
+    {
+#if defined ___GMPXX_MKII_USE_NUMA___
+        numa_bind_thread();
+#endif
+#pragma omp for schedule(static)
+        for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>(n); i++)
+            body(static_cast<std::size_t>(i));
+    }
+#else
+    for (std::size_t i = 0; i < n; i++)
+        body(i);
+#endif
+}
+#if defined ___GMPXX_MKII_USE_HUGEPAGES___
+constexpr std::size_t huge_page_size = std::size_t(2) << 20;
+inline std::size_t huge_page_round(std::size_t bytes) { return (bytes + huge_page_size - 1) / huge_page_size * huge_page_size; }
+// maps bytes (a multiple of huge_page_size) aligned to huge_page_size: explicit MAP_HUGETLB pages when
+// ___GMPXX_MKII_USE_HUGETLB___ is defined and the pool has enough of them, transparent huge pages otherwise
+inline void *huge_page_map(std::size_t bytes) {
+#if defined ___GMPXX_MKII_USE_HUGETLB___ && defined MAP_HUGETLB
+    void *p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (p != MAP_FAILED)
+        return p;
+#endif
+    char *q = static_cast<char *>(mmap(nullptr, bytes + huge_page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if (q == MAP_FAILED)
+        throw std::bad_alloc();
+    std::size_t head = (huge_page_size - reinterpret_cast<std::uintptr_t>(q) % huge_page_size) % huge_page_size;
+    if (head != 0)
+        munmap(q, head);
+    munmap(q + head + bytes, huge_page_size - head);
+#if defined MADV_HUGEPAGE
+    madvise(q + head, bytes, MADV_HUGEPAGE);
+#endif
+    return q + head;
+}
+inline void huge_page_unmap(void *p, std::size_t bytes) { munmap(p, bytes); }
+// allocator for blocks of huge_page_size or more; smaller ones come from operator new
+template <typename T> struct huge_page_allocator {
+    using value_type = T;
+    huge_page_allocator() = default;
+    template <typename U> huge_page_allocator(const huge_page_allocator<U> &) {}
+    T *allocate(std::size_t n) {
+        if (n * sizeof(T) < huge_page_size)
+            return static_cast<T *>(::operator new(n * sizeof(T)));
+        return static_cast<T *>(huge_page_map(huge_page_round(n * sizeof(T))));
+    }
+    void deallocate(T *p, std::size_t n) {
+        if (n * sizeof(T) < huge_page_size)
+            ::operator delete(p);
+        else
+            huge_page_unmap(p, huge_page_round(n * sizeof(T)));
+    }
+    template <typename U> bool operator==(const huge_page_allocator<U> &) const { return true; }
+    template <typename U> bool operator!=(const huge_page_allocator<U> &) const { return false; }
+};
+using limb_vector = std::vector<mp_limb_t, huge_page_allocator<mp_limb_t>>;
+// limb arenas: the limbs of the elements of a large mpf_storage are carved out of one huge page mapping.
+// GMP frees and reallocates limbs through its memory functions and mkII moves limbs between objects by swapping,
+// so the memory functions are wrapped when the first arena is made: blocks inside an arena never reach the
+// original functions, and an arena is unmapped once its container is gone and every block it handed out was freed.
+// Changing the GMP memory functions while an arena is alive is not supported.
+class limb_arenas {
+  public:
+    static limb_arenas &instance() {
+        // never destroyed: static mpf_class objects may free limbs after the end of main
+        static limb_arenas *arenas = new limb_arenas;
+        return *arenas;
+    }
+    // an arena of count blocks of block_limbs limbs, or -1 if all the slots are in use
+    int create(std::size_t count, std::size_t block_limbs) {
+        std::lock_guard<std::mutex> guard(lock);
+        for (int id = 0; id < max_arenas; id++) {
+            arena &a = table[id];
+            if (a.end.load() != 0)
+                continue;
+            a.bytes = huge_page_round(count * block_limbs * sizeof(mp_limb_t));
+            a.base = static_cast<mp_limb_t *>(huge_page_map(a.bytes));
+            a.block_limbs = block_limbs;
+            a.live.store(count + 1);
+            a.begin.store(reinterpret_cast<std::uintptr_t>(a.base));
+            a.end.store(reinterpret_cast<std::uintptr_t>(a.base) + a.bytes);
+            if (id >= used.load())
+                used.store(id + 1);
+            return id;
+        }
+        return -1;
+    }
+    mp_limb_t *block(int id, std::size_t i) const { return table[id].base + i * table[id].block_limbs; }
+    // the arena p points into, or -1
+    int find(const void *p) const {
+        std::uintptr_t q = reinterpret_cast<std::uintptr_t>(p);
+        for (int id = 0, n = used.load(); id < n; id++)
+            if (q >= table[id].begin.load(std::memory_order_relaxed) && q < table[id].end.load(std::memory_order_relaxed))
+                return id;
+        return -1;
+    }
+    // called by the container when it is destroyed, and with the number of blocks it did not hand out
+    void release(int id, std::size_t blocks = 1) {
+        if (blocks != 0 && table[id].live.fetch_sub(blocks) == blocks)
+            unmap(id);
+    }
+    void free_block(void *p, std::size_t size) { original_free(p, size); }
+
+  private:
+    static constexpr int max_arenas = 64;
+    struct arena {
+        std::atomic<std::uintptr_t> begin{0}, end{0};
+        std::atomic<std::size_t> live{0};
+        mp_limb_t *base = nullptr;
+        std::size_t bytes = 0, block_limbs = 0;
+    };
+    arena table[max_arenas];
+    std::atomic<int> used{0};
+    std::mutex lock;
+    void *(*original_alloc)(std::size_t);
+    void *(*original_realloc)(void *, std::size_t, std::size_t);
+    void (*original_free)(void *, std::size_t);
+
+    limb_arenas() {
+        mp_get_memory_functions(&original_alloc, &original_realloc, &original_free);
+        mp_set_memory_functions(original_alloc, arena_realloc, arena_free);
+    }
+    void unmap(int id) {
+        std::lock_guard<std::mutex> guard(lock);
+        arena &a = table[id];
+        a.end.store(0);
+        a.begin.store(0);
+        huge_page_unmap(a.base, a.bytes);
+        a.base = nullptr;
+    }
+    static void *arena_realloc(void *p, std::size_t old_size, std::size_t new_size) {
+        limb_arenas &arenas = instance();
+        int id = arenas.find(p);
+        if (id < 0)
+            return arenas.original_realloc(p, old_size, new_size);
+        void *q = arenas.original_alloc(new_size);
+        std::memcpy(q, p, std::min(old_size, new_size));
+        arenas.release(id);
+        return q;
+    }
+    static void arena_free(void *p, std::size_t size) {
+        limb_arenas &arenas = instance();
+        int id = arenas.find(p);
+        if (id < 0)
+            arenas.original_free(p, size);
+        else
+            arenas.release(id);
+    }
+};
+#else
+using limb_vector = std::vector<mp_limb_t>;
+#endif
+// element storage of mpf_vector and mpf_matrix.
+// The elements are constructed, copied and destroyed by parallel_static_for, so with first-touch page placement
+// both the mpf_class objects and their limbs land on the NUMA node of the thread that uses them in a static loop.
+// With -D___GMPXX_MKII_USE_HUGEPAGES___ the objects and, for large containers, the limbs of all the elements are
+// placed in huge pages (see limb_arenas), and the limbs are zeroed by the same parallel loop to fault them in.
+class mpf_storage {
+  public:
+    mpf_storage() : elems(nullptr), count(0) {}
+    mpf_storage(std::size_t n, mp_bitcnt_t prec) : elems(allocate(n)), count(n) {
+#if defined ___GMPXX_MKII_USE_HUGEPAGES___
+        if (use_arena(prec)) {
+            parallel_static_for(count, [&](std::size_t i) { construct_in_arena(i, prec, nullptr); });
+            return;
+        }
+#endif
+        parallel_static_for(count, [&](std::size_t i) { new (elems + i) mpf_class(0UL, prec); });
+    }
+    mpf_storage(const mpf_storage &other) : elems(allocate(other.count)), count(other.count) {
+#if defined ___GMPXX_MKII_USE_HUGEPAGES___
+        // elements whose precision was changed since the arena was made get limbs of their own
+        auto fits = [&](std::size_t i) { return static_cast<std::size_t>(other.elems[i].get_mpf_t()->_mp_prec) + 1 == other.block_limbs; };
+        std::size_t in_arena = 0;
+        if (other.arena >= 0)
+            for (std::size_t i = 0; i < count; i++)
+                in_arena += fits(i);
+        if (in_arena != 0 && use_arena(other.arena_prec)) {
+            parallel_static_for(count, [&](std::size_t i) {
+                if (fits(i))
+                    construct_in_arena(i, arena_prec, other.elems[i].get_mpf_t());
+                else
+                    new (elems + i) mpf_class(other.elems[i]);
+            });
+            limb_arenas::instance().release(arena, count - in_arena);
+            return;
+        }
+#endif
+        parallel_static_for(count, [&](std::size_t i) { new (elems + i) mpf_class(other.elems[i]); });
+    }
+    mpf_storage(mpf_storage &&other) noexcept : elems(nullptr), count(0) { swap(other); }
+    mpf_storage &operator=(mpf_storage other) noexcept {
+        swap(other);
+        return *this;
+    }
+    ~mpf_storage() {
+        parallel_static_for(count, [&](std::size_t i) { elems[i].~mpf_class(); });
+        deallocate(elems, count);
+#if defined ___GMPXX_MKII_USE_HUGEPAGES___
+        if (arena >= 0)
+            limb_arenas::instance().release(arena);
+#endif
+    }
+    std::size_t size() const { return count; }
+    mpf_class *data() { return elems; }
+    const mpf_class *data() const { return elems; }
+    void set_prec(mp_bitcnt_t prec) {
+        parallel_static_for(count, [&](std::size_t i) { elems[i].set_prec(prec); });
+    }
+    // gives every element new limbs allocated by its thread; values assigned from a serial loop
+    // take over the limbs of temporaries made by that one thread
+    void first_touch() {
+        parallel_static_for(count, [&](std::size_t i) {
+#if defined ___GMPXX_MKII_USE_HUGEPAGES___
+            if (arena >= 0 && limb_arenas::instance().find(elems[i].get_mpf_t()->_mp_d) == arena)
+                return;
+#endif
+            mpf_class fresh(elems[i]);
+            mpf_swap(elems[i].get_mpf_t(), fresh.get_mpf_t());
+        });
+    }
+
+  private:
+    mpf_class *elems;
+    std::size_t count;
+    void swap(mpf_storage &other) noexcept {
+        std::swap(elems, other.elems);
+        std::swap(count, other.count);
+#if defined ___GMPXX_MKII_USE_HUGEPAGES___
+        std::swap(arena, other.arena);
+        std::swap(arena_prec, other.arena_prec);
+        std::swap(block_limbs, other.block_limbs);
+#endif
+    }
+#if defined ___GMPXX_MKII_USE_HUGEPAGES___
+    int arena = -1;
+    mp_bitcnt_t arena_prec = 0;
+    std::size_t block_limbs = 0;
+    static mpf_class *allocate(std::size_t n) { return (n == 0) ? nullptr : huge_page_allocator<mpf_class>().allocate(n); }
+    static void deallocate(mpf_class *p, std::size_t n) {
+        if (p != nullptr)
+            huge_page_allocator<mpf_class>().deallocate(p, n);
+    }
+    // makes an arena when the limbs of the elements fill at least one huge page
+    bool use_arena(mp_bitcnt_t prec) {
+        mpf_t probe;
+        mpf_init2(probe, prec);
+        block_limbs = probe->_mp_prec + 1;
+        mpf_clear(probe);
+        if (count * block_limbs * sizeof(mp_limb_t) < huge_page_size)
+            return false;
+        arena = limb_arenas::instance().create(count, block_limbs);
+        arena_prec = prec;
+        return arena >= 0;
+    }
+    // element i with the limbs of block i of the arena, set to op or zero
+    void construct_in_arena(std::size_t i, mp_bitcnt_t prec, mpf_srcptr op) {
+        mpf_class *e = new (elems + i) mpf_class(0UL, prec);
+        mpf_ptr value = e->get_mpf_t();
+        limb_arenas::instance().free_block(value->_mp_d, block_limbs * sizeof(mp_limb_t));
+        value->_mp_d = limb_arenas::instance().block(arena, i);
+        std::fill_n(value->_mp_d, block_limbs, mp_limb_t(0));
+        if (op != nullptr)
+            mpf_set(value, op);
+    }
+#else
+    static mpf_class *allocate(std::size_t n) { return (n == 0) ? nullptr : static_cast<mpf_class *>(::operator new(n * sizeof(mpf_class))); }
+    static void deallocate(mpf_class *p, std::size_t) { ::operator delete(p); }
+#endif
+};
+} // namespace helper
+// mpf_vector, mpf_matrix: containers for bulk operations.
+// Elements are stored contiguously; mpf_matrix is column major with ld() == rows(),
+// the same layout the BLAS style kernels in benchmarks/ take as (A, lda).
+// With OpenMP, large containers are initialized in parallel with the static schedule (first touch), so kernels
+// that loop over the elements with "#pragma omp for schedule(static)" work on memory of their own NUMA node.
+// Compile with -D___GMPXX_MKII_USE_NUMA___ and link with -lnuma to also pin each thread to its node.
+// first_touch() redistributes the limbs after the elements were assigned from a serial loop.
+class mpf_vector {
+  public:
+    mpf_vector() : prec(mpf_get_default_prec()) {}
+    explicit mpf_vector(std::size_t n, mp_bitcnt_t _prec = mpf_get_default_prec()) : prec(_prec) { resize(n); }
+    // elements are reset to zero
+    void resize(std::size_t n) {
+        elems = helper::mpf_storage();
+        elems = helper::mpf_storage(n, prec);
+    }
+    void set_prec(mp_bitcnt_t _prec) {
+        prec = _prec;
+        elems.set_prec(prec);
+    }
+    void first_touch() { elems.first_touch(); }
+    mp_bitcnt_t get_prec() const { return prec; }
+    std::size_t size() const { return elems.size(); }
+    bool empty() const { return elems.size() == 0; }
+    mpf_class &operator[](std::size_t i) { return elems.data()[i]; }
+    const mpf_class &operator[](std::size_t i) const { return elems.data()[i]; }
+    mpf_class *data() { return elems.data(); }
+    const mpf_class *data() const { return elems.data(); }
+    mpf_class *begin() { return elems.data(); }
+    mpf_class *end() { return elems.data() + elems.size(); }
+    const mpf_class *begin() const { return elems.data(); }
+    const mpf_class *end() const { return elems.data() + elems.size(); }
+
+  private:
+    mp_bitcnt_t prec;
+    helper::mpf_storage elems;
+};
+class mpf_matrix {
+  public:
+    mpf_matrix() : m(0), n(0), prec(mpf_get_default_prec()) {}
+    mpf_matrix(std::size_t _m, std::size_t _n, mp_bitcnt_t _prec = mpf_get_default_prec()) : m(0), n(0), prec(_prec) { resize(_m, _n); }
+    // elements are reset to zero
+    void resize(std::size_t _m, std::size_t _n) {
+        elems = helper::mpf_storage();
+        elems = helper::mpf_storage(_m * _n, prec);
+        m = _m;
+        n = _n;
+    }
+    void set_prec(mp_bitcnt_t _prec) {
+        prec = _prec;
+        elems.set_prec(prec);
+    }
+    void first_touch() { elems.first_touch(); }
+    mp_bitcnt_t get_prec() const { return prec; }
+    std::size_t rows() const { return m; }
+    std::size_t cols() const { return n; }
+    std::size_t ld() const { return m; }
+    std::size_t size() const { return elems.size(); }
+    mpf_class &operator()(std::size_t i, std::size_t j) { return elems.data()[i + j * m]; }
+    const mpf_class &operator()(std::size_t i, std::size_t j) const { return elems.data()[i + j * m]; }
+    mpf_class *data() { return elems.data(); }
+    const mpf_class *data() const { return elems.data(); }
+
+  private:
+    std::size_t m, n;
+    mp_bitcnt_t prec;
+    helper::mpf_storage elems;
+};
+// mpf_compact_vector: an mpf_vector that stores only the significant limbs of each element.
+// Values converted from doubles or small integers use one or two limbs whatever the precision,
+// so the limbs are packed into one slab with an offset per element instead of prec/64+1 limbs each.
+// Low zero limbs are dropped and at most as many limbs as mpf_set keeps at get_prec() are stored,
+// so get(i) returns exactly what assigning the value to an mpf_class of get_prec() bits gives.
+// An element that grows on write is moved to the end of the slab; the slab is compacted when half of it is unused.
+// set() may reallocate the slab and is not thread safe; get() is.
+class mpf_compact_vector {
+  public:
+    mpf_compact_vector() : prec(mpf_get_default_prec()), wasted(0) {}
+    explicit mpf_compact_vector(std::size_t n, mp_bitcnt_t _prec = mpf_get_default_prec()) : prec(_prec), wasted(0) { resize(n); }
+    explicit mpf_compact_vector(const mpf_vector &x) : prec(x.get_prec()), wasted(0) {
+        entries.resize(x.size());
+        for (std::size_t i = 0; i < x.size(); i++)
+            set(i, x[i].get_mpf_t());
+    }
+    // elements are reset to zero
+    void resize(std::size_t n) {
+        entries.assign(n, entry());
+        limbs.clear();
+        wasted = 0;
+    }
+    mp_bitcnt_t get_prec() const { return prec; }
+    std::size_t size() const { return entries.size(); }
+    bool empty() const { return entries.empty(); }
+
+    void set(std::size_t i, mpf_srcptr op) {
+        mp_size_t n = std::abs(op->_mp_size);
+        const mp_limb_t *d = op->_mp_d;
+        mp_size_t max_limbs = static_cast<mp_size_t>((prec + 2 * GMP_NUMB_BITS - 1) / GMP_NUMB_BITS) + 1;
+        if (n > max_limbs) {
+            d += n - max_limbs;
+            n = max_limbs;
+        }
+        while (n > 0 && d[0] == 0) {
+            d++;
+            n--;
+        }
+        entry &e = entries[i];
+        if (n > e.capacity) {
+            wasted += e.capacity;
+            e.size = e.capacity = 0;
+            if (wasted > limbs.size() / 2)
+                compact();
+            e.offset = limbs.size();
+            e.capacity = static_cast<int>(n);
+            limbs.resize(limbs.size() + n);
+        }
+        std::copy(d, d + n, limbs.data() + e.offset);
+        e.size = static_cast<int>(op->_mp_size < 0 ? -n : n);
+        e.exp = (n == 0) ? 0 : op->_mp_exp;
+    }
+    void set(std::size_t i, const mpf_class &op) { set(i, op.get_mpf_t()); }
+    void get(mpf_ptr rop, std::size_t i) const {
+        static const mp_limb_t zero_limb = 0;
+        const entry &e = entries[i];
+        __mpf_struct value;
+        value._mp_prec = std::max(std::abs(e.size), 1);
+        value._mp_size = e.size;
+        value._mp_exp = e.exp;
+        value._mp_d = const_cast<mp_limb_t *>(e.size == 0 ? &zero_limb : limbs.data() + e.offset);
+        mpf_set(rop, &value);
+    }
+    mpf_class get(std::size_t i) const {
+        mpf_class result(0UL, prec);
+        get(result.get_mpf_t(), i);
+        return result;
+    }
+    mpf_class operator[](std::size_t i) const { return get(i); }
+    // number of limbs of element i
+    std::size_t limb_count(std::size_t i) const { return std::abs(entries[i].size); }
+    mpf_vector to_vector() const {
+        mpf_vector x(size(), prec);
+        for (std::size_t i = 0; i < size(); i++)
+            get(x[i].get_mpf_t(), i);
+        return x;
+    }
+    // releases the limbs left behind by elements that grew
+    void shrink_to_fit() {
+        compact();
+        limbs.shrink_to_fit();
+    }
+    // bytes used by the slab and the index
+    std::size_t memory_usage() const { return limbs.capacity() * sizeof(mp_limb_t) + entries.capacity() * sizeof(entry); }
+
+  private:
+    struct entry {
+        std::size_t offset = 0;
+        int capacity = 0;
+        int size = 0;
+        mp_exp_t exp = 0;
+    };
+    mp_bitcnt_t prec;
+    std::vector<entry> entries;
+    helper::limb_vector limbs;
+    std::size_t wasted;
+    void compact() {
+        helper::limb_vector packed;
+        packed.reserve(limbs.size() - wasted);
+        for (auto &e : entries) {
+            std::size_t n = std::abs(e.size);
+            std::size_t offset = packed.size();
+            packed.insert(packed.end(), limbs.begin() + e.offset, limbs.begin() + e.offset + n);
+            e.offset = offset;
+            e.capacity = static_cast<int>(n);
+        }
+        limbs.swap(packed);
+        wasted = 0;
+    }
+};
+
+// mpq_accumulator: exact sums of mpq_class terms without canonicalizing after every term.
+// The running sum is an unreduced num/den whose den is the lcm of the denominators added so far, so adding p/q costs
+// gcd(den, q), cheap when q is small, and a few multiplications, where mpq_add also reduces the new numerator
+// against den. gcd(num, den) is cancelled on get() and, if interval is not 0, every interval terms; as den is
+// already the lcm this only pays off when the partial sums cancel, e.g. telescoping series.
+class mpq_accumulator {
+  public:
+    explicit mpq_accumulator(std::size_t _interval = 0) : num(0), den(1), interval(_interval), pending(0) {}
+    void reset() {
+        num = 0;
+        den = 1;
+        pending = 0;
+    }
+    mpq_accumulator &operator+=(const mpq_class &op) {
+        add(op.get_num_mpz_t(), op.get_den_mpz_t(), false);
+        return *this;
+    }
+    mpq_accumulator &operator-=(const mpq_class &op) {
+        add(op.get_num_mpz_t(), op.get_den_mpz_t(), true);
+        return *this;
+    }
+    // += op1 * op2, without reducing the product
+    void add_product(const mpq_class &op1, const mpq_class &op2) {
+        mpz_mul(p.get_mpz_t(), op1.get_num_mpz_t(), op2.get_num_mpz_t());
+        mpz_mul(q.get_mpz_t(), op1.get_den_mpz_t(), op2.get_den_mpz_t());
+        add(p.get_mpz_t(), q.get_mpz_t(), false);
+    }
+    void canonicalize() {
+        mpz_gcd(g.get_mpz_t(), num.get_mpz_t(), den.get_mpz_t());
+        if (mpz_cmp_ui(g.get_mpz_t(), 1) != 0) {
+            mpz_divexact(num.get_mpz_t(), num.get_mpz_t(), g.get_mpz_t());
+            mpz_divexact(den.get_mpz_t(), den.get_mpz_t(), g.get_mpz_t());
+        }
+        pending = 0;
+    }
+    void get(mpq_ptr rop) const {
+        mpq_set_num(rop, num.get_mpz_t());
+        mpq_set_den(rop, den.get_mpz_t());
+        mpq_canonicalize(rop);
+    }
+    mpq_class get() const {
+        mpq_class rop;
+        get(rop.get_mpq_t());
+        return rop;
+    }
+
+  private:
+    mpz_class num, den;
+    mpz_class p, q, g, t;
+    std::size_t interval, pending;
+    // num/den += p/q (q > 0); p and q may be the members p and q
+    void add(mpz_srcptr p_, mpz_srcptr q_, bool negate) {
+        void (*addmul)(mpz_ptr, mpz_srcptr, mpz_srcptr) = negate ? mpz_submul : mpz_addmul;
+        if (mpz_cmp_ui(q_, 1) == 0) {
+            addmul(num.get_mpz_t(), p_, den.get_mpz_t());
+        } else if (mpz_cmp(q_, den.get_mpz_t()) == 0) {
+            (negate ? mpz_sub : mpz_add)(num.get_mpz_t(), num.get_mpz_t(), p_);
+        } else {
+            // num/den + p/q = (num * (q/g) + p * (den/g)) / (den * (q/g)) with g = gcd(den, q)
+            mpz_gcd(g.get_mpz_t(), den.get_mpz_t(), q_);
+            mpz_divexact(t.get_mpz_t(), q_, g.get_mpz_t());
+            mpz_divexact(g.get_mpz_t(), den.get_mpz_t(), g.get_mpz_t());
+            mpz_mul(num.get_mpz_t(), num.get_mpz_t(), t.get_mpz_t());
+            addmul(num.get_mpz_t(), p_, g.get_mpz_t());
+            mpz_mul(den.get_mpz_t(), den.get_mpz_t(), t.get_mpz_t());
+        }
+        if (interval != 0 && ++pending >= interval)
+            canonicalize();
+    }
+};
+
+// mpf_basic<Policy>: an mpf_class whose binary operators take the result precision from Policy, fixed at compile time.
+// Policy::prec(op1, op2) returns the precision of op1 op op2; the policies below give max(op1, op2) (mkII),
+// op1 and mpf_get_default_prec() (mkIISR), and any type with the same static member can be used instead.
+// mpf_basic<P> is an mpf_class, so it is accepted wherever mpf_class is; only mpf_basic<P> op mpf_basic<P>
+// follows the policy, mixed expressions with mpf_class or scalars use the mpf_class operators of the build mode.
+struct mpf_prec_max {
+    static mp_bitcnt_t prec(const mpf_class &op1, const mpf_class &op2) { return std::max(op1.get_prec(), op2.get_prec()); }
+};
+struct mpf_prec_left {
+    static mp_bitcnt_t prec(const mpf_class &op1, const mpf_class &) { return op1.get_prec(); }
+};
+struct mpf_prec_default {
+    static mp_bitcnt_t prec(const mpf_class &, const mpf_class &) { return mpf_get_default_prec(); }
+};
+template <typename Policy> class mpf_basic : public mpf_class {
+  public:
+    using mpf_class::mpf_class;
+    using mpf_class::operator=;
+    mpf_basic() : mpf_class() {}
+    mpf_basic(const mpf_basic &op) = default;
+    mpf_basic(mpf_basic &&op) noexcept = default;
+    mpf_basic(const mpf_class &op) : mpf_class(op) {}
+    mpf_basic(mpf_class &&op) noexcept : mpf_class(std::move(op)) {}
+    mpf_basic &operator=(const mpf_basic &op) = default;
+    mpf_basic &operator=(mpf_basic &&op) noexcept = default;
+    mpf_basic &operator+=(const mpf_class &op) {
+        GMPXX_MKII_PROFILE("mpf_basic::operator+=", helper::profile_limbs(*this, op));
+        mpf_add(get_mpf_t(), get_mpf_t(), op.get_mpf_t());
+        return *this;
+    }
+    template <typename T> typename std::enable_if<std::is_arithmetic<T>::value, mpf_basic &>::type operator+=(const T op) {
+        static_cast<mpf_class &>(*this) += op;
+        return *this;
+    }
+    mpf_basic &operator-=(const mpf_class &op) {
+        GMPXX_MKII_PROFILE("mpf_basic::operator-=", helper::profile_limbs(*this, op));
+        mpf_sub(get_mpf_t(), get_mpf_t(), op.get_mpf_t());
+        return *this;
+    }
+    template <typename T> typename std::enable_if<std::is_arithmetic<T>::value, mpf_basic &>::type operator-=(const T op) {
+        static_cast<mpf_class &>(*this) -= op;
+        return *this;
+    }
+    mpf_basic &operator*=(const mpf_class &op) {
+        GMPXX_MKII_PROFILE("mpf_basic::operator*=", helper::profile_limbs(*this, op));
+        mpf_mul(get_mpf_t(), get_mpf_t(), op.get_mpf_t());
+        return *this;
+    }
+    template <typename T> typename std::enable_if<std::is_arithmetic<T>::value, mpf_basic &>::type operator*=(const T op) {
+        static_cast<mpf_class &>(*this) *= op;
+        return *this;
+    }
+    mpf_basic &operator/=(const mpf_class &op) {
+        GMPXX_MKII_PROFILE("mpf_basic::operator/=", helper::profile_limbs(*this, op));
+        mpf_div(get_mpf_t(), get_mpf_t(), op.get_mpf_t());
+        return *this;
+    }
+    template <typename T> typename std::enable_if<std::is_arithmetic<T>::value, mpf_basic &>::type operator/=(const T op) {
+        static_cast<mpf_class &>(*this) /= op;
+        return *this;
+    }
+    friend mpf_basic operator+(const mpf_basic &op1, const mpf_basic &op2) {
+        GMPXX_MKII_PROFILE("mpf_basic::operator+", helper::profile_limbs(op1, op2));
+        mpf_basic result(0UL, Policy::prec(op1, op2));
+        mpf_add(result.get_mpf_t(), op1.get_mpf_t(), op2.get_mpf_t());
+        return result;
+    }
+    friend mpf_basic operator-(const mpf_basic &op1, const mpf_basic &op2) {
+        GMPXX_MKII_PROFILE("mpf_basic::operator-", helper::profile_limbs(op1, op2));
+        mpf_basic result(0UL, Policy::prec(op1, op2));
+        mpf_sub(result.get_mpf_t(), op1.get_mpf_t(), op2.get_mpf_t());
+        return result;
+    }
+    friend mpf_basic operator*(const mpf_basic &op1, const mpf_basic &op2) {
+        GMPXX_MKII_PROFILE("mpf_basic::operator*", helper::profile_limbs(op1, op2));
+        mpf_basic result(0UL, Policy::prec(op1, op2));
+        mpf_mul(result.get_mpf_t(), op1.get_mpf_t(), op2.get_mpf_t());
+        return result;
+    }
+    friend mpf_basic operator/(const mpf_basic &op1, const mpf_basic &op2) {
+        GMPXX_MKII_PROFILE("mpf_basic::operator/", helper::profile_limbs(op1, op2));
+        mpf_basic result(0UL, Policy::prec(op1, op2));
+        mpf_div(result.get_mpf_t(), op1.get_mpf_t(), op2.get_mpf_t());
+        return result;
+    }
+    friend mpf_basic operator+(const mpf_basic &op) { return mpf_basic(op); }
+    friend mpf_basic operator-(const mpf_basic &op) {
+        mpf_basic result(op);
+        mpf_neg(result.get_mpf_t(), op.get_mpf_t());
+        return result;
+    }
+};
+
+// dd_class: a double-double number hi + lo with |lo| <= ulp(hi) / 2, about 106 bits of precision.
+// For GMPXX_MKII_DEFAULT_PREC around 106 this is a faster alternative to mpf_class: the operations are a few
+// error-free transformations on doubles (two_sum, two_prod) with no allocation and no limb normalization,
+// and arrays of dd_class are plain pairs of doubles the compiler can vectorize in BLAS style loops.
+// The exponent range is that of double. Conversions from mpf_class are accurate to about 2^-106 relative,
+// conversions to mpf_class are exact when the mpf_class is wide enough to hold hi + lo.
+namespace helper {
+inline void dd_two_sum(double a, double b, double &s, double &e) {
+    s = a + b;
+    double bb = s - a;
+    e = (a - (s - bb)) + (b - bb);
+}
+// |a| >= |b| or a == 0
+inline void dd_quick_two_sum(double a, double b, double &s, double &e) {
+    s = a + b;
+    e = b - (s - a);
+}
+inline void dd_two_prod(double a, double b, double &p, double &e) {
+    p = a * b;
+#if defined __FMA__ || defined __FP_FAST_FMA
+    e = std::fma(a, b, -p);
+#else
+    // Dekker's product, splitting each factor into two 26 bit halves
+    constexpr double split = 134217729.0; // 2^27 + 1
+    double t = split * a;
+    double ahi = t - (t - a), alo = a - ahi;
+    t = split * b;
+    double bhi = t - (t - b), blo = b - bhi;
+    e = ((ahi * bhi - p) + ahi * blo + alo * bhi) + alo * blo;
+#endif
+}
+} // namespace helper
+
+class dd_class {
+  public:
+    dd_class() noexcept : hi(0.0), lo(0.0) {}
+    dd_class(double op) noexcept : hi(op), lo(0.0) {}
+    dd_class(double _hi, double _lo) noexcept { helper::dd_two_sum(_hi, _lo, hi, lo); }
+    dd_class(signed int op) noexcept : hi(static_cast<double>(op)), lo(0.0) {}
+    dd_class(unsigned int op) noexcept : hi(static_cast<double>(op)), lo(0.0) {}
+    // a 64 bit integer is the exact sum of its high and low 32 bits
+    dd_class(signed long int op) noexcept { helper::dd_two_sum(std::ldexp(static_cast<double>(static_cast<int64_t>(op) >> 32), 32), static_cast<double>(static_cast<int64_t>(op) & 0xffffffff), hi, lo); }
+    dd_class(unsigned long int op) noexcept { helper::dd_two_sum(std::ldexp(static_cast<double>(static_cast<uint64_t>(op) >> 32), 32), static_cast<double>(static_cast<uint64_t>(op) & 0xffffffff), hi, lo); }
+    explicit dd_class(const mpf_class &op) { set_mpf(op.get_mpf_t()); }
+    explicit dd_class(const mpf_t op) { set_mpf(op); }
+    dd_class(const char *str) { set_mpf(mpf_class(str, 128).get_mpf_t()); }
+    dd_class(const std::string &str) { set_mpf(mpf_class(str, 128).get_mpf_t()); }
+
+    explicit operator mpf_class() const { return get_mpf_class(); }
+    mpf_class get_mpf_class(mp_bitcnt_t prec = 106) const {
+        mpf_class rop(hi, prec);
+        helper::mpf_double _lo(lo);
+        mpf_add(rop.get_mpf_t(), rop.get_mpf_t(), _lo.get_mpf_t());
+        return rop;
+    }
+    double get_d() const { return hi; }
+    double get_hi() const { return hi; }
+    double get_lo() const { return lo; }
+    mp_bitcnt_t get_prec() const { return 106; }
+
+    dd_class &operator+=(const dd_class &op) { return *this = *this + op; }
+    dd_class &operator-=(const dd_class &op) { return *this = *this - op; }
+    dd_class &operator*=(const dd_class &op) { return *this = *this * op; }
+    dd_class &operator/=(const dd_class &op) { return *this = *this / op; }
+
+    friend dd_class operator+(const dd_class &op1, const dd_class &op2) {
+        double s, e, t, f;
+        helper::dd_two_sum(op1.hi, op2.hi, s, e);
+        helper::dd_two_sum(op1.lo, op2.lo, t, f);
+        e += t;
+        helper::dd_quick_two_sum(s, e, s, e);
+        e += f;
+        return dd_class(s, e, quick_tag());
+    }
+    friend dd_class operator-(const dd_class &op) { return dd_class(-op.hi, -op.lo, raw_tag()); }
+    friend dd_class operator+(const dd_class &op) { return op; }
+    friend dd_class operator-(const dd_class &op1, const dd_class &op2) { return op1 + (-op2); }
+    friend dd_class operator*(const dd_class &op1, const dd_class &op2) {
+        double p, e;
+        helper::dd_two_prod(op1.hi, op2.hi, p, e);
+        e += op1.hi * op2.lo + op1.lo * op2.hi;
+        return dd_class(p, e, quick_tag());
+    }
+    // three quotient digits: q1 + q2 from long division, q3 to round the remainder
+    friend dd_class operator/(const dd_class &op1, const dd_class &op2) {
+        double q1 = op1.hi / op2.hi;
+        dd_class r = op1 - op2 * dd_class(q1);
+        double q2 = r.hi / op2.hi;
+        r -= op2 * dd_class(q2);
+        double q3 = r.hi / op2.hi;
+        return dd_class(q1, q2, quick_tag()) + dd_class(q3);
+    }
+
+    friend bool operator==(const dd_class &op1, const dd_class &op2) { return op1.hi == op2.hi && op1.lo == op2.lo; }
+    friend bool operator!=(const dd_class &op1, const dd_class &op2) { return !(op1 == op2); }
+    friend bool operator<(const dd_class &op1, const dd_class &op2) { return op1.hi < op2.hi || (op1.hi == op2.hi && op1.lo < op2.lo); }
+    friend bool operator>(const dd_class &op1, const dd_class &op2) { return op2 < op1; }
+    friend bool operator<=(const dd_class &op1, const dd_class &op2) { return !(op2 < op1); }
+    friend bool operator>=(const dd_class &op1, const dd_class &op2) { return !(op1 < op2); }
+
+    friend dd_class abs(const dd_class &op) { return op.hi < 0.0 ? -op : op; }
+    friend int sgn(const dd_class &op) { return (op.hi > 0.0) - (op.hi < 0.0); }
+    // one Newton step on 1/sqrt(hi) (Karp and Markstein)
+    friend dd_class sqrt(const dd_class &op) {
+        if (op.hi <= 0.0)
+            return dd_class(std::sqrt(op.hi));
+        double x = 1.0 / std::sqrt(op.hi);
+        double ax = op.hi * x;
+        double p, e;
+        helper::dd_two_prod(ax, ax, p, e);
+        dd_class r = op - dd_class(p, e, raw_tag());
+        return dd_class(ax) + dd_class(r.hi * (x * 0.5));
+    }
+    friend std::ostream &operator<<(std::ostream &os, const dd_class &op) { return os << op.get_mpf_class(); }
+
+  private:
+    double hi, lo;
+    struct raw_tag {};
+    dd_class(double _hi, double _lo, raw_tag) noexcept : hi(_hi), lo(_lo) {}
+    // |_hi| >= |_lo|, which the arithmetic guarantees for its intermediate results
+    struct quick_tag {};
+    dd_class(double _hi, double _lo, quick_tag) noexcept { helper::dd_quick_two_sum(_hi, _lo, hi, lo); }
+    // values beyond the double range saturate to +-inf like a conversion to double
+    void set_mpf(mpf_srcptr op) {
+        hi = mpf_get_d(op);
+        lo = 0.0;
+        if (!std::isfinite(hi))
+            return;
+        mpf_class r(0UL, mpf_get_prec(op));
+        helper::mpf_double _hi(hi);
+        mpf_sub(r.get_mpf_t(), op, _hi.get_mpf_t());
+        double _lo = mpf_get_d(r.get_mpf_t());
+        helper::dd_quick_two_sum(hi, _lo, hi, lo);
+        // just below 2^1024 the rounded sum can still overflow
+        if (!std::isfinite(hi))
+            lo = 0.0;
+    }
+};
+
+// mpf_batch<Bits>: n floating point values of Bits <= 256 bits for elementwise kernels, stored limb-interleaved.
+// Values are grouped by 8 lanes; in a group, digit k of the 8 values is adjacent, followed by the signs and exponents.
+// A value is sign * 0.d[digits-1]...d[0] * 2^(32 exp) in 32 bit digits with d[digits-1] != 0, one guard digit
+// like mpf, and results are truncated. |exp| is at most mpf_batch_max_exp = 2^28 (binary exponents up to about
+// 2^33): set() throws std::range_error beyond it, results past it saturate to the largest exponent, and results
+// below it become zero. Every operation runs over the 8 lanes at once with selects instead of
+// branches: the multiplication as lane loops the compiler vectorizes, the addition on vector extension types.
+// On x86-64 the kernels are built for AVX-512, AVX2 and the baseline and the best one is picked at load time
+// (target_clones). Digits are 32 bits so that digit products fit 64 bit lanes.
+// Convert with set() and get(); batch_add, batch_mul, batch_fma, batch_axpy and batch_dot work on whole batches of
+// the same size.
+namespace helper {
+// small enough that the sum of two exponents and the exponent of zero (INT32_MIN / 4) in the addition cannot overflow
+constexpr int32_t mpf_batch_max_exp = 1 << 28;
+template <int D> struct alignas(64) mpf_batch_block {
+    static constexpr int lanes = 8;
+    uint32_t d[D][lanes];
+    int32_t sign[lanes];
+    int32_t exp[lanes];
+};
+// r = x * y
+template <int D> inline void mpf_batch_mul_block(mpf_batch_block<D> &r, const mpf_batch_block<D> &x, const mpf_batch_block<D> &y) {
+    constexpr int L = mpf_batch_block<D>::lanes;
+    uint32_t p[2 * D][L] = {};
+    for (int i = 0; i < D; i++) {
+        uint64_t carry[L] = {};
+        for (int j = 0; j < D; j++) {
+            for (int l = 0; l < L; l++) {
+                uint64_t t = static_cast<uint64_t>(x.d[i][l]) * y.d[j][l] + p[i + j][l] + carry[l];
+                p[i + j][l] = static_cast<uint32_t>(t);
+                carry[l] = t >> 32;
+            }
+        }
+        for (int l = 0; l < L; l++)
+            p[i + D][l] = static_cast<uint32_t>(carry[l]);
+    }
+    // the product of two normalized values has its leading digit at 2D-1 or 2D-2
+    int32_t top0[L];
+    for (int l = 0; l < L; l++)
+        top0[l] = p[2 * D - 1][l] == 0;
+    for (int k = 0; k < D; k++)
+        for (int l = 0; l < L; l++)
+            r.d[k][l] = top0[l] ? p[D - 1 + k][l] : p[D + k][l];
+    for (int l = 0; l < L; l++) {
+        int32_t exp = x.exp[l] + y.exp[l] - top0[l];
+        int32_t underflow = exp < -mpf_batch_max_exp;
+        r.sign[l] = underflow ? 0 : x.sign[l] * y.sign[l];
+        r.exp[l] = r.sign[l] == 0 ? 0 : std::min(exp, mpf_batch_max_exp);
+    }
+}
+// the 8 lanes of a digit row as one vector (GCC/clang vector extensions); comparisons give all-ones / all-zero masks
+// and a select is (a & m) | (b & ~m). Vectors are only local values, none is passed to or returned from a function.
+typedef uint32_t mpf_batch_u32x8 __attribute__((vector_size(32)));
+typedef int32_t mpf_batch_i32x8 __attribute__((vector_size(32)));
+// r = x + y, branch free over the lanes
+template <int D> inline void mpf_batch_add_block(mpf_batch_block<D> &r, const mpf_batch_block<D> &x, const mpf_batch_block<D> &y) {
+    using u32x8 = mpf_batch_u32x8;
+    using i32x8 = mpf_batch_i32x8;
+    const i32x8 zero_exp = i32x8{} + std::numeric_limits<int32_t>::min() / 4;
+    i32x8 xs, ys, xe, ye;
+    u32x8 xd[D], yd[D];
+    std::memcpy(&xs, x.sign, sizeof(i32x8));
+    std::memcpy(&ys, y.sign, sizeof(i32x8));
+    std::memcpy(&xe, x.exp, sizeof(i32x8));
+    std::memcpy(&ye, y.exp, sizeof(i32x8));
+    std::memcpy(xd, x.d, sizeof(xd));
+    std::memcpy(yd, y.d, sizeof(yd));
+    i32x8 ea = (zero_exp & (xs == 0)) | (xe & ~(xs == 0));
+    i32x8 eb = (zero_exp & (ys == 0)) | (ye & ~(ys == 0));
+    // a is the operand of larger magnitude, swap is set where that is y
+    i32x8 swap = eb > ea, undecided = eb == ea;
+    for (int k = D - 1; k >= 0; k--) {
+        swap |= undecided & (yd[k] > xd[k]);
+        undecided &= yd[k] == xd[k];
+    }
+    u32x8 uswap = (u32x8)swap;
+    i32x8 sign = (ys & swap) | (xs & ~swap);
+    i32x8 exp = (ye & swap) | (xe & ~swap);
+    i32x8 diff = ((eb - ea) & swap) | ((ea - eb) & ~swap);
+    i32x8 shift = ((i32x8{} + D) & (diff > D)) | (diff & ~(diff > D));
+    u32x8 sub = (u32x8)((xs ^ ys) < 0);
+    u32x8 a[D], b[D];
+    for (int k = 0; k < D; k++) {
+        a[k] = (yd[k] & uswap) | (xd[k] & ~uswap);
+        b[k] = (xd[k] & uswap) | (yd[k] & ~uswap);
+    }
+    // b shifted right by shift digits, one pass per bit of shift
+    for (int t = 1; t <= D; t <<= 1) {
+        u32x8 m = (u32x8)((shift & t) != 0);
+        for (int k = 0; k < D; k++)
+            b[k] = ((k + t < D ? b[k + t] : u32x8{}) & m) | (b[k] & ~m);
+    }
+    // a + b, or a + ~b + 1 = a - b, in D + 1 digits
+    u32x8 s_[D + 1], carry = sub & 1;
+    for (int k = 0; k < D; k++) {
+        u32x8 s1 = a[k] + (b[k] ^ sub);
+        u32x8 s2 = s1 + carry;
+        carry = ((u32x8)(s1 < a[k]) | (u32x8)(s2 < s1)) & 1;
+        s_[k] = s2;
+    }
+    s_[D] = carry & ~sub;
+    // z counts the leading zero digits of the sum: 0 on a carry out, 1 usually, more on cancellation
+    i32x8 z = {}, zero = i32x8{} - 1;
+    for (int k = D; k >= 0; k--) {
+        zero &= s_[k] == 0;
+        z -= zero;
+    }
+    u32x8 n_[D];
+    i32x8 carry_out = z == 0;
+    u32x8 ucarry_out = (u32x8)carry_out;
+    for (int k = 0; k < D; k++)
+        n_[k] = (s_[k + 1] & ucarry_out) | (s_[k] & ~ucarry_out);
+    // then z - 1 digits left
+    i32x8 w = (z - 1) & ~carry_out;
+    for (int t = 1; t <= D; t <<= 1) {
+        u32x8 m = (u32x8)((w & t) != 0);
+        for (int k = D - 1; k >= 0; k--)
+            n_[k] = ((k - t >= 0 ? n_[k - t] : u32x8{}) & m) | (n_[k] & ~m);
+    }
+    i32x8 nonzero = z <= D;
+    exp = exp + 1 - z;
+    // a carry out at the largest exponent saturates, cancellation below the smallest gives zero
+    i32x8 max_exp = i32x8{} + mpf_batch_max_exp;
+    exp = (max_exp & (exp > max_exp)) | (exp & ~(exp > max_exp));
+    nonzero &= exp >= -max_exp;
+    sign &= nonzero;
+    exp &= nonzero;
+    std::memcpy(r.d, n_, sizeof(n_));
+    std::memcpy(r.sign, &sign, sizeof(i32x8));
+    std::memcpy(r.exp, &exp, sizeof(i32x8));
+}
+template <int D> struct mpf_batch_kernels {
+    using block = mpf_batch_block<D>;
+    ___GMPXX_MKII_TARGET_CLONES___ static void add(block *r, const block *x, const block *y, std::size_t nblocks) {
+        for (std::size_t i = 0; i < nblocks; i++) {
+            block t;
+            mpf_batch_add_block(t, x[i], y[i]);
+            r[i] = t;
+        }
+    }
+    ___GMPXX_MKII_TARGET_CLONES___ static void mul(block *r, const block *x, const block *y, std::size_t nblocks) {
+        for (std::size_t i = 0; i < nblocks; i++) {
+            block t;
+            mpf_batch_mul_block(t, x[i], y[i]);
+            r[i] = t;
+        }
+    }
+    // r = x * y + w; x_stride 0 broadcasts x[0]
+    ___GMPXX_MKII_TARGET_CLONES___ static void fma(block *r, const block *x, std::size_t x_stride, const block *y, const block *w, std::size_t nblocks) {
+        for (std::size_t i = 0; i < nblocks; i++) {
+            block t;
+            mpf_batch_mul_block(t, x[i * x_stride], y[i]);
+            mpf_batch_add_block(t, t, w[i]);
+            r[i] = t;
+        }
+    }
+    // acc (one block) += x * y over all blocks
+    ___GMPXX_MKII_TARGET_CLONES___ static void dot(block &acc, const block *x, const block *y, std::size_t nblocks) {
+        for (std::size_t i = 0; i < nblocks; i++) {
+            block t;
+            mpf_batch_mul_block(t, x[i], y[i]);
+            mpf_batch_add_block(acc, acc, t);
+        }
+    }
+};
+} // namespace helper
+
+template <int Bits> class mpf_batch {
+    static_assert(Bits > 0 && Bits <= 256, "mpf_batch supports up to 256 bits");
+
+  public:
+    // Bits in whole digits after the leading one, which may hold a single bit
+    static constexpr int digits = (Bits + 31) / 32 + 1;
+    static constexpr std::size_t lanes = helper::mpf_batch_block<digits>::lanes;
+    using block = helper::mpf_batch_block<digits>;
+
+    explicit mpf_batch(std::size_t _n = 0) { resize(_n); }
+    void resize(std::size_t _n) {
+        n = _n;
+        blocks.assign((n + lanes - 1) / lanes, block{});
+    }
+    std::size_t size() const { return n; }
+    mp_bitcnt_t get_prec() const { return Bits; }
+    void set(std::size_t i, const mpf_class &op) {
+        block &b = blocks[i / lanes];
+        std::size_t l = i % lanes;
+        int size = op.get_mpf_t()->_mp_size;
+        for (int k = 0; k < digits; k++)
+            b.d[k][l] = 0;
+        b.sign[l] = (size > 0) - (size < 0);
+        b.exp[l] = 0;
+        if (size == 0)
+            return;
+        // the limbs as an integer, exported in 32 bit digits
+        mpz_t mantissa;
+        mpz_roinit_n(mantissa, op.get_mpf_t()->_mp_d, std::abs(size));
+        std::size_t count;
+        std::vector<uint32_t> tmp(std::abs(size) * (GMP_NUMB_BITS / 32) + 1);
+        mpz_export(tmp.data(), &count, -1, sizeof(uint32_t), 0, 0, mantissa);
+        for (int k = 0; k < digits && k < static_cast<int>(count); k++)
+            b.d[digits - 1 - k][l] = tmp[count - 1 - k];
+        long exp = static_cast<long>(count) + (GMP_NUMB_BITS / 32) * (op.get_mpf_t()->_mp_exp - std::abs(size));
+        if (exp > helper::mpf_batch_max_exp || exp < -helper::mpf_batch_max_exp) {
+            b.sign[l] = 0;
+            b.exp[l] = 0;
+            throw std::range_error("mpf_batch: exponent out of range");
+        }
+        b.exp[l] = static_cast<int32_t>(exp);
+    }
+    mpf_class get(std::size_t i) const {
+        const block &b = blocks[i / lanes];
+        std::size_t l = i % lanes;
+        mpf_class rop(0UL, Bits);
+        if (b.sign[l] == 0)
+            return rop;
+        uint32_t tmp[digits];
+        for (int k = 0; k < digits; k++)
+            tmp[k] = b.d[k][l];
+        mpz_class mantissa;
+        mpz_import(mantissa.get_mpz_t(), digits, -1, sizeof(uint32_t), 0, 0, tmp);
+        mpf_set_z(rop.get_mpf_t(), mantissa.get_mpz_t());
+        long e = 32L * (static_cast<long>(b.exp[l]) - digits);
+        if (e >= 0)
+            mpf_mul_2exp(rop.get_mpf_t(), rop.get_mpf_t(), static_cast<mp_bitcnt_t>(e));
+        else
+            mpf_div_2exp(rop.get_mpf_t(), rop.get_mpf_t(), static_cast<mp_bitcnt_t>(-e));
+        if (b.sign[l] < 0)
+            mpf_neg(rop.get_mpf_t(), rop.get_mpf_t());
+        return rop;
+    }
+    block *data() { return blocks.data(); }
+    const block *data() const { return blocks.data(); }
+    std::size_t nblocks() const { return blocks.size(); }
+
+  private:
+    std::size_t n;
+    std::vector<block> blocks;
+};
+// z = x + y
+template <int Bits> inline void batch_add(mpf_batch<Bits> &z, const mpf_batch<Bits> &x, const mpf_batch<Bits> &y) {
+    assert(x.size() == y.size() && z.size() == x.size());
+    helper::mpf_batch_kernels<mpf_batch<Bits>::digits>::add(z.data(), x.data(), y.data(), x.nblocks());
+}
+// z = x * y
+template <int Bits> inline void batch_mul(mpf_batch<Bits> &z, const mpf_batch<Bits> &x, const mpf_batch<Bits> &y) {
+    assert(x.size() == y.size() && z.size() == x.size());
+    helper::mpf_batch_kernels<mpf_batch<Bits>::digits>::mul(z.data(), x.data(), y.data(), x.nblocks());
+}
+// z = x * y + w
+template <int Bits> inline void batch_fma(mpf_batch<Bits> &z, const mpf_batch<Bits> &x, const mpf_batch<Bits> &y, const mpf_batch<Bits> &w) {
+    assert(x.size() == y.size() && w.size() == x.size() && z.size() == x.size());
+    helper::mpf_batch_kernels<mpf_batch<Bits>::digits>::fma(z.data(), x.data(), 1, y.data(), w.data(), x.nblocks());
+}
+// y = alpha * x + y
+template <int Bits> inline void batch_axpy(const mpf_class &alpha, const mpf_batch<Bits> &x, mpf_batch<Bits> &y) {
+    assert(x.size() == y.size());
+    mpf_batch<Bits> _alpha(mpf_batch<Bits>::lanes);
+    for (std::size_t l = 0; l < mpf_batch<Bits>::lanes; l++)
+        _alpha.set(l, alpha);
+    helper::mpf_batch_kernels<mpf_batch<Bits>::digits>::fma(y.data(), _alpha.data(), 0, x.data(), y.data(), x.nblocks());
+}
+// sum of x[i] * y[i]; each lane accumulates its own partial sum, the 8 partial sums are added with mpf_add
+template <int Bits> inline mpf_class batch_dot(const mpf_batch<Bits> &x, const mpf_batch<Bits> &y) {
+    assert(x.size() == y.size());
+    mpf_batch<Bits> acc(mpf_batch<Bits>::lanes);
+    helper::mpf_batch_kernels<mpf_batch<Bits>::digits>::dot(acc.data()[0], x.data(), y.data(), x.nblocks());
+    mpf_class rop(0UL, Bits);
+    for (std::size_t l = 0; l < mpf_batch<Bits>::lanes; l++)
+        rop += acc.get(l);
+    return rop;
+}
+
+// mpfx<IntBits, FracBits>: a fixed-point number on raw mpn limbs, for data of known bounded range such as matrices
+// filled in [0, 1). The value is a two's complement integer of `limbs` limbs (at least IntBits + FracBits + 1 bits)
+// scaled by 2^-FracBits. + and - are one mpn_add_n / mpn_sub_n and wrap around on overflow like integer types;
+// * is mpn_mul_n on the magnitudes and a shift by FracBits that truncates toward zero or, with
+// mpfx_rounding::nearest, rounds half away from zero. There is no exponent, no normalization and no allocation.
+enum class mpfx_rounding { truncate, nearest };
+template <int IntBits, int FracBits, mpfx_rounding Rounding = mpfx_rounding::truncate> class mpfx {
+    static_assert(IntBits >= 0 && FracBits >= 0 && IntBits + FracBits > 0, "mpfx needs a positive width");
+
+  public:
+    static constexpr int limbs = (IntBits + FracBits + 1 + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS;
+    static constexpr int frac_bits = FracBits;
+
+    mpfx() noexcept { std::fill(d, d + limbs, mp_limb_t(0)); }
+    mpfx(signed long int op) { set_f(mpf_class(op).get_mpf_t()); }
+    mpfx(signed int op) : mpfx(static_cast<signed long int>(op)) {}
+    mpfx(double op) {
+        helper::mpf_double _op(op);
+        set_f(_op.get_mpf_t());
+    }
+    explicit mpfx(const mpf_class &op) { set_f(op.get_mpf_t()); }
+    explicit mpfx(const mpf_t op) { set_f(op); }
+
+    explicit operator mpf_class() const { return get_mpf_class(); }
+    mpf_class get_mpf_class(mp_bitcnt_t prec = IntBits + FracBits) const {
+        mp_limb_t u[limbs];
+        bool neg = negative();
+        if (neg)
+            mpn_neg(u, d, limbs);
+        else
+            std::copy(d, d + limbs, u);
+        mpz_t z;
+        mpz_roinit_n(z, u, limbs);
+        mpf_class rop(0UL, prec);
+        mpf_set_z(rop.get_mpf_t(), z);
+        mpf_div_2exp(rop.get_mpf_t(), rop.get_mpf_t(), FracBits);
+        if (neg)
+            mpf_neg(rop.get_mpf_t(), rop.get_mpf_t());
+        return rop;
+    }
+    double get_d() const { return get_mpf_class(64).get_d(); }
+    mp_srcptr get_limbs() const { return d; }
+    mp_ptr get_limbs() { return d; }
+
+    mpfx &operator+=(const mpfx &op) {
+        mpn_add_n(d, d, op.d, limbs);
+        return *this;
+    }
+    mpfx &operator-=(const mpfx &op) {
+        mpn_sub_n(d, d, op.d, limbs);
+        return *this;
+    }
+    mpfx &operator*=(const mpfx &op) { return *this = *this * op; }
+    friend mpfx operator+(const mpfx &op1, const mpfx &op2) {
+        mpfx rop{uninitialized{}};
+        mpn_add_n(rop.d, op1.d, op2.d, limbs);
+        return rop;
+    }
+    friend mpfx operator-(const mpfx &op1, const mpfx &op2) {
+        mpfx rop{uninitialized{}};
+        mpn_sub_n(rop.d, op1.d, op2.d, limbs);
+        return rop;
+    }
+    friend mpfx operator-(const mpfx &op) {
+        mpfx rop{uninitialized{}};
+        mpn_neg(rop.d, op.d, limbs);
+        return rop;
+    }
+    friend mpfx operator+(const mpfx &op) { return op; }
+    friend mpfx operator*(const mpfx &op1, const mpfx &op2) {
+        mp_limb_t u1[limbs], u2[limbs], p[2 * limbs];
+        bool neg1 = op1.negative(), neg2 = op2.negative();
+        mp_srcptr s1 = op1.d, s2 = op2.d;
+        if (neg1) {
+            mpn_neg(u1, op1.d, limbs);
+            s1 = u1;
+        }
+        if (&op1 == &op2) {
+            mpn_sqr(p, s1, limbs);
+        } else {
+            if (neg2) {
+                mpn_neg(u2, op2.d, limbs);
+                s2 = u2;
+            }
+            mpn_mul_n(p, s1, s2, limbs);
+        }
+        constexpr int offset = FracBits / GMP_NUMB_BITS, shift = FracBits % GMP_NUMB_BITS;
+        if constexpr (Rounding == mpfx_rounding::nearest && FracBits > 0) {
+            constexpr int half = (FracBits - 1) / GMP_NUMB_BITS;
+            mpn_add_1(p + half, p + half, 2 * limbs - half, mp_limb_t(1) << ((FracBits - 1) % GMP_NUMB_BITS));
+        }
+        mpfx rop{uninitialized{}};
+        if constexpr (shift != 0) {
+            mpn_rshift(p + offset, p + offset, limbs + 1, shift);
+        }
+        std::copy(p + offset, p + offset + limbs, rop.d);
+        if (neg1 != (&op1 == &op2 ? neg1 : neg2))
+            mpn_neg(rop.d, rop.d, limbs);
+        return rop;
+    }
+
+    friend bool operator==(const mpfx &op1, const mpfx &op2) { return mpn_cmp(op1.d, op2.d, limbs) == 0; }
+    friend bool operator!=(const mpfx &op1, const mpfx &op2) { return !(op1 == op2); }
+    // two's complement values of the same sign compare like their limbs
+    friend bool operator<(const mpfx &op1, const mpfx &op2) {
+        bool neg1 = op1.negative(), neg2 = op2.negative();
+        return neg1 != neg2 ? neg1 : mpn_cmp(op1.d, op2.d, limbs) < 0;
+    }
+    friend bool operator>(const mpfx &op1, const mpfx &op2) { return op2 < op1; }
+    friend bool operator<=(const mpfx &op1, const mpfx &op2) { return !(op2 < op1); }
+    friend bool operator>=(const mpfx &op1, const mpfx &op2) { return !(op1 < op2); }
+    friend int sgn(const mpfx &op) { return op.negative() ? -1 : !mpn_zero_p(op.d, limbs); }
+    friend mpfx abs(const mpfx &op) { return op.negative() ? -op : op; }
+    friend std::ostream &operator<<(std::ostream &os, const mpfx &op) { return os << op.get_mpf_class(); }
+
+  private:
+    mp_limb_t d[limbs];
+    struct uninitialized {};
+    explicit mpfx(uninitialized) noexcept {}
+    bool negative() const { return (d[limbs - 1] >> (GMP_NUMB_BITS - 1)) != 0; }
+    // truncates op * 2^FracBits toward zero and wraps it to limbs limbs
+    void set_f(mpf_srcptr op) {
+        mpf_class scaled(op, mpf_get_prec(op) + FracBits);
+        mpf_mul_2exp(scaled.get_mpf_t(), scaled.get_mpf_t(), FracBits);
+        mpz_class z(scaled.get_mpf_t());
+        mpz_srcptr _z = z.get_mpz_t();
+        for (int i = 0; i < limbs; i++)
+            d[i] = mpz_getlimbn(_z, i);
+        if (mpz_sgn(_z) < 0)
+            mpn_neg(d, d, limbs);
+    }
+};
+
+// mpz_view, mpf_view: non-owning read-only operands over limbs that live elsewhere, e.g. uint64 arrays received
+// from other components. Nothing is copied or allocated; the limbs must outlive the view and stay unchanged.
+// A view holds its mpz_class / mpf_class privately and converts only to a const reference of it, so it works with
+// every operator and function taking a const mpz_class& / const mpf_class&, while anything that writes through a
+// non-const reference (assignment, operator>>, swap, set_prec, ...) does not compile. Copying the value out of a view,
+// mpf_class m = v, copies the limbs.
+class mpz_view {
+  public:
+    // n limbs, least significant first; a negative n makes the value negative, as with mpz_roinit_n
+    mpz_view(const mp_limb_t *d, mp_size_t n) noexcept : value(mpz_class::roinit_tag{}, d, n) {}
+    mpz_view(const mpz_view &op) noexcept : value(mpz_class::roinit_tag{}, op.get_mpz_t()->_mp_d, op.get_mpz_t()->_mp_size) {}
+    mpz_view &operator=(const mpz_view &) = delete;
+    operator const mpz_class &() const noexcept { return value; }
+    mpz_srcptr get_mpz_t() const { return value.get_mpz_t(); }
+
+  private:
+    mpz_class value;
+};
+
+class mpf_view {
+  public:
+    // value = sign(n) 0.d[|n|-1] ... d[0] * 2^(GMP_NUMB_BITS * exp), the mpf layout; the precision taken by
+    // results, as for any mpf_class operand, is prec, by default all |n| limbs
+    mpf_view(const mp_limb_t *d, mp_size_t n, mp_exp_t exp, mp_bitcnt_t prec = 0) noexcept : value(mpf_class::roinit_tag{}, d, n, exp, prec != 0 ? prec : static_cast<mp_bitcnt_t>(std::abs(n)) * GMP_NUMB_BITS) {}
+    mpf_view(const mpf_view &op) noexcept : value(mpf_class::roinit_tag{}, op.get_mpf_t()->_mp_d, op.get_mpf_t()->_mp_size, op.get_mpf_t()->_mp_exp, op.get_prec()) {}
+    // the limbs are released to their owner
+    ~mpf_view() { value.get_mpf_t()->_mp_d = nullptr; }
+    mpf_view &operator=(const mpf_view &) = delete;
+    operator const mpf_class &() const noexcept { return value; }
+    mpf_srcptr get_mpf_t() const { return value.get_mpf_t(); }
+    mp_bitcnt_t get_prec() const { return value.get_prec(); }
+
+  private:
+    mpf_class value;
+};
+
+// the operators of mpz_class / mpf_class are friends found through their operands, so the views forward them
+#define GMPXX_VIEW_MIXED_OPERATOR(view, base, op)                                                                                                \
+    template <typename T> inline auto operator op(const view &a, const T &b)->decltype(static_cast<const base &>(a) op b) { return static_cast<const base &>(a) op b; } \
+    template <typename T> inline auto operator op(const T &a, const view &b)->decltype(a op static_cast<const base &>(b)) { return a op static_cast<const base &>(b); }
+#define GMPXX_VIEW_BINARY_OPERATOR(view, base, op)                                                                                               \
+    GMPXX_VIEW_MIXED_OPERATOR(view, base, op)                                                                                                     \
+    inline auto operator op(const view &a, const view &b) { return static_cast<const base &>(a) op static_cast<const base &>(b); }
+#define GMPXX_VIEW_OPERATORS(view, base)                                                                                                          \
+    GMPXX_VIEW_BINARY_OPERATOR(view, base, +)                                                                                                     \
+    GMPXX_VIEW_BINARY_OPERATOR(view, base, -)                                                                                                     \
+    GMPXX_VIEW_BINARY_OPERATOR(view, base, *)                                                                                                     \
+    GMPXX_VIEW_BINARY_OPERATOR(view, base, /)                                                                                                     \
+    GMPXX_VIEW_MIXED_OPERATOR(view, base, <<)                                                                                                     \
+    GMPXX_VIEW_MIXED_OPERATOR(view, base, >>)                                                                                                     \
+    GMPXX_VIEW_BINARY_OPERATOR(view, base, ==)                                                                                                    \
+    GMPXX_VIEW_BINARY_OPERATOR(view, base, !=)                                                                                                    \
+    GMPXX_VIEW_BINARY_OPERATOR(view, base, <)                                                                                                     \
+    GMPXX_VIEW_BINARY_OPERATOR(view, base, >)                                                                                                     \
+    GMPXX_VIEW_BINARY_OPERATOR(view, base, <=)                                                                                                    \
+    GMPXX_VIEW_BINARY_OPERATOR(view, base, >=)                                                                                                    \
+    inline auto operator-(const view &a) { return -static_cast<const base &>(a); }                                                                \
+    inline auto operator+(const view &a) { return +static_cast<const base &>(a); }
+GMPXX_VIEW_OPERATORS(mpz_view, mpz_class)
+GMPXX_VIEW_BINARY_OPERATOR(mpz_view, mpz_class, %)
+GMPXX_VIEW_BINARY_OPERATOR(mpz_view, mpz_class, &)
+GMPXX_VIEW_BINARY_OPERATOR(mpz_view, mpz_class, |)
+GMPXX_VIEW_BINARY_OPERATOR(mpz_view, mpz_class, ^)
+inline auto operator~(const mpz_view &a) { return ~static_cast<const mpz_class &>(a); }
+GMPXX_VIEW_OPERATORS(mpf_view, mpf_class)
+// an mpf_view with an mpz_view, or a view with mpq_class, matches both mixed templates above (and the operator
+// templates of mpq_class), so these pairs get non-template overloads
+#define GMPXX_VIEW_CROSS_OPERATOR(a_type, a_base, b_type, b_base, op)                                                                            \
+    inline auto operator op(const a_type &a, const b_type &b) { return static_cast<const a_base &>(a) op static_cast<const b_base &>(b); }     \
+    inline auto operator op(const b_type &a, const a_type &b) { return static_cast<const b_base &>(a) op static_cast<const a_base &>(b); }
+#define GMPXX_VIEW_CROSS_OPERATORS(a_type, a_base, b_type, b_base)                                                                                \
+    GMPXX_VIEW_CROSS_OPERATOR(a_type, a_base, b_type, b_base, +)                                                                                 \
+    GMPXX_VIEW_CROSS_OPERATOR(a_type, a_base, b_type, b_base, -)                                                                                 \
+    GMPXX_VIEW_CROSS_OPERATOR(a_type, a_base, b_type, b_base, *)                                                                                 \
+    GMPXX_VIEW_CROSS_OPERATOR(a_type, a_base, b_type, b_base, /)                                                                                 \
+    GMPXX_VIEW_CROSS_OPERATOR(a_type, a_base, b_type, b_base, ==)                                                                                \
+    GMPXX_VIEW_CROSS_OPERATOR(a_type, a_base, b_type, b_base, !=)                                                                                \
+    GMPXX_VIEW_CROSS_OPERATOR(a_type, a_base, b_type, b_base, <)                                                                                 \
+    GMPXX_VIEW_CROSS_OPERATOR(a_type, a_base, b_type, b_base, >)                                                                                 \
+    GMPXX_VIEW_CROSS_OPERATOR(a_type, a_base, b_type, b_base, <=)                                                                                \
+    GMPXX_VIEW_CROSS_OPERATOR(a_type, a_base, b_type, b_base, >=)
+GMPXX_VIEW_CROSS_OPERATORS(mpf_view, mpf_class, mpz_view, mpz_class)
+GMPXX_VIEW_CROSS_OPERATORS(mpz_view, mpz_class, mpq_class, mpq_class)
+GMPXX_VIEW_CROSS_OPERATORS(mpf_view, mpf_class, mpq_class, mpq_class)
+#undef GMPXX_VIEW_CROSS_OPERATORS
+#undef GMPXX_VIEW_CROSS_OPERATOR
+#undef GMPXX_VIEW_OPERATORS
+#undef GMPXX_VIEW_BINARY_OPERATOR
+#undef GMPXX_VIEW_MIXED_OPERATOR
+inline mpz_class::mpz_class(const mpf_view &op) : mpz_class(op.get_mpf_t()) {}
+inline mpq_class::mpq_class(const mpf_view &op) : mpq_class(op.get_mpf_t()) {}
+inline mpf_class::mpf_class(const mpz_view &op) noexcept : mpf_class(op.get_mpz_t()) {}
+
+// mpf_bfp_matrix: block floating point storage of an m x n matrix. Each tile x tile block shares one exponent e
+// with |a_ij| < 2^e for all its elements and stores fixed width two's complement mantissas M_ij = a_ij * 2^(N-1-e),
+// truncated, of limbs() limbs (N bits) each, column major in one contiguous slab per tile.
+// gemm() multiplies on the mantissas with mpn_mul_n and mpn_add / mpn_sub into wide accumulators: the products of
+// one tile pair share the scale 2^(eA + eB), so the only alignment is one shift of an A tile per tile pair and the only
+// normalization is when the accumulated C tile is written back with its new shared exponent.
+// The precision of an element is relative to the largest element of its tile rather than to itself.
+class mpf_bfp_matrix {
+  public:
+    mpf_bfp_matrix(std::size_t _m, std::size_t _n, mp_bitcnt_t _prec = mpf_get_default_prec(), std::size_t _tile = 64) : m(_m), n(_n), tile(_tile), nlimbs(static_cast<int>((_prec + 1 + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS)) {
+        mt = (m + tile - 1) / tile;
+        nt = (n + tile - 1) / tile;
+        exps.assign(mt * nt, zero_exp);
+        slab.assign(mt * nt * tile * tile * nlimbs, 0);
+    }
+    explicit mpf_bfp_matrix(const mpf_matrix &a, std::size_t _tile = 64) : mpf_bfp_matrix(a.rows(), a.cols(), a.get_prec(), _tile) { set(a); }
+    std::size_t rows() const { return m; }
+    std::size_t cols() const { return n; }
+    std::size_t tile_size() const { return tile; }
+    int limbs() const { return nlimbs; }
+    mp_bitcnt_t get_prec() const { return static_cast<mp_bitcnt_t>(nlimbs) * GMP_NUMB_BITS - 1; }
+    // the shared exponent of tile (ti, tj); tiles of zeros have none
+    bool tile_is_zero(std::size_t ti, std::size_t tj) const { return exps[ti + tj * mt] == zero_exp; }
+    long tile_exp(std::size_t ti, std::size_t tj) const { return exps[ti + tj * mt]; }
+
+    void set(const mpf_matrix &a) {
+        assert(a.rows() == m && a.cols() == n);
+        mpf_class scaled(0UL, get_prec() + 1);
+        mpz_class z;
+        for (std::size_t tj = 0; tj < nt; tj++) {
+            for (std::size_t ti = 0; ti < mt; ti++) {
+                long e = zero_exp;
+                for_each_in_tile(ti, tj, [&](std::size_t i, std::size_t j, mp_ptr) {
+                    if (mpf_sgn(a(i, j).get_mpf_t()) != 0) {
+                        long exp;
+                        mpf_get_d_2exp(&exp, a(i, j).get_mpf_t());
+                        e = std::max(e, exp);
+                    }
+                });
+                exps[ti + tj * mt] = e;
+                long shift = static_cast<long>(nbits()) - 1 - e;
+                for_each_in_tile(ti, tj, [&](std::size_t i, std::size_t j, mp_ptr d) {
+                    if (e == zero_exp)
+                        return;
+                    if (shift >= 0)
+                        mpf_mul_2exp(scaled.get_mpf_t(), a(i, j).get_mpf_t(), static_cast<mp_bitcnt_t>(shift));
+                    else
+                        mpf_div_2exp(scaled.get_mpf_t(), a(i, j).get_mpf_t(), static_cast<mp_bitcnt_t>(-shift));
+                    mpz_set_f(z.get_mpz_t(), scaled.get_mpf_t());
+                    for (int k = 0; k < nlimbs; k++)
+                        d[k] = mpz_getlimbn(z.get_mpz_t(), k);
+                    if (mpz_sgn(z.get_mpz_t()) < 0)
+                        mpn_neg(d, d, nlimbs);
+                });
+            }
+        }
+    }
+    void get(mpf_matrix &a) const {
+        assert(a.rows() == m && a.cols() == n);
+        for (std::size_t j = 0; j < n; j++)
+            for (std::size_t i = 0; i < m; i++)
+                get(i, j, a(i, j).get_mpf_t());
+    }
+    mpf_class get(std::size_t i, std::size_t j) const {
+        mpf_class rop(0UL, get_prec());
+        get(i, j, rop.get_mpf_t());
+        return rop;
+    }
+    void get(std::size_t i, std::size_t j, mpf_ptr rop) const {
+        long e = exps[i / tile + (j / tile) * mt];
+        if (e == zero_exp) {
+            mpf_set_ui(rop, 0);
+            return;
+        }
+        mp_srcptr d = element(i, j);
+        bool neg = (d[nlimbs - 1] >> (GMP_NUMB_BITS - 1)) != 0;
+        std::vector<mp_limb_t> u(d, d + nlimbs);
+        if (neg)
+            mpn_neg(u.data(), d, nlimbs);
+        mpz_t z;
+        mpz_roinit_n(z, u.data(), nlimbs);
+        mpf_set_z(rop, z);
+        long shift = e - static_cast<long>(nbits()) + 1;
+        if (shift >= 0)
+            mpf_mul_2exp(rop, rop, static_cast<mp_bitcnt_t>(shift));
+        else
+            mpf_div_2exp(rop, rop, static_cast<mp_bitcnt_t>(-shift));
+        if (neg)
+            mpf_neg(rop, rop);
+    }
+    mp_srcptr element(std::size_t i, std::size_t j) const { return slab.data() + tile_offset(i / tile, j / tile) + ((i % tile) + (j % tile) * tile) * nlimbs; }
+    mp_ptr element(std::size_t i, std::size_t j) { return slab.data() + tile_offset(i / tile, j / tile) + ((i % tile) + (j % tile) * tile) * nlimbs; }
+
+    // C = A * B
+    friend void gemm(mpf_bfp_matrix &C, const mpf_bfp_matrix &A, const mpf_bfp_matrix &B) {
+        assert(A.n == B.m && C.m == A.m && C.n == B.n);
+        assert(A.tile == B.tile && C.tile == A.tile && A.nlimbs == B.nlimbs && C.nlimbs == A.nlimbs);
+        const std::size_t T = A.tile, kt = A.nt;
+        const int W = A.nlimbs, W2 = 2 * W + 1;
+        const long N = static_cast<long>(A.nbits());
+        // magnitudes and signs, so that each product is one mpn_mul_n
+        std::vector<mp_limb_t> magA, magB;
+        std::vector<signed char> sgnA, sgnB;
+        A.magnitudes(magA, sgnA);
+        B.magnitudes(magB, sgnB);
+        std::vector<mp_limb_t> acc(T * T * W2), shifted(T * T * W), p(2 * W);
+        for (std::size_t tj = 0; tj < C.nt; tj++) {
+            for (std::size_t ti = 0; ti < C.mt; ti++) {
+                long E = zero_exp;
+                for (std::size_t tl = 0; tl < kt; tl++)
+                    if (!A.tile_is_zero(ti, tl) && !B.tile_is_zero(tl, tj))
+                        E = std::max(E, A.tile_exp(ti, tl) + B.tile_exp(tl, tj));
+                std::fill(acc.begin(), acc.end(), 0);
+                for (std::size_t tl = 0; tl < kt && E != zero_exp; tl++) {
+                    if (A.tile_is_zero(ti, tl) || B.tile_is_zero(tl, tj))
+                        continue;
+                    // align the A tile to the scale 2^E of the accumulators
+                    long s = E - (A.tile_exp(ti, tl) + B.tile_exp(tl, tj));
+                    if (s >= N)
+                        continue;
+                    mp_srcptr a = magA.data() + A.tile_offset(ti, tl);
+                    if (s > 0) {
+                        std::size_t offset = static_cast<std::size_t>(s / GMP_NUMB_BITS);
+                        unsigned bits = static_cast<unsigned>(s % GMP_NUMB_BITS);
+                        for (std::size_t e = 0; e < T * T; e++) {
+                            mp_srcptr src = a + e * W;
+                            mp_ptr dst = shifted.data() + e * W;
+                            if (bits != 0)
+                                mpn_rshift(dst, src + offset, W - offset, bits);
+                            else
+                                std::copy(src + offset, src + W, dst);
+                            std::fill(dst + (W - offset), dst + W, 0);
+                        }
+                        a = shifted.data();
+                    }
+                    const signed char *sa = sgnA.data() + A.tile_offset(ti, tl) / W, *sb = sgnB.data() + B.tile_offset(tl, tj) / W;
+                    mp_srcptr b = magB.data() + B.tile_offset(tl, tj);
+                    for (std::size_t c = 0; c < T; c++) {
+                        for (std::size_t l = 0; l < T; l++) {
+                            if (sb[l + c * T] == 0)
+                                continue;
+                            for (std::size_t r = 0; r < T; r++) {
+                                if (sa[r + l * T] == 0)
+                                    continue;
+                                mpn_mul_n(p.data(), a + (r + l * T) * W, b + (l + c * T) * W, W);
+                                mp_ptr dst = acc.data() + (r + c * T) * W2;
+                                if (sa[r + l * T] == sb[l + c * T])
+                                    mpn_add(dst, dst, W2, p.data(), 2 * W);
+                                else
+                                    mpn_sub(dst, dst, W2, p.data(), 2 * W);
+                            }
+                        }
+                    }
+                }
+                C.store_tile(ti, tj, acc, E - 2 * N + 2);
+            }
+        }
+    }
+
+  private:
+    static constexpr long zero_exp = std::numeric_limits<long>::min() / 4;
+    std::size_t m, n, tile, mt, nt;
+    int nlimbs;
+    std::vector<long> exps;
+    std::vector<mp_limb_t> slab;
+    mp_bitcnt_t nbits() const { return static_cast<mp_bitcnt_t>(nlimbs) * GMP_NUMB_BITS; }
+    std::size_t tile_offset(std::size_t ti, std::size_t tj) const { return (ti + tj * mt) * tile * tile * nlimbs; }
+    // f(i, j, mantissa) over the elements of tile (ti, tj) that lie inside the matrix
+    template <typename F> void for_each_in_tile(std::size_t ti, std::size_t tj, F f) {
+        for (std::size_t j = tj * tile; j < std::min(n, (tj + 1) * tile); j++)
+            for (std::size_t i = ti * tile; i < std::min(m, (ti + 1) * tile); i++)
+                f(i, j, element(i, j));
+    }
+    void magnitudes(std::vector<mp_limb_t> &mag, std::vector<signed char> &sign) const {
+        mag.resize(slab.size());
+        sign.resize(slab.size() / nlimbs);
+        for (std::size_t e = 0; e < sign.size(); e++) {
+            mp_srcptr d = slab.data() + e * nlimbs;
+            mp_ptr u = mag.data() + e * nlimbs;
+            bool neg = (d[nlimbs - 1] >> (GMP_NUMB_BITS - 1)) != 0;
+            if (neg)
+                mpn_neg(u, d, nlimbs);
+            else
+                std::copy(d, d + nlimbs, u);
+            sign[e] = neg ? -1 : !mpn_zero_p(d, nlimbs);
+        }
+    }
+    // writes 2 * limbs() + 1 limb accumulators of scale 2^scale as tile (ti, tj) with a new shared exponent
+    void store_tile(std::size_t ti, std::size_t tj, std::vector<mp_limb_t> &acc, long scale) {
+        const int W = nlimbs, W2 = 2 * W + 1;
+        const std::size_t count = tile * tile;
+        std::vector<signed char> neg(count);
+        long bits = 0;
+        for (std::size_t e = 0; e < count; e++) {
+            mp_ptr a = acc.data() + e * W2;
+            neg[e] = (a[W2 - 1] >> (GMP_NUMB_BITS - 1)) != 0;
+            if (neg[e])
+                mpn_neg(a, a, W2);
+            mp_size_t size = W2;
+            while (size > 0 && a[size - 1] == 0)
+                size--;
+            if (size > 0)
+                bits = std::max(bits, static_cast<long>(mpn_sizeinbase(a, size, 2)));
+        }
+        mp_ptr d = slab.data() + tile_offset(ti, tj);
+        if (bits == 0) {
+            exps[ti + tj * mt] = zero_exp;
+            std::fill(d, d + count * W, 0);
+            return;
+        }
+        // |acc| < 2^bits, so the mantissas acc * 2^(N - 1 - bits) fit N - 1 bits
+        exps[ti + tj * mt] = bits + scale;
+        long shift = bits - (static_cast<long>(nbits()) - 1);
+        std::vector<mp_limb_t> t(W2 + 1);
+        for (std::size_t e = 0; e < count; e++) {
+            mp_ptr a = acc.data() + e * W2, out = d + e * W;
+            if (shift > 0) {
+                std::size_t offset = static_cast<std::size_t>(shift / GMP_NUMB_BITS);
+                unsigned sbits = static_cast<unsigned>(shift % GMP_NUMB_BITS);
+                if (sbits != 0)
+                    mpn_rshift(t.data(), a + offset, W2 - offset, sbits);
+                else
+                    std::copy(a + offset, a + W2, t.data());
+                std::copy(t.data(), t.data() + W, out);
+            } else {
+                std::size_t offset = static_cast<std::size_t>(-shift / GMP_NUMB_BITS);
+                unsigned sbits = static_cast<unsigned>(-shift % GMP_NUMB_BITS);
+                std::fill(t.begin(), t.end(), 0);
+                if (sbits != 0)
+                    t[offset + W] = mpn_lshift(t.data() + offset, a, W, sbits);
+                else
+                    std::copy(a, a + W, t.data() + offset);
+                std::copy(t.data(), t.data() + W, out);
+            }
+            if (neg[e])
+                mpn_neg(out, out, W);
+        }
+    }
+};
+
+// convert: bulk conversion between arrays of double, float, int64_t, uint64_t, (unsigned) __int128, __float128 and
+// mpf_vector / mpf_matrix. The limbs are written straight from the IEEE bit patterns and integer words into the
+// storage the elements already have (every mpf has room for three limbs), so there is no mpf_set_d call and no
+// reallocation per element; the elements are visited by parallel_static_for, the loop that placed them.
+// Values are stored exactly, like mpf_set_d. To floating point the value is truncated toward zero, like mpf_get_d,
+// with infinity past the largest finite value; to integers the integer part is truncated to the low 64 or 128 bits,
+// like mpf_get_si / mpf_get_ui. NaN and infinity throw std::domain_error (mpf_set_d would trap).
+// With C++20 the same functions take std::span. Needs 64 bit limbs without nails.
+#if GMP_NUMB_BITS == 64 && GMP_NAIL_BITS == 0
+namespace helper {
+// rop = +-0.d[n-1] ... d[0] * 2^(64 exp), n <= 3
+inline void mpf_set_limbs(mpf_ptr rop, bool negative, const mp_limb_t *d, int n, mp_exp_t exp) {
+    assert(rop->_mp_prec + 1 >= n);
+    while (n > 0 && d[n - 1] == 0) {
+        n--;
+        exp--;
+    }
+    while (n > 0 && d[0] == 0) {
+        d++;
+        n--;
+    }
+    for (int i = 0; i < n; i++)
+        rop->_mp_d[i] = d[i];
+    rop->_mp_size = negative ? -n : n;
+    rop->_mp_exp = n == 0 ? 0 : exp;
+}
+// rop = +-magnitude * 2^exp2
+inline void mpf_set_binary(mpf_ptr rop, bool negative, unsigned __int128 magnitude, long exp2) {
+    long q = exp2 >= 0 ? exp2 / 64 : -((-exp2 + 63) / 64);
+    unsigned r = static_cast<unsigned>(exp2 - 64 * q);
+    unsigned __int128 upper = r == 0 ? magnitude >> 64 : magnitude >> (64 - r);
+    mp_limb_t d[3] = {static_cast<mp_limb_t>(magnitude << r), static_cast<mp_limb_t>(upper), static_cast<mp_limb_t>(upper >> 64)};
+    mpf_set_limbs(rop, negative, d, 3, q + 3);
+}
+// IEEE binary formats held in the unsigned integer type U
+template <typename U, int MantBits, int ExpBits> bool mpf_set_ieee(mpf_ptr rop, U bits) {
+    constexpr long bias = (1L << (ExpBits - 1)) - 1;
+    const U mask = (U(1) << MantBits) - 1;
+    bool negative = (bits >> (MantBits + ExpBits)) != 0;
+    long e = static_cast<long>((bits >> MantBits) & ((U(1) << ExpBits) - 1));
+    U mantissa = bits & mask;
+    if (e == (1L << ExpBits) - 1)
+        return false;
+    if (e == 0)
+        mpf_set_binary(rop, negative, mantissa, 1 - bias - MantBits);
+    else
+        mpf_set_binary(rop, negative, mantissa | (U(1) << MantBits), e - bias - MantBits);
+    return true;
+}
+template <typename U, int MantBits, int ExpBits> U mpf_get_ieee(mpf_srcptr op) {
+    constexpr long bias = (1L << (ExpBits - 1)) - 1;
+    int size = std::abs(op->_mp_size);
+    if (size == 0)
+        return 0;
+    const mp_limb_t *d = op->_mp_d;
+    mp_limb_t top = d[size - 1], next = size >= 2 ? d[size - 2] : 0, next2 = size >= 3 ? d[size - 3] : 0;
+    int lz = __builtin_clzll(top);
+    unsigned __int128 leading = (static_cast<unsigned __int128>(top) << 64) | next;
+    if (lz != 0)
+        leading = (leading << lz) | (next2 >> (64 - lz));
+    // |op| in [2^E, 2^(E + 1)), the leading bit kept as the implicit one
+    long E = 64 * op->_mp_exp - 1 - lz;
+    U mantissa = static_cast<U>(leading >> (127 - MantBits)), bits;
+    if (E > bias)
+        bits = static_cast<U>(((U(1) << ExpBits) - 1) << MantBits);
+    else if (E >= 1 - bias)
+        bits = (static_cast<U>(E + bias) << MantBits) | (mantissa & ((U(1) << MantBits) - 1));
+    else
+        bits = (1 - bias - E > MantBits) ? 0 : mantissa >> (1 - bias - E);
+    if (op->_mp_size < 0)
+        bits |= U(1) << (MantBits + ExpBits);
+    return bits;
+}
+// the integer part of |op| modulo 2^128
+inline unsigned __int128 mpf_get_integer_part(mpf_srcptr op) {
+    int size = std::abs(op->_mp_size);
+    mp_exp_t exp = op->_mp_exp;
+    auto limb = [&](long j) -> mp_limb_t {
+        long i = j + size - exp;
+        return (i >= 0 && i < size) ? op->_mp_d[i] : 0;
+    };
+    return (static_cast<unsigned __int128>(limb(1)) << 64) | limb(0);
+}
+
+template <typename T> struct ieee_bits;
+template <> struct ieee_bits<double> {
+    using type = uint64_t;
+    static constexpr int mant = 52, exp = 11;
+};
+template <> struct ieee_bits<float> {
+    using type = uint32_t;
+    static constexpr int mant = 23, exp = 8;
+};
+#if defined __SIZEOF_FLOAT128__
+template <> struct ieee_bits<__float128> {
+    using type = unsigned __int128;
+    static constexpr int mant = 112, exp = 15;
+};
+#endif
+template <typename T> struct is_bulk_convertible : std::false_type {};
+template <> struct is_bulk_convertible<double> : std::true_type {};
+template <> struct is_bulk_convertible<float> : std::true_type {};
+template <> struct is_bulk_convertible<int64_t> : std::true_type {};
+template <> struct is_bulk_convertible<uint64_t> : std::true_type {};
+template <> struct is_bulk_convertible<__int128> : std::true_type {};
+template <> struct is_bulk_convertible<unsigned __int128> : std::true_type {};
+#if defined __SIZEOF_FLOAT128__
+template <> struct is_bulk_convertible<__float128> : std::true_type {};
+#endif
+// the integer types and their unsigned counterparts; std::is_integral, std::is_signed and std::make_unsigned do not
+// know __int128 under strict ISO (-std=c++17 rather than -std=gnu++17)
+template <typename T> struct bulk_integer : std::false_type {};
+template <typename U, bool Signed> struct bulk_integer_traits : std::true_type {
+    using unsigned_type = U;
+    static constexpr bool is_signed = Signed;
+};
+template <> struct bulk_integer<int64_t> : bulk_integer_traits<uint64_t, true> {};
+template <> struct bulk_integer<uint64_t> : bulk_integer_traits<uint64_t, false> {};
+template <> struct bulk_integer<__int128> : bulk_integer_traits<unsigned __int128, true> {};
+template <> struct bulk_integer<unsigned __int128> : bulk_integer_traits<unsigned __int128, false> {};
+
+// false for NaN and infinity
+template <typename T> bool mpf_set_bulk(mpf_ptr rop, T op) {
+    if constexpr (bulk_integer<T>::value) {
+        using U = typename bulk_integer<T>::unsigned_type;
+        bool negative = bulk_integer<T>::is_signed && op < 0;
+        U magnitude = negative ? U(0) - static_cast<U>(op) : static_cast<U>(op);
+        mpf_set_binary(rop, negative, magnitude, 0);
+        return true;
+    } else {
+        using traits = ieee_bits<T>;
+        typename traits::type bits;
+        std::memcpy(&bits, &op, sizeof(T));
+        return mpf_set_ieee<typename traits::type, traits::mant, traits::exp>(rop, bits);
+    }
+}
+template <typename T> T mpf_get_bulk(mpf_srcptr op) {
+    if constexpr (bulk_integer<T>::value) {
+        using U = typename bulk_integer<T>::unsigned_type;
+        U magnitude = static_cast<U>(mpf_get_integer_part(op));
+        return static_cast<T>((bulk_integer<T>::is_signed && op->_mp_size < 0) ? U(0) - magnitude : magnitude);
+    } else {
+        using traits = ieee_bits<T>;
+        typename traits::type bits = mpf_get_ieee<typename traits::type, traits::mant, traits::exp>(op);
+        T rop;
+        std::memcpy(&rop, &bits, sizeof(T));
+        return rop;
+    }
+}
+template <typename T> void convert_to_mpf(const T *src, std::size_t n, mpf_class *dst) {
+    std::atomic<bool> invalid(false);
+    parallel_static_for(n, [&](std::size_t i) {
+        if (!mpf_set_bulk(dst[i].get_mpf_t(), src[i]))
+            invalid.store(true, std::memory_order_relaxed);
+    });
+    if (invalid.load())
+        throw std::domain_error("convert: NaN or infinity");
+}
+template <typename T> void convert_from_mpf(const mpf_class *src, std::size_t n, T *dst) {
+    parallel_static_for(n, [&](std::size_t i) { dst[i] = mpf_get_bulk<T>(src[i].get_mpf_t()); });
+}
+} // namespace helper
+// dst is resized to n elements when its size differs
+template <typename T, std::enable_if_t<helper::is_bulk_convertible<T>::value, int> = 0> void convert(const T *src, std::size_t n, mpf_vector &dst) {
+    if (dst.size() != n)
+        dst.resize(n);
+    helper::convert_to_mpf(src, n, dst.data());
+}
+// src holds rows() * cols() values, column major
+template <typename T, std::enable_if_t<helper::is_bulk_convertible<T>::value, int> = 0> void convert(const T *src, mpf_matrix &dst) { helper::convert_to_mpf(src, dst.size(), dst.data()); }
+// dst holds size() values
+template <typename T, std::enable_if_t<helper::is_bulk_convertible<T>::value, int> = 0> void convert(const mpf_vector &src, T *dst) { helper::convert_from_mpf(src.data(), src.size(), dst); }
+template <typename T, std::enable_if_t<helper::is_bulk_convertible<T>::value, int> = 0> void convert(const mpf_matrix &src, T *dst) { helper::convert_from_mpf(src.data(), src.size(), dst); }
+#if defined __cpp_lib_span
+template <typename T, std::enable_if_t<helper::is_bulk_convertible<T>::value, int> = 0> void convert(std::span<const T> src, mpf_vector &dst) { convert(src.data(), src.size(), dst); }
+template <typename T, std::enable_if_t<helper::is_bulk_convertible<T>::value, int> = 0> void convert(const mpf_vector &src, std::span<T> dst) {
+    assert(dst.size() == src.size());
+    convert(src, dst.data());
+}
+#endif
+#endif
+
+// load_text, save_text: bulk text I/O for mpf_vector and mpf_matrix.
+// Plain files hold whitespace separated numbers, one matrix row per line ('#' and '%' start a comment line).
+// Matrix Market files (real or integer field, general or symmetric) are detected by their "%%MatrixMarket" banner.
+// The file is split into chunks at line boundaries and the chunks are parsed and formatted in parallel
+// when compiled with OpenMP; numbers are converted in place with mpf_set_str/mpf_get_str without temporaries.
+enum class text_format { plain, matrix_market_array, matrix_market_coordinate };
+
+namespace helper {
+// runs body(k) for k in [0, count), in parallel with OpenMP; the first exception is rethrown
+template <typename F> void parallel_for_chunks(std::size_t count, F body) {
+    std::exception_ptr error;
+#if defined _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for (std::ptrdiff_t k = 0; k < static_cast<std::ptrdiff_t>(count); k++) {
+        try {
+            body(static_cast<std::size_t>(k));
+        } catch (...) {
+#if defined _OPENMP
+#pragma omp critical(gmpxx_mkII_parallel_for_chunks)
+#endif
+            if (!error)
+                error = std::current_exception();
+        }
+    }
+    if (error)
+        std::rethrow_exception(error);
+}
+inline std::size_t text_io_chunks() {
+#if defined _OPENMP
+    return 4 * static_cast<std::size_t>(omp_get_max_threads());
+#else
+    return 1;
+#endif
+}
+inline bool is_text_space(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f'; }
+inline char *skip_text_space(char *p, char *end) {
+    while (p < end && is_text_space(*p))
+        p++;
+    return p;
+}
+inline char *end_of_text_line(char *p, char *end) {
+    while (p < end && *p != '\n')
+        p++;
+    return p;
+}
+inline bool is_text_comment(char c) { return c == '%' || c == '#'; }
+// [begin, end) split into at most nchunks pieces, each starting at the beginning of a line
+inline std::vector<char *> split_text_lines(char *begin, char *end, std::size_t nchunks) {
+    std::vector<char *> bounds{begin};
+    std::size_t length = static_cast<std::size_t>(end - begin);
+    for (std::size_t k = 1; k < nchunks; k++) {
+        char *p = std::max(begin + length * k / nchunks, bounds.back());
+        while (p > begin && p < end && p[-1] != '\n')
+            p++;
+        if (p > bounds.back() && p < end)
+            bounds.push_back(p);
+    }
+    bounds.push_back(end);
+    return bounds;
+}
+// end is the end of the line, so *end is either '\n' of this line or the '\0' at the end of the buffer
+inline void set_mpf_from_text(mpf_ptr rop, char *token, char *end) {
+    char *p = token;
+    while (p < end && !is_text_space(*p))
+        p++;
+    char saved = *p;
+    *p = '\0';
+    int ret = mpf_set_str_dc(rop, token, 10);
+    *p = saved;
+    if (ret != 0)
+        throw std::runtime_error("load_text: invalid number \"" + std::string(token, p) + "\"");
+}
+inline char *next_text_token(char *p, char *end) {
+    while (p < end && !is_text_space(*p) && *p != '\n')
+        p++;
+    return p;
+}
+inline std::size_t parse_text_index(char *&p, char *end) {
+    p = skip_text_space(p, end);
+    std::size_t value = 0;
+    char *begin = p;
+    while (p < end && *p >= '0' && *p <= '9')
+        value = value * 10 + static_cast<std::size_t>(*p++ - '0');
+    if (p == begin || (p < end && !is_text_space(*p) && *p != '\n'))
+        throw std::runtime_error("load_text: invalid index in Matrix Market data");
+    return value;
+}
+struct text_header {
+    text_format format = text_format::plain;
+    bool symmetric = false;
+    std::size_t m = 0, n = 0, nnz = 0;
+    char *data = nullptr; // first character after the header and the size line
+};
+inline std::string lowercase_text(std::string s) {
+    for (auto &c : s)
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return s;
+}
+inline text_header read_text_header(char *begin, char *end) {
+    text_header header;
+    header.data = begin;
+    static const char banner[] = "%%MatrixMarket";
+    if (static_cast<std::size_t>(end - begin) < sizeof(banner) - 1 || std::strncmp(begin, banner, sizeof(banner) - 1) != 0)
+        return header;
+    char *eol = end_of_text_line(begin, end);
+    std::istringstream banner_line(std::string(begin, eol));
+    std::string tag, object, format, field, symmetry;
+    banner_line >> tag >> object >> format >> field >> symmetry;
+    object = lowercase_text(object);
+    format = lowercase_text(format);
+    field = lowercase_text(field);
+    symmetry = lowercase_text(symmetry);
+    if (object != "matrix" || (format != "array" && format != "coordinate"))
+        throw std::runtime_error("load_text: unsupported Matrix Market object \"" + object + " " + format + "\"");
+    if (field != "real" && field != "integer" && field != "double")
+        throw std::runtime_error("load_text: unsupported Matrix Market field \"" + field + "\"");
+    if (symmetry != "general" && symmetry != "symmetric")
+        throw std::runtime_error("load_text: unsupported Matrix Market symmetry \"" + symmetry + "\"");
+    header.format = (format == "array") ? text_format::matrix_market_array : text_format::matrix_market_coordinate;
+    header.symmetric = (symmetry == "symmetric");
+    // comment lines may follow the banner
+    char *p = eol;
+    while (p < end) {
+        char *q = skip_text_space(p + 1, end);
+        if (q < end && *q != '%' && *q != '\n') {
+            p = q;
+            break;
+        }
+        p = end_of_text_line(q, end);
+    }
+    header.m = parse_text_index(p, end);
+    header.n = parse_text_index(p, end);
+    if (header.format == text_format::matrix_market_coordinate)
+        header.nnz = parse_text_index(p, end);
+    header.data = end_of_text_line(p, end);
+    return header;
+}
+inline std::string read_text_file(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("load_text: cannot open " + path);
+    file.seekg(0, std::ios::end);
+    std::string text(static_cast<std::size_t>(file.tellg()), '\0');
+    file.seekg(0, std::ios::beg);
+    file.read(&text[0], static_cast<std::streamsize>(text.size()));
+    if (!file)
+        throw std::runtime_error("load_text: cannot read " + path);
+    return text;
+}
+// counts values (or non comment lines) in each chunk, so that every chunk knows where its data goes
+template <typename Count> std::vector<std::size_t> count_text_chunks(const std::vector<char *> &bounds, Count count) {
+    std::vector<std::size_t> offsets(bounds.size(), 0);
+    parallel_for_chunks(bounds.size() - 1, [&](std::size_t k) { offsets[k + 1] = count(bounds[k], bounds[k + 1]); });
+    for (std::size_t k = 1; k < offsets.size(); k++)
+        offsets[k] += offsets[k - 1];
+    return offsets;
+}
+// calls f(p, eol) for every line of [begin, end) that holds data
+template <typename F> void for_each_text_line(char *begin, char *end, F f) {
+    char *p = begin;
+    while (p < end) {
+        char *eol = end_of_text_line(p, end);
+        char *q = skip_text_space(p, eol);
+        if (q < eol && !is_text_comment(*q))
+            f(q, eol);
+        p = eol + 1;
+    }
+}
+// calls f(token, eol) for every value of [begin, end), regardless of the line layout
+template <typename F> void for_each_text_value(char *begin, char *end, F f) {
+    for_each_text_line(begin, end, [&](char *p, char *eol) {
+        while ((p = skip_text_space(p, eol)) < eol) {
+            f(p, eol);
+            p = next_text_token(p, eol);
+        }
+    });
+}
+// the number of values on the first line of [begin, end) that holds data, 0 without one; stops at that line
+inline std::size_t count_first_text_line(char *begin, char *end) {
+    for (char *p = begin; p < end;) {
+        char *eol = end_of_text_line(p, end);
+        char *q = skip_text_space(p, eol);
+        if (q < eol && !is_text_comment(*q)) {
+            std::size_t n = 0;
+            for_each_text_value(q, eol, [&](char *, char *) { n++; });
+            return n;
+        }
+        p = eol + 1;
+    }
+    return 0;
+}
+// loads the body of the file; at(i, j) returns the destination element
+template <typename At> void load_text_body(const text_header &header, char *end, std::size_t m, std::size_t n, At at) {
+    std::vector<char *> bounds = split_text_lines(header.data, end, text_io_chunks());
+    std::size_t nchunks = bounds.size() - 1;
+    if (header.format == text_format::matrix_market_coordinate) {
+        std::vector<std::size_t> offsets = count_text_chunks(bounds, [](char *b, char *e) {
+            std::size_t c = 0;
+            for_each_text_line(b, e, [&](char *, char *) { c++; });
+            return c;
+        });
+        if (offsets.back() != header.nnz)
+            throw std::runtime_error("load_text: Matrix Market entry count does not match the size line");
+        parallel_for_chunks(nchunks, [&](std::size_t k) {
+            for_each_text_line(bounds[k], bounds[k + 1], [&](char *p, char *eol) {
+                std::size_t i = parse_text_index(p, eol), j = parse_text_index(p, eol);
+                if (i < 1 || i > m || j < 1 || j > n)
+                    throw std::runtime_error("load_text: Matrix Market index out of range");
+                p = skip_text_space(p, eol);
+                set_mpf_from_text(at(i - 1, j - 1), p, eol);
+                if (header.symmetric && i != j)
+                    mpf_set(at(j - 1, i - 1), at(i - 1, j - 1));
+            });
+        });
+        return;
+    }
+    std::vector<std::size_t> offsets = count_text_chunks(bounds, [](char *b, char *e) {
+        std::size_t c = 0;
+        for_each_text_value(b, e, [&](char *, char *) { c++; });
+        return c;
+    });
+    // array data is column major; the symmetric variant holds the lower triangle only
+    std::size_t expected = header.symmetric ? n * (n + 1) / 2 : m * n;
+    if (offsets.back() != expected)
+        throw std::runtime_error("load_text: number of values does not match the matrix size");
+    parallel_for_chunks(nchunks, [&](std::size_t k) {
+        std::size_t idx = offsets[k];
+        for_each_text_value(bounds[k], bounds[k + 1], [&](char *p, char *eol) {
+            std::size_t i, j;
+            if (!header.symmetric) {
+                i = idx % m;
+                j = idx / m;
+            } else {
+                // column j starts at j * n - j * (j - 1) / 2
+                std::size_t lo = 0, hi = n - 1;
+                while (lo < hi) {
+                    std::size_t mid = (lo + hi + 1) / 2;
+                    if (mid * n - mid * (mid - 1) / 2 <= idx)
+                        lo = mid;
+                    else
+                        hi = mid - 1;
+                }
+                j = lo;
+                i = j + idx - (j * n - j * (j - 1) / 2);
+            }
+            set_mpf_from_text(at(i, j), p, eol);
+            if (header.symmetric && i != j)
+                mpf_set(at(j, i), at(i, j));
+            idx++;
+        });
+    });
+}
+inline int text_digits(mp_bitcnt_t prec, int digits) {
+    // enough decimal digits to read the same binary value back
+    return digits > 0 ? digits : static_cast<int>(std::ceil(static_cast<double>(prec) * 0.30102999566398119521)) + 2;
+}
+// appends x as [-]d.ddd...e[+-]xx; buf holds at least digits + 2 chars
+inline void append_mpf_text(std::string &out, mpf_srcptr x, int digits, char *buf) {
+    mp_exp_t exp;
+    mpf_get_str(buf, &exp, 10, static_cast<std::size_t>(digits), x);
+    const char *p = buf;
+    if (*p == '\0') {
+        out += '0';
+        return;
+    }
+    if (*p == '-')
+        out += *p++;
+    out += *p++;
+    if (*p != '\0') {
+        out += '.';
+        out += p;
+    }
+    char expbuf[24];
+    expbuf[0] = 'e';
+    auto result = std::to_chars(expbuf + 1, expbuf + sizeof(expbuf), static_cast<long>(exp) - 1);
+    out.append(expbuf, result.ptr);
+}
+// appends a 1-based Matrix Market index followed by a blank
+inline void append_text_index(std::string &out, std::size_t index) {
+    char buf[24];
+    auto result = std::to_chars(buf, buf + sizeof(buf), index);
+    out.append(buf, result.ptr);
+    out += ' ';
+}
+// formats records [0, count) chunk by chunk in parallel and writes them in order
+template <typename Format> void save_text_records(std::ofstream &file, std::size_t count, std::size_t values_per_record, int digits, Format format) {
+    // a few thousand values per chunk keeps the formatted text of one round small
+    const std::size_t nchunks = text_io_chunks();
+    const std::size_t per_chunk = std::max<std::size_t>(1, 4096 / std::max<std::size_t>(values_per_record, 1));
+    std::vector<std::string> out(nchunks);
+    for (std::size_t first = 0; first < count; first += per_chunk * nchunks) {
+        parallel_for_chunks(nchunks, [&](std::size_t k) {
+            std::vector<char> buf(static_cast<std::size_t>(digits) + 2);
+            out[k].clear();
+            std::size_t begin = std::min(count, first + k * per_chunk), end = std::min(count, begin + per_chunk);
+            for (std::size_t r = begin; r < end; r++)
+                format(out[k], r, buf.data());
+        });
+        for (auto &s : out)
+            file.write(s.data(), static_cast<std::streamsize>(s.size()));
+    }
+}
+} // namespace helper
+
+inline void load_text(const std::string &path, mpf_matrix &A) {
+    std::string text = helper::read_text_file(path);
+    char *begin = &text[0], *end = begin + text.size();
+    helper::text_header header = helper::read_text_header(begin, end);
+    if (header.format == text_format::plain) {
+        // one row per line; the first data line fixes the number of columns
+        std::vector<char *> bounds = helper::split_text_lines(begin, end, helper::text_io_chunks());
+        std::vector<std::size_t> offsets = helper::count_text_chunks(bounds, [](char *b, char *e) {
+            std::size_t c = 0;
+            helper::for_each_text_line(b, e, [&](char *, char *) { c++; });
+            return c;
+        });
+        std::size_t n = helper::count_first_text_line(begin, end);
+        A.resize(offsets.back(), n);
+        helper::parallel_for_chunks(bounds.size() - 1, [&](std::size_t k) {
+            std::size_t i = offsets[k];
+            helper::for_each_text_line(bounds[k], bounds[k + 1], [&](char *p, char *eol) {
+                std::size_t j = 0;
+                helper::for_each_text_value(p, eol, [&](char *q, char *e) {
+                    if (j >= n)
+                        throw std::runtime_error("load_text: row " + std::to_string(i + 1) + " has too many values");
+                    helper::set_mpf_from_text(A(i, j++).get_mpf_t(), q, e);
+                });
+                if (j != n)
+                    throw std::runtime_error("load_text: row " + std::to_string(i + 1) + " has too few values");
+                i++;
+            });
+        });
+        return;
+    }
+    if (header.symmetric && header.m != header.n)
+        throw std::runtime_error("load_text: symmetric Matrix Market matrix must be square");
+    A.resize(header.m, header.n);
+    helper::load_text_body(header, end, header.m, header.n, [&](std::size_t i, std::size_t j) { return A(i, j).get_mpf_t(); });
+}
+inline void load_text(const std::string &path, mpf_vector &x) {
+    std::string text = helper::read_text_file(path);
+    char *begin = &text[0], *end = begin + text.size();
+    helper::text_header header = helper::read_text_header(begin, end);
+    if (header.format == text_format::plain) {
+        // any layout of whitespace separated values
+        std::vector<char *> bounds = helper::split_text_lines(begin, end, helper::text_io_chunks());
+        std::vector<std::size_t> offsets = helper::count_text_chunks(bounds, [](char *b, char *e) {
+            std::size_t c = 0;
+            helper::for_each_text_value(b, e, [&](char *, char *) { c++; });
+            return c;
+        });
+        x.resize(offsets.back());
+        helper::parallel_for_chunks(bounds.size() - 1, [&](std::size_t k) {
+            std::size_t i = offsets[k];
+            helper::for_each_text_value(bounds[k], bounds[k + 1], [&](char *p, char *eol) { helper::set_mpf_from_text(x[i++].get_mpf_t(), p, eol); });
+        });
+        return;
+    }
+    if (header.m != 1 && header.n != 1)
+        throw std::runtime_error("load_text: Matrix Market data is not a vector");
+    std::size_t m = header.m;
+    x.resize(header.m * header.n);
+    helper::load_text_body(header, end, header.m, header.n, [&](std::size_t i, std::size_t j) { return x[i + j * m].get_mpf_t(); });
+}
+// digits == 0 writes enough digits to read the values back to their working precision
+inline void save_text(const std::string &path, const mpf_matrix &A, text_format format = text_format::plain, int digits = 0) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+        throw std::runtime_error("save_text: cannot open " + path);
+    const std::size_t m = A.rows(), n = A.cols();
+    mp_bitcnt_t prec = A.get_prec();
+    for (std::size_t k = 0; k < A.size(); k++)
+        prec = std::max(prec, mpf_get_prec(A.data()[k].get_mpf_t()));
+    digits = helper::text_digits(prec, digits);
+    switch (format) {
+    case text_format::plain:
+        helper::save_text_records(file, m, n, digits, [&](std::string &out, std::size_t i, char *buf) {
+            for (std::size_t j = 0; j < n; j++) {
+                if (j > 0)
+                    out += ' ';
+                helper::append_mpf_text(out, A(i, j).get_mpf_t(), digits, buf);
+            }
+            out += '\n';
+        });
+        break;
+    case text_format::matrix_market_array:
+        file << "%%MatrixMarket matrix array real general\n" << m << " " << n << "\n";
+        helper::save_text_records(file, m * n, 1, digits, [&](std::string &out, std::size_t k, char *buf) {
+            helper::append_mpf_text(out, A.data()[k].get_mpf_t(), digits, buf);
+            out += '\n';
+        });
+        break;
+    case text_format::matrix_market_coordinate: {
+        std::size_t nnz = 0;
+        for (std::size_t k = 0; k < A.size(); k++)
+            nnz += (mpf_sgn(A.data()[k].get_mpf_t()) != 0);
+        file << "%%MatrixMarket matrix coordinate real general\n" << m << " " << n << " " << nnz << "\n";
+        helper::save_text_records(file, n, m, digits, [&](std::string &out, std::size_t j, char *buf) {
+            for (std::size_t i = 0; i < m; i++) {
+                if (mpf_sgn(A(i, j).get_mpf_t()) == 0)
+                    continue;
+                helper::append_text_index(out, i + 1);
+                helper::append_text_index(out, j + 1);
+                helper::append_mpf_text(out, A(i, j).get_mpf_t(), digits, buf);
+                out += '\n';
+            }
+        });
+        break;
+    }
+    }
+    if (!file)
+        throw std::runtime_error("save_text: cannot write " + path);
+}
+inline void save_text(const std::string &path, const mpf_vector &x, text_format format = text_format::plain, int digits = 0) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+        throw std::runtime_error("save_text: cannot open " + path);
+    const std::size_t m = x.size();
+    mp_bitcnt_t prec = x.get_prec();
+    for (const auto &e : x)
+        prec = std::max(prec, mpf_get_prec(e.get_mpf_t()));
+    digits = helper::text_digits(prec, digits);
+    if (format == text_format::matrix_market_array)
+        file << "%%MatrixMarket matrix array real general\n" << m << " 1\n";
+    if (format == text_format::matrix_market_coordinate) {
+        std::size_t nnz = 0;
+        for (const auto &e : x)
+            nnz += (mpf_sgn(e.get_mpf_t()) != 0);
+        file << "%%MatrixMarket matrix coordinate real general\n" << m << " 1 " << nnz << "\n";
+    }
+    helper::save_text_records(file, m, 1, digits, [&](std::string &out, std::size_t i, char *buf) {
+        if (format == text_format::matrix_market_coordinate) {
+            if (mpf_sgn(x[i].get_mpf_t()) == 0)
+                return;
+            helper::append_text_index(out, i + 1);
+            out += "1 ";
+        }
+        helper::append_mpf_text(out, x[i].get_mpf_t(), digits, buf);
+        out += '\n';
+    });
+    if (!file)
+        throw std::runtime_error("save_text: cannot write " + path);
+}
+// std::format / fmt support. The format spec is parsed once by the formatter and the text is built in a
+// stack buffer and copied to the output iterator, without streams or locales.
+// [[fill]align][sign][#][0][width][.precision][type]
+//   mpz_class, mpq_class: type d (default), b, B, o, x, X; no precision
+//   mpf_class: type f, F, e, E, g, G (default g, precision 6 as for operator<<) and a, A (exact hexadecimal)
+namespace helper {
+struct format_spec {
+    char fill = ' ';
+    char align = '\0';
+    char sign = '-';
+    bool alternate = false;
+    bool zero_pad = false;
+    int width = 0;
+    int precision = -1;
+    char type = '\0';
+
+    template <typename Error, typename Iterator> constexpr Iterator parse(Iterator it, Iterator end, const char *types, bool allow_precision) {
+        auto is_align = [](char c) { return c == '<' || c == '>' || c == '^'; };
+        auto read_number = [&](int &value) {
+            value = 0;
+            while (it != end && *it >= '0' && *it <= '9') {
+                if (value > (std::numeric_limits<int>::max() - 9) / 10)
+                    throw Error("gmpxx_mkII: width or precision is too large");
+                value = value * 10 + (*it++ - '0');
+            }
+        };
+        if (it == end || *it == '}')
+            return it;
+        if (it + 1 != end && is_align(*(it + 1)) && *it != '{' && *it != '}') {
+            fill = *it;
+            align = *(it + 1);
+            it += 2;
+        } else if (is_align(*it)) {
+            align = *it++;
+        }
+        if (it != end && (*it == '+' || *it == '-' || *it == ' '))
+            sign = *it++;
+        if (it != end && *it == '#') {
+            alternate = true;
+            it++;
+        }
+        if (it != end && *it == '0') {
+            zero_pad = true;
+            it++;
+        }
+        read_number(width);
+        if (it != end && *it == '.') {
+            it++;
+            if (!allow_precision || it == end || *it < '0' || *it > '9')
+                throw Error("gmpxx_mkII: invalid precision in format spec");
+            read_number(precision);
+        }
+        if (it != end && *it != '}') {
+            for (const char *t = types; *t != '\0'; t++)
+                if (*it == *t)
+                    type = *it;
+            if (type != '\0')
+                it++;
+        }
+        if (it != end && *it != '}')
+            throw Error("gmpxx_mkII: invalid format spec (dynamic width/precision and L are not supported)");
+        return it;
+    }
+    // the sign character of a value, or '\0'
+    char sign_char(bool negative) const {
+        if (negative)
+            return '-';
+        return (sign == '-') ? '\0' : sign;
+    }
+};
+// writes body (prefix chars of sign/base prefix first) padded to spec.width
+template <typename OutputIt> OutputIt format_write(OutputIt out, const format_spec &spec, const char_buffer &body, std::size_t prefix) {
+    const char *text = body.c_str();
+    std::size_t len = body.size();
+    std::size_t padding = (static_cast<std::size_t>(spec.width) > len) ? spec.width - len : 0;
+    if (spec.zero_pad && spec.align == '\0') {
+        out = std::copy(text, text + prefix, out);
+        out = std::fill_n(out, padding, '0');
+        return std::copy(text + prefix, text + len, out);
+    }
+    std::size_t before = (spec.align == '<') ? 0 : (spec.align == '^') ? padding / 2 : padding;
+    out = std::fill_n(out, before, spec.fill);
+    out = std::copy(text, text + len, out);
+    return std::fill_n(out, padding - before, spec.fill);
+}
+inline int format_base(char type) {
+    switch (type) {
+    case 'b':
+    case 'B':
+        return 2;
+    case 'o':
+        return 8;
+    case 'x':
+        return 16;
+    case 'X':
+        return -16;
+    default:
+        return 10;
+    }
+}
+// the digits of |op| in the base of spec.type, with the # prefix
+inline void format_mpz_digits(char_buffer &body, const format_spec &spec, mpz_srcptr op) {
+    int base = format_base(spec.type);
+    if (spec.alternate && base != 10 && !(base == 8 && mpz_sgn(op) == 0)) {
+        body.push_back('0');
+        if (base != 8)
+            body.push_back(base == 2 ? spec.type : (base == 16 ? 'x' : 'X'));
+    }
+    // straight into body, over the '-' mpz_get_str writes for a negative op
+    std::size_t start = body.size();
+    body.resize(start + mpz_sizeinbase(op, std::abs(base)) + 2);
+    char *digits = body.data() + start;
+    mpz_get_str(digits, base, op);
+    std::size_t len = std::strlen(digits);
+    if (mpz_sgn(op) < 0)
+        std::memmove(digits, digits + 1, --len);
+    body.truncate(start + len);
+}
+// the length of the 0x or 0b prefix format_mpz_digits writes; zero padding goes after it
+inline std::size_t format_base_prefix(const format_spec &spec) { return (spec.alternate && format_base(spec.type) != 10 && format_base(spec.type) != 8) ? 2 : 0; }
+template <typename OutputIt> OutputIt format_mpz(OutputIt out, const format_spec &spec, mpz_srcptr op) {
+    char_buffer body;
+    if (char c = spec.sign_char(mpz_sgn(op) < 0))
+        body.push_back(c);
+    std::size_t prefix = body.size() + format_base_prefix(spec);
+    format_mpz_digits(body, spec, op);
+    return format_write(out, spec, body, prefix);
+}
+// the padding of "{:#012x}" goes between the numerator's prefix and its digits, as for mpz_class
+template <typename OutputIt> OutputIt format_mpq(OutputIt out, const format_spec &spec, mpq_srcptr op) {
+    char_buffer body;
+    if (char c = spec.sign_char(mpq_sgn(op) < 0))
+        body.push_back(c);
+    std::size_t prefix = body.size() + format_base_prefix(spec);
+    format_mpz_digits(body, spec, mpq_numref(op));
+    body.push_back('/');
+    format_mpz_digits(body, spec, mpq_denref(op));
+    return format_write(out, spec, body, prefix);
+}
+// n significant digits of |op|, correctly rounded (ties to even) from the binary value as printf does for double,
+// and the exponent exp such that |op| ~ 0.ddd * 10^exp; the digits stay in a stack buffer unless there are many
+class format_mpf_digits {
+  public:
+    format_mpf_digits(mpf_srcptr op, std::size_t n) {
+        radix_get_digits_exact(digits, exp, 10, n, op, true);
+        if (mpf_sgn(op) == 0)
+            exp = 1;
+    }
+    // the i-th digit, '0' beyond the digits returned (trailing zeros are not stored)
+    char operator[](long i) const { return (i >= 0 && static_cast<std::size_t>(i) < digits.size()) ? digits[i] : '0'; }
+    mp_exp_t exp;
+
+  private:
+    char_buffer digits;
+};
+// |op| > 0.5 * 10^-precision, exactly (a tie rounds to the even 0)
+inline bool format_mpf_above_half_ulp(mpf_srcptr op, long precision) {
+    // |op| = M * 2^E: compare M * 10^(precision + 1) with 5 * 2^-E
+    mpz_t M;
+    mpz_roinit_n(M, op->_mp_d, std::abs(op->_mp_size));
+    long E = static_cast<long>(op->_mp_exp - std::abs(op->_mp_size)) * GMP_NUMB_BITS;
+    mpz_class lhs, rhs(5);
+    mpz_ui_pow_ui(lhs.get_mpz_t(), 10, static_cast<unsigned long>(precision + 1));
+    mpz_mul(lhs.get_mpz_t(), lhs.get_mpz_t(), M);
+    if (E >= 0)
+        mpz_mul_2exp(lhs.get_mpz_t(), lhs.get_mpz_t(), static_cast<mp_bitcnt_t>(E));
+    else
+        mpz_mul_2exp(rhs.get_mpz_t(), rhs.get_mpz_t(), static_cast<mp_bitcnt_t>(-E));
+    return lhs > rhs;
+}
+// integral part and precision fractional digits of 0.ddd * 10^exp
+inline void format_fixed_body(char_buffer &body, const format_mpf_digits &d, long precision, bool point) {
+    if (d.exp <= 0)
+        body.push_back('0');
+    for (long i = 0; i < d.exp; i++)
+        body.push_back(d[i]);
+    if (precision > 0 || point)
+        body.push_back('.');
+    for (long i = 0; i < precision; i++)
+        body.push_back(d[d.exp + i]);
+}
+inline void format_exponent(char_buffer &body, long exponent, bool upper) {
+    body.push_back(upper ? 'E' : 'e');
+    body.push_back(exponent < 0 ? '-' : '+');
+    char buf[24];
+    char *end = std::to_chars(buf, buf + sizeof(buf), exponent < 0 ? -exponent : exponent).ptr;
+    if (end - buf < 2)
+        body.push_back('0');
+    body.append(buf, end - buf);
+}
+template <typename OutputIt> OutputIt format_mpf(OutputIt out, const format_spec &spec, mpf_srcptr op) {
+    char_buffer body;
+    if (char c = spec.sign_char(mpf_sgn(op) < 0))
+        body.push_back(c);
+    std::size_t prefix = body.size();
+    const bool upper = (spec.type == 'E' || spec.type == 'F' || spec.type == 'G' || spec.type == 'A');
+    const long precision = (spec.precision < 0) ? 6 : spec.precision;
+    switch (spec.type) {
+    case 'a':
+    case 'A': {
+        // as std::format does for double: no 0x prefix, all the digits
+        std::string hex = mpf_get_hexfloat(op, upper);
+        std::size_t skip = (hex[0] == '-') ? 3 : 2;
+        body.append(hex.c_str() + skip, hex.size() - skip);
+        break;
+    }
+    case 'e':
+    case 'E': {
+        format_mpf_digits d(op, precision + 1);
+        body.push_back(d[0]);
+        if (precision > 0 || spec.alternate)
+            body.push_back('.');
+        for (long i = 1; i <= precision; i++)
+            body.push_back(d[i]);
+        format_exponent(body, mpf_sgn(op) == 0 ? 0 : d.exp - 1, upper);
+        break;
+    }
+    case 'f':
+    case 'F': {
+        if (mpf_sgn(op) == 0) {
+            format_mpf_digits d(op, 1);
+            format_fixed_body(body, d, precision, spec.alternate);
+            break;
+        }
+        // |op| < 2^e2, so it has at most e integral digits; ask GMP for the digits down to 10^-precision
+        long e2;
+        mpf_get_d_2exp(&e2, op);
+        long e = static_cast<long>(std::floor(static_cast<double>(e2) * 0.30102999566398120)) + 1;
+        while (true) {
+            long n = e + precision;
+            if (n <= 0) {
+                // |op| < 10^-precision rounds to 0 or to 10^-precision
+                bool round_up = (n == 0) && format_mpf_above_half_ulp(op, precision);
+                if (precision == 0) {
+                    body.push_back(round_up ? '1' : '0');
+                    if (spec.alternate)
+                        body.push_back('.');
+                } else {
+                    body.append("0.", 2);
+                    body.append(precision - 1, '0');
+                    body.push_back(round_up ? '1' : '0');
+                }
+                break;
+            }
+            format_mpf_digits d(op, static_cast<std::size_t>(n));
+            if (d.exp < e) {
+                // the estimate was one too large; this many digits would round at the wrong place
+                e = d.exp;
+                continue;
+            }
+            format_fixed_body(body, d, precision, spec.alternate);
+            break;
+        }
+        break;
+    }
+    default: {
+        // g: precision significant digits, fixed when -4 <= exponent < precision, trailing zeros removed unless #
+        long p = (precision == 0) ? 1 : precision;
+        format_mpf_digits d(op, static_cast<std::size_t>(p));
+        long x = (mpf_sgn(op) == 0) ? 0 : d.exp - 1;
+        std::size_t start = body.size();
+        if (-4 <= x && x < p) {
+            format_fixed_body(body, d, p - 1 - x, spec.alternate);
+        } else {
+            body.push_back(d[0]);
+            if (p > 1 || spec.alternate)
+                body.push_back('.');
+            for (long i = 1; i < p; i++)
+                body.push_back(d[i]);
+        }
+        if (!spec.alternate && std::strchr(body.c_str() + start, '.') != nullptr) {
+            while (body[body.size() - 1] == '0')
+                body.truncate(body.size() - 1);
+            if (body[body.size() - 1] == '.')
+                body.truncate(body.size() - 1);
+        }
+        if (!(-4 <= x && x < p))
+            format_exponent(body, x, upper);
+        break;
+    }
+    }
+    return format_write(out, spec, body, prefix);
+}
+// the formatter specializations below; Error is std::format_error or fmt::format_error
+template <typename Error> struct mpz_formatter {
+    format_spec spec;
+    template <typename ParseContext> constexpr auto parse(ParseContext &ctx) { return spec.parse<Error>(ctx.begin(), ctx.end(), "bBdoxX", false); }
+    template <typename FormatContext> auto format(const mpz_class &op, FormatContext &ctx) const { return format_mpz(ctx.out(), spec, op.get_mpz_t()); }
+};
+template <typename Error> struct mpq_formatter {
+    format_spec spec;
+    template <typename ParseContext> constexpr auto parse(ParseContext &ctx) { return spec.parse<Error>(ctx.begin(), ctx.end(), "bBdoxX", false); }
+    template <typename FormatContext> auto format(const mpq_class &op, FormatContext &ctx) const { return format_mpq(ctx.out(), spec, op.get_mpq_t()); }
+};
+template <typename Error> struct mpf_formatter {
+    format_spec spec;
+    template <typename ParseContext> constexpr auto parse(ParseContext &ctx) { return spec.parse<Error>(ctx.begin(), ctx.end(), "aAeEfFgG", true); }
+    template <typename FormatContext> auto format(const mpf_class &op, FormatContext &ctx) const { return format_mpf(ctx.out(), spec, op.get_mpf_t()); }
+};
+} // namespace helper
+namespace helper {
+// Compile time conversion of decimal literals for the _mpf128 ... _mpf4096 suffixes. The digits arrive as a
+// literal operator template pack, are converted with constexpr 32 bit word arithmetic and rounded to nearest
+// (ties to even) to the limbs mpf_init2(prec) gives, so a literal is exact to the precision of its suffix
+// and costs one memcpy at run time.
+static_assert(GMP_NUMB_BITS % 32 == 0 && GMP_NAIL_BITS == 0, "gmpxx_mkII: the _mpfN literals need nail free 32 or 64 bit limbs");
+template <std::size_t N> struct literal_uint {
+    uint32_t w[N] = {};
+    std::size_t n = 0;
+    constexpr void mul_add(uint32_t m, uint32_t a) {
+        uint64_t carry = a;
+        for (std::size_t i = 0; i < n; i++) {
+            uint64_t t = static_cast<uint64_t>(w[i]) * m + carry;
+            w[i] = static_cast<uint32_t>(t);
+            carry = t >> 32;
+        }
+        if (carry != 0)
+            w[n++] = static_cast<uint32_t>(carry);
+    }
+    constexpr std::size_t bits() const { return (n == 0) ? 0 : (n - 1) * 32 + (32 - __builtin_clz(w[n - 1])); }
+    constexpr bool bit(std::size_t k) const { return k / 32 < n && ((w[k / 32] >> (k % 32)) & 1) != 0; }
+    constexpr bool any_below(std::size_t k) const {
+        for (std::size_t i = 0; i < k / 32 && i < n; i++)
+            if (w[i] != 0)
+                return true;
+        return k / 32 < n && k % 32 != 0 && (w[k / 32] & ((uint32_t(1) << (k % 32)) - 1)) != 0;
+    }
+    constexpr void shift_words(long k) {
+        if (k > 0) {
+            for (std::size_t i = n; i-- > 0;)
+                w[i + k] = w[i];
+            for (long i = 0; i < k; i++)
+                w[i] = 0;
+            n += k;
+        } else if (k < 0) {
+            std::size_t d = static_cast<std::size_t>(-k);
+            for (std::size_t i = 0; i + d < n; i++)
+                w[i] = w[i + d];
+            for (std::size_t i = (n > d) ? n - d : 0; i < n; i++)
+                w[i] = 0;
+            n = (n > d) ? n - d : 0;
+        }
+    }
+    constexpr void shift_left_1(bool low) {
+        uint32_t carry = low ? 1 : 0;
+        for (std::size_t i = 0; i < n; i++) {
+            uint32_t next = w[i] >> 31;
+            w[i] = (w[i] << 1) | carry;
+            carry = next;
+        }
+        if (carry != 0)
+            w[n++] = carry;
+    }
+    constexpr int compare(const literal_uint &op) const {
+        if (n != op.n)
+            return (n > op.n) ? 1 : -1;
+        for (std::size_t i = n; i-- > 0;)
+            if (w[i] != op.w[i])
+                return (w[i] > op.w[i]) ? 1 : -1;
+        return 0;
+    }
+    constexpr void subtract(const literal_uint &op) {
+        int64_t borrow = 0;
+        for (std::size_t i = 0; i < n; i++) {
+            int64_t t = static_cast<int64_t>(w[i]) - (i < op.n ? op.w[i] : 0) - borrow;
+            borrow = (t < 0) ? 1 : 0;
+            w[i] = static_cast<uint32_t>(t + (borrow << 32));
+        }
+        while (n > 0 && w[n - 1] == 0)
+            n--;
+    }
+};
+// the literal is digits * 10^exponent
+struct decimal_literal_info {
+    bool decimal;
+    std::size_t digits;
+    long exponent;
+};
+template <char... Cs> constexpr decimal_literal_info parse_decimal_literal() {
+    constexpr char str[] = {Cs..., '\0'};
+    decimal_literal_info info{true, 0, 0};
+    if (str[0] == '0' && (str[1] == 'x' || str[1] == 'X' || str[1] == 'b' || str[1] == 'B')) {
+        info.decimal = false;
+        return info;
+    }
+    bool point = false, leading = true;
+    std::size_t i = 0;
+    for (; str[i] != '\0' && str[i] != 'e' && str[i] != 'E'; i++) {
+        if (str[i] == '\'')
+            continue;
+        if (str[i] == '.') {
+            point = true;
+            continue;
+        }
+        if (point)
+            info.exponent--;
+        if (leading && str[i] == '0')
+            continue;
+        leading = false;
+        info.digits++;
+    }
+    if (str[i] != '\0') {
+        bool negative = (str[i + 1] == '-');
+        i += (str[i + 1] == '-' || str[i + 1] == '+') ? 2 : 1;
+        long e = 0;
+        for (; str[i] != '\0'; i++)
+            if (str[i] != '\'')
+                e = e * 10 + (str[i] - '0');
+        info.exponent += negative ? -e : e;
+    }
+    return info;
+}
+template <std::size_t L> struct mpf_literal_limbs {
+    mp_limb_t d[L] = {};
+    int size = 0;
+    mp_exp_t exp = 0;
+};
+template <mp_bitcnt_t Prec, char... Cs> constexpr auto decimal_literal_to_mpf() {
+    constexpr decimal_literal_info info = parse_decimal_literal<Cs...>();
+    constexpr std::size_t L = (Prec + 2 * GMP_NUMB_BITS - 1) / GMP_NUMB_BITS;
+    constexpr std::size_t abs_exponent = static_cast<std::size_t>(info.exponent < 0 ? -info.exponent : info.exponent);
+    // 10^k < 2^(4k); a quotient gets L + 3 limbs of room
+    constexpr std::size_t N = (4 * (info.digits + abs_exponent) + (L + 4) * GMP_NUMB_BITS) / 32 + 4;
+    constexpr std::size_t words_per_limb = GMP_NUMB_BITS / 32;
+    mpf_literal_limbs<L> result;
+    if (info.digits == 0)
+        return result;
+    constexpr char str[] = {Cs..., '\0'};
+    literal_uint<N> x;
+    bool leading = true;
+    for (std::size_t i = 0; str[i] != '\0' && str[i] != 'e' && str[i] != 'E'; i++) {
+        if (str[i] == '\'' || str[i] == '.' || (leading && str[i] == '0'))
+            continue;
+        leading = false;
+        x.mul_add(10, static_cast<uint32_t>(str[i] - '0'));
+    }
+    // x * 2^(-shift * GMP_NUMB_BITS), and whether something nonzero was cut off below
+    long shift = 0;
+    bool sticky = false;
+    if (info.exponent >= 0) {
+        for (std::size_t k = 0; k < abs_exponent; k++)
+            x.mul_add(10, 0);
+    } else {
+        literal_uint<N> p;
+        p.w[0] = 1;
+        p.n = 1;
+        for (std::size_t k = 0; k < abs_exponent; k++)
+            p.mul_add(10, 0);
+        long need = static_cast<long>((L + 2) * GMP_NUMB_BITS + p.bits()) - static_cast<long>(x.bits());
+        shift = (need > 0) ? (need + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS : 0;
+        x.shift_words(shift * words_per_limb);
+        literal_uint<N> q, r;
+        for (std::size_t k = x.bits(); k-- > 0;) {
+            r.shift_left_1(x.bit(k));
+            q.shift_left_1(false);
+            if (r.compare(p) >= 0) {
+                r.subtract(p);
+                q.w[0] |= 1;
+                if (q.n == 0)
+                    q.n = 1;
+            }
+        }
+        x = q;
+        sticky = (r.n != 0);
+    }
+    long limbs = static_cast<long>((x.bits() + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS);
+    result.exp = limbs - shift;
+    if (limbs > static_cast<long>(L)) {
+        std::size_t drop = (limbs - L) * GMP_NUMB_BITS;
+        bool half = x.bit(drop - 1), rest = sticky || x.any_below(drop - 1), odd = x.bit(drop);
+        x.shift_words(-static_cast<long>((limbs - L) * words_per_limb));
+        if (half && (rest || odd)) {
+            x.mul_add(1, 1);
+            if (x.bits() > L * GMP_NUMB_BITS) {
+                x.shift_words(-static_cast<long>(words_per_limb));
+                result.exp++;
+            }
+        }
+        limbs = L;
+    }
+    std::size_t low = 0;
+    for (long i = 0; i < limbs; i++) {
+        mp_limb_t limb = 0;
+        for (std::size_t j = words_per_limb; j-- > 0;)
+            limb = (words_per_limb == 1) ? x.w[i] : ((limb << 16) << 16) | x.w[i * words_per_limb + j];
+        result.d[i] = limb;
+    }
+    while (result.d[low] == 0)
+        low++;
+    for (long i = low; i < limbs; i++)
+        result.d[i - low] = result.d[i];
+    result.size = static_cast<int>(limbs - low);
+    return result;
+}
+template <mp_bitcnt_t Prec, char... Cs> inline mpf_class mpf_literal() {
+    static_assert(parse_decimal_literal<Cs...>().decimal, "gmpxx_mkII: the _mpfN literals take decimal literals");
+    static constexpr auto limbs = decimal_literal_to_mpf<Prec, Cs...>();
+    mpf_class result(0UL, Prec);
+    mpf_ptr value = result.get_mpf_t();
+    std::memcpy(value->_mp_d, limbs.d, limbs.size * sizeof(mp_limb_t));
+    value->_mp_size = limbs.size;
+    value->_mp_exp = limbs.exp;
+    return result;
+}
+} // namespace helper
 #if !defined ___GMPXX_DONT_USE_NAMESPACE___
 } // namespace gmp
 #endif
@@ -4778,6 +8636,13 @@ inline mpf_class operator"" _mpf(long double val) {
     }
     return mpf_class(static_cast<double>(val));
 }
+// exact to the precision of the suffix, converted at compile time: 3.14159265358979323846264338327950288_mpf512
+template <char... Cs> inline mpf_class operator"" _mpf128() { return helper::mpf_literal<128, Cs...>(); }
+template <char... Cs> inline mpf_class operator"" _mpf256() { return helper::mpf_literal<256, Cs...>(); }
+template <char... Cs> inline mpf_class operator"" _mpf512() { return helper::mpf_literal<512, Cs...>(); }
+template <char... Cs> inline mpf_class operator"" _mpf1024() { return helper::mpf_literal<1024, Cs...>(); }
+template <char... Cs> inline mpf_class operator"" _mpf2048() { return helper::mpf_literal<2048, Cs...>(); }
+template <char... Cs> inline mpf_class operator"" _mpf4096() { return helper::mpf_literal<4096, Cs...>(); }
 #else
 inline gmpxx::mpz_class operator"" _mpz(unsigned long long int val) {
     if constexpr (___gmpxx_mkII___ullong_is_same_as_uint64_v || ___gmpxx_mkII___ullong_is_greater_than_uint64_v) {
@@ -4799,6 +8664,13 @@ inline gmpxx::mpf_class operator"" _mpf(long double val) {
     }
     return gmpxx::mpf_class(static_cast<double>(val));
 }
+// exact to the precision of the suffix, converted at compile time: 3.14159265358979323846264338327950288_mpf512
+template <char... Cs> inline gmpxx::mpf_class operator"" _mpf128() { return gmpxx::helper::mpf_literal<128, Cs...>(); }
+template <char... Cs> inline gmpxx::mpf_class operator"" _mpf256() { return gmpxx::helper::mpf_literal<256, Cs...>(); }
+template <char... Cs> inline gmpxx::mpf_class operator"" _mpf512() { return gmpxx::helper::mpf_literal<512, Cs...>(); }
+template <char... Cs> inline gmpxx::mpf_class operator"" _mpf1024() { return gmpxx::helper::mpf_literal<1024, Cs...>(); }
+template <char... Cs> inline gmpxx::mpf_class operator"" _mpf2048() { return gmpxx::helper::mpf_literal<2048, Cs...>(); }
+template <char... Cs> inline gmpxx::mpf_class operator"" _mpf4096() { return gmpxx::helper::mpf_literal<4096, Cs...>(); }
 #endif
 // in the manual, the following functions are avilable, but actually not.
 // cf. https://gmplib.org/manual/C_002b_002b-Interface-Rationals
@@ -4958,3 +8830,30 @@ class numeric_limits<gmpxx::mpf_class> {
 #endif
 };
 } // namespace std
+
+#if defined __cpp_lib_format
+namespace std { // std::format("{:.30f}", x)
+#if defined ___GMPXX_DONT_USE_NAMESPACE___
+template <> struct formatter<mpz_class> : helper::mpz_formatter<std::format_error> {};
+template <> struct formatter<mpq_class> : helper::mpq_formatter<std::format_error> {};
+template <> struct formatter<mpf_class> : helper::mpf_formatter<std::format_error> {};
+#else
+template <> struct formatter<gmpxx::mpz_class> : gmpxx::helper::mpz_formatter<std::format_error> {};
+template <> struct formatter<gmpxx::mpq_class> : gmpxx::helper::mpq_formatter<std::format_error> {};
+template <> struct formatter<gmpxx::mpf_class> : gmpxx::helper::mpf_formatter<std::format_error> {};
+#endif
+} // namespace std
+#endif
+#if defined FMT_VERSION
+namespace fmt { // fmt::format("{:.30f}", x); include <fmt/format.h> first or define ___GMPXX_MKII_USE_FMT___
+#if defined ___GMPXX_DONT_USE_NAMESPACE___
+template <> struct formatter<mpz_class> : helper::mpz_formatter<fmt::format_error> {};
+template <> struct formatter<mpq_class> : helper::mpq_formatter<fmt::format_error> {};
+template <> struct formatter<mpf_class> : helper::mpf_formatter<fmt::format_error> {};
+#else
+template <> struct formatter<gmpxx::mpz_class> : gmpxx::helper::mpz_formatter<fmt::format_error> {};
+template <> struct formatter<gmpxx::mpq_class> : gmpxx::helper::mpq_formatter<fmt::format_error> {};
+template <> struct formatter<gmpxx::mpf_class> : gmpxx::helper::mpf_formatter<fmt::format_error> {};
+#endif
+} // namespace fmt
+#endif
@@ -0,0 +1,27 @@
+/* The mpz, mpq and mpf trace functions of the GMP test library that t-istream
+   uses to report a failure.  GMP's tests/trace.c also prints in hex when the
+   global mp_trace_base asks for it and traces mpn operands; this keeps to
+   decimal and to the three types the tests here use.  */
+
+#include <stdio.h>
+
+#include "gmp-impl.h"
+#include "tests.h"
+
+void
+mpz_trace (const char *name, mpz_srcptr z)
+{
+  gmp_printf ("%s=%Zd\n", name, z);
+}
+
+void
+mpq_trace (const char *name, mpq_srcptr q)
+{
+  gmp_printf ("%s=%Qd\n", name, q);
+}
+
+void
+mpf_trace (const char *name, mpf_srcptr f)
+{
+  gmp_printf ("%s=%.*Fg (prec %lu)\n", name, (int) (mpf_get_prec (f) * 0.30103) + 2, f, (unsigned long) mpf_get_prec (f));
+}
@@ -28,10 +28,19 @@
 #include <cmath>
 #include <vector>
 #include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <locale>
+#include <random>
+#include <thread>
 
 #if defined USE_ORIGINAL_GMPXX
 #include <gmpxx.h>
 #else
+#if !(__cplusplus >= 202002L && __has_include(<format>)) && __has_include(<fmt/format.h>)
+#define FMT_HEADER_ONLY
+#include <fmt/format.h>
+#endif
 #include "gmpxx_mkII.h"
 #if !defined ___GMPXX_STRICT_COMPATIBILITY___
 using namespace gmpxx;
@@ -2140,6 +2149,70 @@ void test_mpq_class_functions() {
 #endif
     std::cout << "test_mpq_class_functions passed." << std::endl;
 }
+void test_istream_extraction() {
+    // several values from one stream; each read stops right before the delimiter
+    {
+        std::istringstream input("1.5 -2.25e1\n+.5e-1 3");
+        mpf_class a, b, c, d;
+        input >> a >> b >> c >> d;
+        assert(!input.fail() && input.eof());
+        assert(a == 1.5 && b == -22.5 && c == mpf_class("0.05") && d == 3);
+    }
+    {
+        std::istringstream input("123 -0x1f 017 8/12");
+        mpz_class a, b, c;
+        mpq_class q;
+        input >> a;
+        assert(a == 123 && input.tellg() == 3);
+        input.flags(std::ios_base::fmtflags(0));
+        input >> std::ws >> b >> std::ws >> c >> std::ws >> q;
+        assert(!input.fail() && input.eof());
+        assert(b == -31 && c == 15);
+        assert(q.get_num() == 8 && q.get_den() == 12);
+    }
+    // failure stops at the offending character
+    {
+        std::istringstream input("1e+-3");
+        mpf_class a;
+        input >> a;
+        assert(input.fail() && !input.eof());
+        input.clear();
+        assert(input.tellg() == 3);
+    }
+    {
+        std::istringstream input("7/x");
+        mpq_class q;
+        input >> q;
+        assert(input.fail());
+        input.clear();
+        assert(input.tellg() == 2);
+    }
+    // tokens longer than the stack buffer
+    {
+        std::string digits(1000, '9');
+        std::istringstream input(digits + " " + digits + ".5");
+        mpz_class a;
+        mpf_class b(0, 4096);
+        input >> a >> b;
+        assert(!input.fail());
+        assert(a == mpz_class(digits));
+        assert(b == mpf_class(digits + ".5", 4096));
+    }
+    // the decimal point comes from the stream's locale
+    {
+        struct comma : std::numpunct<char> {
+            char do_decimal_point() const override { return ','; }
+        };
+        std::istringstream input("1,5 -2,25e1 3.5");
+        input.imbue(std::locale(input.getloc(), new comma));
+        mpf_class a, b, c;
+        input >> a >> b >> c;
+        assert(!input.fail() && a == 1.5 && b == -22.5 && c == 3);
+        input.clear();
+        assert(input.peek() == '.');
+    }
+    std::cout << "test_istream_extraction passed." << std::endl;
+}
 void test_mpz_class_comparison_int() {
     mpz_class a = 3;
     mpz_class b = 5;
@@ -2352,6 +2425,13 @@ void test_log_mpf_class(void) {
     }
     std::cout << "log10 matched in " << i - 1 << " decimal digits" << std::endl;
     assert(i - 1 > decimal_digits - 4 && "not accurate");
+    {
+        // x larger than 2^(prec/2)
+        mpf_class y = 1, tolerance = 1;
+        y.mul_2exp(mpf_get_default_prec() + 200);
+        tolerance.div_2exp(mpf_get_default_prec() - 16);
+        assert(abs(log(y) / (mpf_get_default_prec() + 200) - const_log2()) < tolerance);
+    }
     std::cout << "test_log_mpf_class passed." << std::endl;
 #endif
 }
@@ -2563,6 +2643,1294 @@ void test_precisions_mixed() {
     std::cout << "test_precisions_mixed passed." << std::endl;
 #endif
 }
+void test_text_io() {
+#if !defined USE_ORIGINAL_GMPXX
+    const char *path = "test_gmpxx_mkII_text_io.txt";
+    auto write_file = [&](const char *text) {
+        std::ofstream file(path);
+        file << text;
+    };
+    // plain and Matrix Market round trips
+    {
+        mpf_matrix A(3, 4);
+        const double values[] = {1.5, -0.25, 0, 3, 1024, -7.125, 0, 0, 0.5, 2, -1, 1e-3};
+        for (std::size_t k = 0; k < A.size(); k++)
+            A.data()[k] = values[k];
+        for (auto format : {text_format::plain, text_format::matrix_market_array, text_format::matrix_market_coordinate}) {
+            save_text(path, A, format);
+            mpf_matrix B;
+            load_text(path, B);
+            assert(B.rows() == 3 && B.cols() == 4);
+            for (std::size_t j = 0; j < 4; j++)
+                for (std::size_t i = 0; i < 3; i++)
+                    assert(B(i, j) == A(i, j) || (i == 2 && j == 3 && abs(B(i, j) - A(i, j)) < 1e-150));
+        }
+    }
+    // random values read back to the working precision
+    {
+        gmp_randclass r(gmp_randinit_default);
+        mpf_vector x(1000, 512);
+        for (auto &e : x)
+            e = (r.get_f(512) - 0.5) * 1e20;
+        save_text(path, x);
+        mpf_vector y(0, 512);
+        load_text(path, y);
+        assert(y.size() == x.size());
+        for (std::size_t i = 0; i < x.size(); i++)
+            assert(abs((x[i] - y[i]) / x[i]) < mpf_class("1e-150"));
+    }
+    // Matrix Market input with comments, integer field and symmetric storage
+    {
+        write_file("%%MatrixMarket matrix coordinate integer symmetric\n% comment\n%\n3 3 4\n1 1 2\n2 1 -1\n3 2 -1\n3 3 2\n");
+        mpf_matrix A;
+        load_text(path, A);
+        assert(A.rows() == 3 && A.cols() == 3);
+        assert(A(0, 0) == 2 && A(1, 0) == -1 && A(0, 1) == -1 && A(2, 1) == -1 && A(1, 2) == -1 && A(2, 2) == 2);
+        assert(A(1, 1) == 0 && A(2, 0) == 0 && A(0, 2) == 0);
+
+        write_file("%%MatrixMarket matrix array real general\n2 3\n1\n2\n3\n4\n5.5e1\n6\n");
+        load_text(path, A);
+        assert(A.rows() == 2 && A.cols() == 3);
+        assert(A(0, 0) == 1 && A(1, 0) == 2 && A(0, 1) == 3 && A(1, 1) == 4 && A(0, 2) == 55 && A(1, 2) == 6);
+
+        write_file("%%MatrixMarket matrix array real symmetric\n2 2\n1\n2\n3\n");
+        load_text(path, A);
+        assert(A(0, 0) == 1 && A(1, 0) == 2 && A(0, 1) == 2 && A(1, 1) == 3);
+    }
+    // plain vectors take any layout, plain matrices one row per line
+    {
+        write_file("# vector\n1 2\n3\n\n  4\t5");
+        mpf_vector x;
+        load_text(path, x);
+        assert(x.size() == 5 && x[0] == 1 && x[4] == 5);
+
+        // the column count comes from the first data line after comments and blank lines
+        write_file("# matrix\n\n  \t\n1 2\n3 4\n# 5 6 7\n5 6");
+        mpf_matrix A;
+        load_text(path, A);
+        assert(A.rows() == 3 && A.cols() == 2 && A(0, 1) == 2 && A(2, 0) == 5);
+
+        write_file("1 2 3\n4 5\n");
+        bool thrown = false;
+        try {
+            load_text(path, A);
+        } catch (const std::runtime_error &) {
+            thrown = true;
+        }
+        assert(thrown);
+
+        write_file("1 2 x\n");
+        thrown = false;
+        try {
+            load_text(path, A);
+        } catch (const std::runtime_error &) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+    std::remove(path);
+    std::cout << "test_text_io passed." << std::endl;
+#endif
+}
+void test_first_touch() {
+#if !defined USE_ORIGINAL_GMPXX
+    // large enough to be initialized in parallel when compiled with OpenMP
+    const std::size_t n = 1 << 15;
+    mpf_vector x(n, 256);
+    for (std::size_t i = 0; i < n; i++)
+        x[i] = static_cast<double>(i) / 8;
+    x.first_touch();
+    mpf_vector y = x;
+    y.set_prec(512);
+    for (std::size_t i = 0; i < n; i += 97)
+        assert(x[i] == static_cast<double>(i) / 8 && y[i] == x[i] && x[i].get_prec() == 256 && y[i].get_prec() == 512);
+    mpf_matrix A(256, 128, 128);
+    for (std::size_t j = 0; j < A.cols(); j++)
+        for (std::size_t i = 0; i < A.rows(); i++)
+            A(i, j) = static_cast<double>(i) - static_cast<double>(j);
+    A.first_touch();
+    mpf_matrix B;
+    B = A;
+    assert(B.rows() == 256 && B.cols() == 128 && B(255, 0) == 255 && B(0, 127) == -127);
+    // limbs moved out of a container outlive it
+    mpf_class kept, moved;
+    {
+        mpf_vector z(1 << 16, 512);
+        z[5] = 3;
+        z[6] = 4;
+        kept = std::move(z[5]);
+        moved = z[6] * 2;
+        z[7] = moved;
+        z[8] = std::move(moved);
+        moved = std::move(z[6]);
+        z.set_prec(1024);
+        mpf_vector w = z;
+        assert(w[8] == 8 && w[7] == 8);
+#if defined ___GMPXX_MKII_USE_HUGEPAGES___
+        // no element of w fits the blocks of the arena of z, so w takes none, and copies do not use up the arena slots
+        helper::limb_arenas &arenas = helper::limb_arenas::instance();
+        assert(arenas.find(w[0].get_mpf_t()->_mp_d) < 0);
+        for (int k = 0; k < 100; k++) {
+            mpf_vector copy = z;
+            assert(copy[8] == 8);
+        }
+        z[0].set_prec(512);
+        z[1] = 1;
+        for (int k = 0; k < 100; k++) {
+            mpf_vector copy = z;
+            assert(copy[1] == 1 && arenas.find(copy[0].get_mpf_t()->_mp_d) >= 0 && arenas.find(copy[1].get_mpf_t()->_mp_d) < 0);
+        }
+        mpf_vector fresh(1 << 16, 512);
+        assert(arenas.find(fresh[0].get_mpf_t()->_mp_d) >= 0);
+#endif
+    }
+    assert(kept == 3 && moved == 4);
+    std::cout << "test_first_touch passed." << std::endl;
+#endif
+}
+void test_compact_vector() {
+#if !defined USE_ORIGINAL_GMPXX
+    const mp_bitcnt_t prec = 512;
+    const std::size_t n = 1000;
+    mpf_compact_vector x(n, prec);
+    mpf_vector y(n, prec);
+    for (std::size_t i = 0; i < n; i++) {
+        if (i % 2 == 0)
+            y[i] = static_cast<double>(i) - 0.5;
+        else
+            y[i] = -static_cast<long>(i * 12345);
+        x.set(i, y[i]);
+    }
+    for (std::size_t i = 0; i < n; i++) {
+        assert(x[i] == y[i]);
+        assert(x.limb_count(i) <= 2);
+    }
+    x.shrink_to_fit();
+    assert(x.memory_usage() * 2 < n * (sizeof(mpf_class) + (prec / GMP_NUMB_BITS + 2) * sizeof(mp_limb_t)));
+    // elements grow on write and keep the precision of the vector
+    gmp_randclass r(gmp_randinit_default);
+    r.seed(56);
+    for (std::size_t i = 0; i < n; i += 3) {
+        mpf_class t = r.get_f(1024) * 3;
+        mpf_set(y[i].get_mpf_t(), t.get_mpf_t());
+        x.set(i, t);
+    }
+    x.set(1, mpf_class(0));
+    y[1] = 0;
+    for (std::size_t i = 0; i < n; i++)
+        assert(x[i] == y[i] && x.get(i).get_prec() == y[i].get_prec());
+    mpf_class wide(1, 2048);
+    wide = wide / 3;
+    x.set(2, wide);
+    mpf_set(y[2].get_mpf_t(), wide.get_mpf_t());
+    assert(x[2] == y[2]);
+    x.shrink_to_fit();
+    mpf_vector z = x.to_vector();
+    mpf_compact_vector w(z);
+    for (std::size_t i = 0; i < n; i++)
+        assert(z[i] == y[i] && w[i] == y[i]);
+    std::cout << "test_compact_vector passed." << std::endl;
+#endif
+}
+void test_radix_conversion() {
+#if !defined USE_ORIGINAL_GMPXX
+    // large values go through the divide and conquer converter; results must agree with GMP digit for digit
+    auto gmp_get_str = [](mp_exp_t &exp, int base, size_t digits, mpf_srcptr op) {
+        char *temp = mpf_get_str(nullptr, &exp, base, digits, op);
+        std::string result = temp;
+        void (*freefunc)(void *, size_t);
+        mp_get_memory_functions(nullptr, nullptr, &freefunc);
+        freefunc(temp, std::strlen(temp) + 1);
+        return result;
+    };
+    gmp_randclass r(gmp_randinit_default);
+    r.seed(53);
+    for (mp_bitcnt_t prec : {16384, 65536}) {
+        for (int base : {10, 2, 7, 16, -16, 62}) {
+            for (long shift : {0L, 12345L, -12345L}) {
+                mpf_class x(r.get_f(prec), prec);
+                x = -x;
+                if (shift >= 0)
+                    mpf_mul_2exp(x.get_mpf_t(), x.get_mpf_t(), shift);
+                else
+                    mpf_div_2exp(x.get_mpf_t(), x.get_mpf_t(), -shift);
+                for (size_t digits : {0, 3000}) {
+                    mp_exp_t exp0, exp1;
+                    std::string expected = gmp_get_str(exp0, base, digits, x.get_mpf_t());
+                    std::string result = x.get_str(exp1, base, digits);
+                    assert(result == expected && exp0 == exp1);
+                    if (digits != 0)
+                        continue;
+                    // and back: all the digits of x parse to within its precision
+                    std::string text = "-0." + result.substr(1) + "@" + mpz_class(exp1).get_str(base < 0 ? 10 : base);
+                    mpf_class y(0, prec);
+                    assert(y.set_str(text, base) == 0);
+                    mpf_class diff(abs(x - y) / abs(x), prec);
+                    mpf_class tolerance(1, prec);
+                    mpf_div_2exp(tolerance.get_mpf_t(), tolerance.get_mpf_t(), prec - 2);
+                    assert(diff <= tolerance);
+                }
+            }
+        }
+    }
+    {
+        // rounding carries into a new leading digit: 0.999...9 rounds to 0.1@1
+        mpf_class x(1, 16384);
+        mpf_class eps(1, 16384);
+        mpf_div_2exp(eps.get_mpf_t(), eps.get_mpf_t(), 16000);
+        x -= eps;
+        mp_exp_t exp;
+        assert(x.get_str(exp, 10, 4000) == "1" && exp == 1);
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(3000) << x;
+        assert(ss.str() == "1." + std::string(3000, '0'));
+    }
+    {
+        // the lowest limb of a value that is not limb aligned takes part in the rounding
+        mpf_class x(0, 20000);
+        mpz_class p;
+        mpz_ui_pow_ui(p.get_mpz_t(), 62, 4000);
+        mpf_set_z(x.get_mpf_t(), p.get_mpz_t());
+        mpf_class eps(x, 20000);
+        mpf_div_2exp(eps.get_mpf_t(), eps.get_mpf_t(), 10003);
+        x -= eps;
+        mp_exp_t exp0, exp1;
+        assert(x.get_str(exp1, 62) == gmp_get_str(exp0, 62, 0, x.get_mpf_t()) && exp0 == exp1);
+    }
+    {
+        std::string text(5000, '7');
+        mpf_class x(0, 16384);
+        assert(x.set_str(text + "e-4999", 10) == 0);
+        assert(x > mpf_class(7.7) && x < mpf_class(7.8));
+        assert(x.set_str(text + "e", 10) == -1);
+        assert(x.set_str("- " + text, 10) == -1 && x.set_str(text + " e5", 10) == 0 && x.set_str(text + "e 5", 10) == -1);
+        std::istringstream in(text + ".5 next");
+        mpf_class y(0, 16384);
+        in >> y;
+        assert(!in.fail() && y > mpf_class("7.7e4999"));
+        // exponents far beyond the digits scale at the working precision instead of computing 10^exponent exactly
+        for (const char *exponent : {"e30000000", "e-30000000", "e300000000000000", "e-300000000000000"}) {
+            std::string huge = "1." + std::string(2100, '3') + exponent;
+            mpf_class z(0, 1024), reference(0, 1024);
+            assert(mpf_set_str_dc(z.get_mpf_t(), huge.c_str(), 10) == 0 && mpf_set_str(reference.get_mpf_t(), huge.c_str(), 10) == 0);
+            mpf_class tolerance(abs(reference), 1024);
+            mpf_div_2exp(tolerance.get_mpf_t(), tolerance.get_mpf_t(), 1020);
+            assert(abs(z - reference) <= tolerance);
+        }
+    }
+    clear_radix_cache();
+    std::cout << "test_radix_conversion passed." << std::endl;
+#endif
+}
+void test_hexfloat_io() {
+#if !defined USE_ORIGINAL_GMPXX
+    {
+        // same text as for double
+        const double values[] = {12.0, -0.1, 0.0, 1.0 / 1024, 3.0e300, -5.0e-300};
+        for (double d : values) {
+            std::stringstream expected, result;
+            expected << std::hexfloat << d;
+            result << std::hexfloat << mpf_class(d);
+            assert(result.str() == expected.str());
+        }
+        std::stringstream ss;
+        ss << std::hexfloat << std::uppercase << std::showpos << std::setw(12) << mpf_class(12);
+        assert(ss.str() == "   +0X1.8P+3");
+    }
+    {
+        // exact round trips
+        gmp_randclass r(gmp_randinit_default);
+        r.seed(54);
+        for (mp_bitcnt_t prec : {64, 512, 4096, 100000}) {
+            for (long shift : {0L, 777L, -777L}) {
+                mpf_class x(r.get_f(prec), prec);
+                x = -x;
+                if (shift >= 0)
+                    mpf_mul_2exp(x.get_mpf_t(), x.get_mpf_t(), shift);
+                else
+                    mpf_div_2exp(x.get_mpf_t(), x.get_mpf_t(), -shift);
+                std::stringstream ss;
+                ss << std::hexfloat << x << " " << x;
+                mpf_class y(0, prec), z(0, prec);
+                ss >> std::hexfloat >> y >> std::hex >> z;
+                assert(y == x && z == x);
+                mpf_class w(0, prec);
+                assert(mpf_set_hexfloat(w.get_mpf_t(), mpf_get_hexfloat(x.get_mpf_t(), true).c_str()) == 0 && w == x);
+            }
+        }
+        // results of arithmetic use all _mp_prec + 1 limbs and are not limb aligned like r.get_f()
+        for (mp_bitcnt_t prec : {64, 100, 128, 200, 256, 512, 1000}) {
+            mpf_class third(1, prec), tiny("1e-5", prec);
+            third /= 3;
+            mpf_class product(third * tiny, prec), mixed(product * product * product + third, prec);
+            for (const mpf_class &x : {third, tiny, product, mixed, mpf_class(-mixed * 1e300, prec), mpf_class(product / 1e300, prec)}) {
+                mpf_class y(0, prec);
+                assert(mpf_set_hexfloat(y.get_mpf_t(), mpf_get_hexfloat(x.get_mpf_t()).c_str()) == 0 && y == x);
+                std::stringstream ss;
+                ss << std::hexfloat << x;
+                mpf_class z(0, prec);
+                ss >> std::hexfloat >> z;
+                assert(!ss.fail() && z == x);
+            }
+        }
+    }
+    {
+        mpf_class x;
+        std::istringstream in("0x1.8p+3 -1P-1 ff.8 .8 0x");
+        in >> std::hexfloat >> x;
+        assert(x == 12);
+        in >> x;
+        assert(x == -0.5);
+        in >> x;
+        assert(x == 255.5);
+        in >> x;
+        assert(x == 0.5);
+        // "0x" without digits is not a number
+        in >> x;
+        assert(in.fail());
+        std::istringstream bad("0x1p z");
+        bad >> std::hexfloat >> x;
+        assert(bad.fail());
+        assert(mpf_set_hexfloat(x.get_mpf_t(), "0x1.8p") == -1 && mpf_set_hexfloat(x.get_mpf_t(), "1.g") == -1 && mpf_set_hexfloat(x.get_mpf_t(), "0x") == -1);
+        // exponents that do not fit in a long
+        assert(mpf_set_hexfloat(x.get_mpf_t(), "0x1p99999999999999999999") == -1 && mpf_set_hexfloat(x.get_mpf_t(), "0x1p-99999999999999999999") == -1);
+        // the positional std::hex output has an exponent this format does not read: fail instead of a wrong value
+        for (const mpf_class &v : {mpf_class("1e30"), mpf_class("1e-30")}) {
+            for (auto scientific : {false, true}) {
+                std::stringstream ss;
+                ss << std::hex;
+                if (scientific)
+                    ss << std::scientific;
+                ss << v;
+                // small values print positionally, without an exponent, and read back as the digits shown
+                bool has_exponent = ss.str().find_first_of("@+-") != std::string::npos;
+                ss >> std::hex >> x;
+                assert(ss.fail() == has_exponent);
+                assert(has_exponent || abs(x / v - 1) < 1e-5);
+            }
+        }
+        // digits beyond the precision are truncated
+        mpf_class y(0, 64);
+        assert(mpf_set_hexfloat(y.get_mpf_t(), ("0x1." + std::string(100, 'f') + "p0").c_str()) == 0);
+        assert(y < 2 && y > 1.99);
+        std::istringstream oct("1");
+        bool thrown = false;
+        try {
+            oct >> std::oct >> x;
+        } catch (const std::runtime_error &) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+    std::cout << "test_hexfloat_io passed." << std::endl;
+#endif
+}
+void test_format() {
+#if !defined USE_ORIGINAL_GMPXX && (defined __cpp_lib_format || defined FMT_VERSION)
+#if defined __cpp_lib_format
+    auto format = [](auto spec, const auto &x) { return std::vformat(spec, std::make_format_args(x)); };
+    using format_error = std::format_error;
+#else
+    auto format = [](auto spec, const auto &x) { return fmt::format(fmt::runtime(spec), x); };
+    using format_error = fmt::format_error;
+#endif
+    {
+        // the same text as for double (ties go to even)
+        const double values[] = {0.0, 1.5, -2.0 / 3, 12345.678, 1e-5, 0.125, 2.5, -1e20, 6.02214076e23};
+        const char *specs[] = {"{}", "{:.3f}", "{:+12.4e}", "{:<10g}", "{:^#12.0f}", "{:010.2f}", "{:.0f}", "{:.2f}", "{:G}", "{:.17g}", "{: .5E}", "{:*>20.10f}"};
+        for (double d : values) {
+            for (const char *spec : specs) {
+                std::string expected = format(spec, d);
+                if (std::strcmp(spec, "{}") == 0) {
+                    char buf[64];
+                    std::snprintf(buf, sizeof(buf), "%g", d);
+                    expected = buf;
+                }
+                assert(format(spec, mpf_class(d)) == expected);
+            }
+        }
+    }
+    {
+        // digits beyond the precision are those of the binary value
+        mpf_class x(1, 64);
+        x /= 3;
+        assert(format("{:.45f}", x) == "0.333333333333333333333333333333333333332353755");
+        assert(format("{:.40e}", mpf_class("1e100", 512)) == "1.0000000000000000000000000000000000000000e+100");
+        assert(format("{:.3f}", mpf_class("0.0004999", 128)) == "0.000");
+        assert(format("{:.3f}", mpf_class("0.0005001", 128)) == "0.001");
+        // as std::format for double: no 0x prefix
+        assert(format("{:a}", mpf_class(-12)) == "-1.8p+3" && format("{:A}", x) == "1.55555555555555555555555555555554P-2");
+        // more digits than the stack buffer holds
+        mpf_class third(1, 2048);
+        third /= 3;
+        std::string text = format("{:.500f}", -third);
+        assert(text.size() == 503 && text.compare(0, 3, "-0.") == 0 && text.find_first_not_of('3', 3) == std::string::npos);
+    }
+    {
+        const long long values[] = {0, 1, -1, 255, -255, 1234567890123LL};
+        const char *specs[] = {"{}", "{:+}", "{: }", "{:#x}", "{:#X}", "{:#b}", "{:#o}", "{:010}", "{:#010x}", "{:>8}", "{:*<8d}", "{:^9x}"};
+        for (long long v : values)
+            for (const char *spec : specs)
+                assert(format(spec, mpz_class(static_cast<long>(v))) == format(spec, v));
+        assert(format("{}", mpz_class("-123456789012345678901234567890")) == "-123456789012345678901234567890");
+        assert(format("{:>8}", mpq_class(-3, 4)) == "    -3/4" && format("{:#x}", mpq_class(255, 16)) == "0xff/0x10");
+        // zero padding goes after the base prefix of the numerator, as for mpz_class
+        assert(format("{:#012x}", mpq_class(-255, 7)) == "-0x000ff/0x7" && format("{:#012x}", mpz_class(-255)) == "-0x0000000ff");
+        assert(format("{:#014b}", mpq_class(5, 3)) == "0b0000101/0b11" && format("{:#08o}", mpq_class(-5, 9)) == "-005/011");
+        std::string many(300, '7');
+        assert(format("{:#x}", mpq_class(mpz_class(many), mpz_class(1000))) == "0x" + mpz_class(many).get_str(16) + "/0x3e8");
+    }
+    {
+        bool thrown = false;
+        try {
+            format("{:.3d}", mpz_class(1));
+        } catch (const format_error &) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+    std::cout << "test_format passed." << std::endl;
+#endif
+}
+void test_mpz_small() {
+#if !defined USE_ORIGINAL_GMPXX
+    // the same results with and without -D___GMPXX_MKII_MPZ_SMALL___; in small value mode these run on the inline limb
+    {
+        mpz_class a(7), b(-3);
+        assert(a + b == 4 && a - b == 10 && a * b == -21);
+        // truncating division, as mpz_tdiv_q/mpz_tdiv_r
+        assert(a / b == -2 && a % b == 1 && (-a) % b == -1 && (-a) / b == 2);
+        assert(b < a && a > b && b <= b && a >= a && a != b && !(a == b));
+    }
+    {
+        // overflow of the int64_t fast path goes to GMP
+        mpz_class a(std::numeric_limits<int64_t>::max()), c(a);
+        a += 1;
+        assert(a == mpz_class("9223372036854775808"));
+        a *= a;
+        assert(a == mpz_class("85070591730234615865843651857942052864"));
+        a /= mpz_class("9223372036854775808");
+        a -= 1;
+        assert(a == c);
+        // aliasing growth past one limb
+        mpz_class x(1);
+        for (int i = 0; i < 200; i++)
+            x += x;
+        mpz_class y;
+        mpz_ui_pow_ui(y.get_mpz_t(), 2, 200);
+        assert(x == y);
+        x *= x;
+        mpz_mul(y.get_mpz_t(), y.get_mpz_t(), y.get_mpz_t());
+        assert(x == y);
+        x = 5;
+        assert(x == 5);
+    }
+    {
+        // moves and swaps between inline and heap values
+        mpz_class big("123456789012345678901234567890"), small(42);
+        swap(big, small);
+        assert(small == mpz_class("123456789012345678901234567890") && big == 42);
+        big.swap(small);
+        assert(big == mpz_class("123456789012345678901234567890") && small == 42);
+        mpz_class m(std::move(small));
+        assert(m == 42);
+        m = std::move(big);
+        assert(m == mpz_class("123456789012345678901234567890"));
+        std::vector<mpz_class> v;
+        for (int i = 0; i < 1000; i++)
+            v.push_back(mpz_class(i) * ((i % 2) ? mpz_class(1) : mpz_class("1000000000000000000000")));
+        for (int i = 0; i < 1000; i++)
+            assert(v[i] == mpz_class(i) * ((i % 2) ? mpz_class(1) : mpz_class("1000000000000000000000")));
+    }
+    {
+        // binomial coefficients by Pascal's rule, all small
+        std::vector<mpz_class> row(1, mpz_class(1));
+        for (int n = 1; n <= 60; n++) {
+            row.push_back(0);
+            for (int k = n; k > 0; k--)
+                row[k] += row[k - 1];
+        }
+        mpz_class c;
+        mpz_bin_uiui(c.get_mpz_t(), 60, 30);
+        assert(row[30] == c);
+    }
+    std::cout << "test_mpz_small passed." << std::endl;
+#endif
+}
+void test_mpq_small() {
+#if !defined USE_ORIGINAL_GMPXX
+    // the same results with and without -D___GMPXX_MKII_MPQ_SMALL___; in small value mode these run on the inline limbs
+    {
+        mpq_class a(3, 7), b(-5, 14);
+        assert(a + b == mpq_class(1, 14) && a - b == mpq_class(11, 14));
+        assert(a * b == mpq_class(-15, 98) && a / b == mpq_class(-6, 5));
+        assert(b < a && a > b && a <= a && b >= b && a != b && !(a == b));
+        mpq_class c = a - a;
+        assert(c == 0 && mpz_cmp_ui(c.get_den_mpz_t(), 1) == 0);
+        c = a / mpq_class(-3, 7);
+        assert(c == -1 && mpz_cmp_ui(c.get_den_mpz_t(), 1) == 0);
+    }
+    {
+        // overflow of the 128-bit fast path goes to GMP and comes back when the result is small again
+        int64_t big = std::numeric_limits<int64_t>::max();
+        mpq_class a(big, int64_t(3)), b(int64_t(1), big - 1);
+        mpq_class sum = a + b, expected;
+        mpq_set_str(expected.get_mpq_t(), "9452287970026068426463726194153080605/3074457345618258602", 10);
+        mpq_canonicalize(expected.get_mpq_t());
+        assert(sum == expected);
+        mpq_class p = a;
+        p *= a;
+        p *= a;
+        mpq_class q(big);
+        mpz_pow_ui(mpq_numref(q.get_mpq_t()), mpq_numref(q.get_mpq_t()), 3);
+        q /= 27;
+        assert(p == q);
+        p /= a;
+        p /= a;
+        assert(p == a);
+        a += a;
+        assert(a == mpq_class(big, int64_t(3)) * 2);
+    }
+    {
+        // moves, swaps and mpq_inv, which exchanges the numerator and denominator limbs
+        mpq_class x(2, 9), y("123456789012345678901234567890/7");
+        swap(x, y);
+        assert(y == mpq_class(2, 9) && x == mpq_class("123456789012345678901234567890/7"));
+        mpq_inv(y.get_mpq_t(), y.get_mpq_t());
+        assert(y == mpq_class(9, 2));
+        x.swap(y);
+        assert(x == mpq_class(9, 2));
+        mpq_class m(std::move(x));
+        m += mpq_class(1, 2);
+        assert(m == 5);
+        std::vector<mpq_class> v;
+        for (int i = 1; i <= 500; i++)
+            v.push_back(mpq_class(1, i));
+        mpq_class h;
+        for (const auto &e : v)
+            h += e;
+        assert(h > 6 && h < 7);
+    }
+    {
+        // Gaussian elimination on a small rational matrix: the 4x4 Hilbert matrix has determinant 1/6048000
+        const int n = 4;
+        std::vector<mpq_class> A(n * n);
+        for (int i = 0; i < n; i++)
+            for (int j = 0; j < n; j++)
+                A[i * n + j] = mpq_class(1, i + j + 1);
+        mpq_class det = 1;
+        for (int k = 0; k < n; k++) {
+            det *= A[k * n + k];
+            for (int i = k + 1; i < n; i++) {
+                mpq_class f = A[i * n + k] / A[k * n + k];
+                for (int j = k; j < n; j++)
+                    A[i * n + j] -= f * A[k * n + j];
+            }
+        }
+        assert(det == mpq_class(1, 6048000));
+    }
+    std::cout << "test_mpq_small passed." << std::endl;
+#endif
+}
+void test_mpq_accumulator() {
+#if !defined USE_ORIGINAL_GMPXX
+    for (std::size_t interval : {std::size_t(0), std::size_t(1), std::size_t(7), std::size_t(256)}) {
+        mpq_accumulator acc(interval);
+        mpq_class expected = 0;
+        for (int i = 1; i <= 300; i++) {
+            mpq_class term(i % 3 == 0 ? -1 : 1, i);
+            acc += term;
+            expected += term;
+            if (i % 5 == 0) {
+                mpq_class x(i, 4), y(7, i + 1);
+                acc.add_product(x, y);
+                acc -= mpq_class(1, 6);
+                expected += x * y;
+                expected -= mpq_class(1, 6);
+            }
+        }
+        assert(acc.get() == expected);
+        mpq_class r;
+        acc.get(r.get_mpq_t());
+        assert(mpq_equal(r.get_mpq_t(), expected.get_mpq_t()));
+        acc.canonicalize();
+        assert(acc.get() == expected);
+        acc.reset();
+        assert(acc.get() == 0);
+    }
+    {
+        // integer terms and repeated denominators
+        mpq_accumulator acc;
+        acc += mpq_class(3);
+        acc += mpq_class(1, 2);
+        acc += mpq_class(1, 2);
+        acc -= mpq_class(4);
+        assert(acc.get() == 0);
+    }
+    std::cout << "test_mpq_accumulator passed." << std::endl;
+#endif
+}
+#if !defined USE_ORIGINAL_GMPXX
+namespace {
+std::size_t gmp_allocations = 0;
+void *(*gmp_alloc_original)(std::size_t);
+void *counting_alloc(std::size_t size) {
+    gmp_allocations++;
+    return gmp_alloc_original(size);
+}
+} // namespace
+#endif
+void test_mixed_double_int() {
+#if !defined USE_ORIGINAL_GMPXX
+    mpf_class x(3.0, 256), y(0.0, 256);
+    // in place arithmetic with doubles and integers does not allocate
+    void *(*realloc_func)(void *, std::size_t, std::size_t);
+    void (*free_func)(void *, std::size_t);
+    mp_get_memory_functions(&gmp_alloc_original, &realloc_func, &free_func);
+    mp_set_memory_functions(counting_alloc, realloc_func, free_func);
+    gmp_allocations = 0;
+    x *= 0.5;
+    x += 1;
+    x -= -2.25;
+    x /= 0.125;
+    x += -1;
+    x *= 3U;
+    x -= 0.1f;
+    bool compared = (x > 0.5) && cmp(x, 1e300) < 0 && cmp(-1e300, x) < 0;
+    std::size_t allocations = gmp_allocations;
+    mp_set_memory_functions(gmp_alloc_original, realloc_func, free_func);
+    assert(allocations == 0 && compared);
+    mpf_set_d(y.get_mpf_t(), ((3.0 * 0.5 + 1 + 2.25) / 0.125 - 1) * 3);
+    y -= mpf_class(0.1f, 256);
+    assert(x == y);
+    // exact double operands at any precision
+    mpf_class small(1.0, 32);
+    small += 0x1.0p-60;
+    assert(small > 1);
+    mpf_class z(2.0, 512);
+    assert(z * 0.5 == 1 && 0.5 * z == 1 && z - 0.5 == 1.5 && 0.5 - z == -1.5 && z / 0.5 == 4 && 0.5 / z == 0.25);
+    // mpf/mpq comparisons are exact
+    mpf_class third(1, 512);
+    third /= 3;
+    mpq_class q(1, 3);
+    assert(third != q && third < q && q > third && cmp(third, q) < 0 && cmp(q, third) > 0);
+    assert(mpf_class(0.75) == mpq_class(3, 4) && mpq_class(-3, 4) < mpf_class(0.0) && mpf_class(-1.0) < mpq_class(-3, 4));
+    std::cout << "test_mixed_double_int passed." << std::endl;
+#endif
+}
+#if !defined USE_ORIGINAL_GMPXX
+// |x - exact| <= ulp(x) / 2 for the limbs mpf_init2(prec) gives
+bool literal_rounded_to_nearest(const mpf_class &x, const char *exact_decimal, mp_bitcnt_t prec) {
+    mpq_class exact, error;
+    // the exact decimal as a rational: digits / 10^fraction_digits, times 10^exponent
+    std::string str(exact_decimal);
+    long exponent = 0;
+    std::size_t epos = str.find_first_of("eE");
+    if (epos != std::string::npos) {
+        exponent = std::stol(str.substr(epos + 1));
+        str = str.substr(0, epos);
+    }
+    std::size_t point = str.find('.');
+    if (point != std::string::npos) {
+        exponent -= static_cast<long>(str.size() - point - 1);
+        str.erase(point, 1);
+    }
+    mpz_class digits(str, 10), power;
+    mpz_ui_pow_ui(power.get_mpz_t(), 10, std::labs(exponent));
+    exact = (exponent >= 0) ? mpq_class(digits * power) : mpq_class(digits, power);
+    mpq_set_f(error.get_mpq_t(), x.get_mpf_t());
+    error -= exact;
+    error = abs(error);
+    // ulp: 2^(exp * GMP_NUMB_BITS - limbs * GMP_NUMB_BITS)
+    long limbs = static_cast<long>((prec + 2 * GMP_NUMB_BITS - 1) / GMP_NUMB_BITS);
+    mpq_class half_ulp(1);
+    long e2 = (x.get_mpf_t()->_mp_exp - limbs) * GMP_NUMB_BITS - 1;
+    if (e2 >= 0)
+        mpq_mul_2exp(half_ulp.get_mpq_t(), half_ulp.get_mpq_t(), e2);
+    else
+        mpq_div_2exp(half_ulp.get_mpq_t(), half_ulp.get_mpq_t(), -e2);
+    return error <= half_ulp;
+}
+#endif
+void test_precision_literals() {
+#if !defined USE_ORIGINAL_GMPXX
+    mpf_class pi = 3.14159265358979323846264338327950288419716939937510582097494459230781640628620899862803482534211706798214808651328230664709384460955058223172535940812848111745028410270193852110555964462294895493038196_mpf512;
+    assert(mpf_get_prec(pi.get_mpf_t()) == mpf_class(0.0, 512).get_prec());
+    assert(literal_rounded_to_nearest(pi, "3.14159265358979323846264338327950288419716939937510582097494459230781640628620899862803482534211706798214808651328230664709384460955058223172535940812848111745028410270193852110555964462294895493038196", 512));
+    assert(literal_rounded_to_nearest(0.1_mpf128, "0.1", 128));
+    assert(literal_rounded_to_nearest(0.3333333333333333333333333333333333333333333333333333333333_mpf256, "0.3333333333333333333333333333333333333333333333333333333333", 256));
+    assert(literal_rounded_to_nearest(1.5e-300_mpf1024, "1.5e-300", 1024));
+    assert(literal_rounded_to_nearest(6.02214076e23_mpf2048, "6.02214076e23", 2048));
+    assert(literal_rounded_to_nearest(0.000123456789_mpf4096, "0.000123456789", 4096));
+    // exact values, separators, signs and zero
+    assert(0.5_mpf128 == 0.5 && 123'456.5e3_mpf256 == 123456500 && -2.25_mpf512 == -2.25 && 0.0_mpf128 == 0 && 0e10_mpf256 == 0);
+    mpz_class p30;
+    mpz_ui_pow_ui(p30.get_mpz_t(), 10, 30);
+    assert(1e30_mpf128 == p30 && 1000000000000000000000000000000.0_mpf1024 == p30);
+    // rounding that carries into a new limb: 2^128 - 2^-100 rounds up to 2^128 at 128 bits
+    assert(340282366920938463463374607431768211455.99999999999999999999999999999_mpf128 == mpf_class("340282366920938463463374607431768211456", 256));
+    std::cout << "test_precision_literals passed." << std::endl;
+#endif
+}
+void test_mpf_basic() {
+#if !defined USE_ORIGINAL_GMPXX
+    mp_bitcnt_t p128 = mpf_class(0.0, 128).get_prec(), p512 = mpf_class(0.0, 512).get_prec(), pdef = mpf_class(0.0).get_prec();
+    {
+        mpf_basic<mpf_prec_max> a(1, 128), b(3, 512);
+        assert((a + b).get_prec() == p512 && (a - b).get_prec() == p512 && (b * a).get_prec() == p512 && (a / b).get_prec() == p512);
+        mpf_class ref = mpf_class(1, 512) / mpf_class(3, 512);
+        assert(a / b == ref);
+    }
+    {
+        mpf_basic<mpf_prec_left> a(1, 128), b(3, 512);
+        assert((a + b).get_prec() == p128 && (a / b).get_prec() == p128 && (b - a).get_prec() == p512 && (b * a).get_prec() == p512);
+        mpf_class ref(0, 128);
+        mpf_div(ref.get_mpf_t(), a.get_mpf_t(), b.get_mpf_t());
+        assert(a / b == ref);
+    }
+    {
+        mpf_basic<mpf_prec_default> a(1, 128), b(3, 512);
+        assert((a + b).get_prec() == pdef && (a - b).get_prec() == pdef && (a * b).get_prec() == pdef && (b / a).get_prec() == pdef);
+        assert((-b).get_prec() == p512 && -b == -3);
+    }
+    {
+        // compound and mixed operations, and passing to functions taking mpf_class
+        mpf_basic<mpf_prec_left> a(2, 128), b(0.5, 512);
+        a += b;
+        a *= b;
+        a -= 1;
+        a /= 2.0;
+        assert(a.get_prec() == p128 && a == 0.125);
+        mpf_basic<mpf_prec_left> c = sqrt(mpf_class(2, 128)) * 2;
+        assert(c.get_prec() == p128 && c == sqrt(mpf_class(8, 128)));
+        mpf_class d = a;
+        d = a + b;
+        assert(d == 0.625);
+        mpf_basic<mpf_prec_left> e = std::move(d);
+        assert(e == 0.625 && e.get_prec() == p128);
+    }
+    std::cout << "test_mpf_basic passed." << std::endl;
+#endif
+}
+#if !defined USE_ORIGINAL_GMPXX
+// |x - ref| <= 2^-bits |ref|
+bool dd_close_to(const dd_class &x, const mpf_class &ref, long bits) {
+    mpf_class err = abs(x.get_mpf_class(256) - ref), bound = abs(ref);
+    mpf_div_2exp(bound.get_mpf_t(), bound.get_mpf_t(), bits);
+    return err <= bound;
+}
+#endif
+void test_dd_class() {
+#if !defined USE_ORIGINAL_GMPXX
+    mpf_class one(1, 256), three(3, 256), two(2, 256);
+    dd_class third = dd_class(1) / dd_class(3);
+    assert(dd_close_to(third, one / three, 104));
+    assert(dd_close_to(third * 3, one, 104) && dd_close_to(third + third + third - 1 + 1, one, 104));
+    dd_class s = sqrt(dd_class(2));
+    assert(dd_close_to(s, sqrt(two), 104) && dd_close_to(s * s, two, 103));
+    // integers up to 64 bits are exact
+    assert(dd_class(9223372036854775807L).get_mpf_class(128) == mpf_class("9223372036854775807", 128));
+    assert(dd_class(-9223372036854775807L - 1).get_mpf_class(128) == mpf_class("-9223372036854775808", 128));
+    assert(dd_class(18446744073709551615UL).get_mpf_class(128) == mpf_class("18446744073709551615", 128));
+    // conversions from mpf_class and strings keep about 106 bits
+    mpf_class pi("3.14159265358979323846264338327950288419716939937510582097494459", 256);
+    dd_class dpi(pi);
+    assert(dd_close_to(dpi, pi, 105) && dpi.get_hi() == pi.get_d() && dpi.get_lo() != 0.0);
+    assert(dd_close_to(dd_class("3.14159265358979323846264338327950288419716939937510582097494459"), pi, 105));
+    assert(dd_close_to(dd_class(static_cast<mpf_class>(dpi)), pi, 105) && mpf_class(dpi) == dpi.get_mpf_class());
+    // comparisons look at the low part
+    dd_class a(1.0, 1e-20), b(1.0);
+    assert(a > b && b < a && a != b && a >= b && b <= a && !(a == b) && a - b == dd_class(1e-20));
+    assert(-a < b && abs(-a) == a && sgn(-a) == -1 && sgn(dd_class()) == 0 && a.get_prec() == 106);
+    // the two parts may come in either order
+    dd_class c(1e-20, 1.0);
+    assert(c == a && c.get_hi() == 1.0 && c.get_lo() == 1e-20 && dd_class(-1e-20, 1.0) == dd_class(1.0, -1e-20));
+    // mpf values beyond the double range saturate, tiny ones flush to zero
+    dd_class big(mpf_class("1e400")), nbig(mpf_class("-1e400")), tiny(mpf_class("1e-400"));
+    assert(std::isinf(big.get_hi()) && big.get_hi() > 0 && big.get_lo() == 0.0);
+    assert(std::isinf(nbig.get_hi()) && nbig.get_hi() < 0 && nbig.get_lo() == 0.0);
+    assert(tiny.get_hi() == 0.0 && tiny.get_lo() == 0.0 && std::isinf(dd_class("1e400").get_hi()));
+    mpf_class top(std::numeric_limits<double>::max(), 256);
+    mpf_class half_ulp(1, 256);
+    mpf_mul_2exp(half_ulp.get_mpf_t(), half_ulp.get_mpf_t(), 970);
+    dd_class near_top(mpf_class(top + half_ulp, 256));
+    assert(std::isinf(near_top.get_hi()) ? near_top.get_lo() == 0.0 : std::isfinite(near_top.get_lo()));
+    // a dot product of 1/i and i is exact-ish: n terms of 1
+    dd_class dot = 0;
+    for (int i = 1; i <= 1000; i++)
+        dot += (dd_class(1) / dd_class(i)) * dd_class(i);
+    assert(dd_close_to(dot, mpf_class(1000, 256), 100));
+    std::cout << "test_dd_class passed." << std::endl;
+#endif
+}
+#if !defined USE_ORIGINAL_GMPXX
+// |x - ref| <= 2^-bits max(|ref|, scale)
+bool batch_close_to(const mpf_class &x, const mpf_class &ref, long bits, const mpf_class &scale) {
+    mpf_class err = abs(x - ref), bound = std::max(abs(ref), scale);
+    mpf_div_2exp(bound.get_mpf_t(), bound.get_mpf_t(), bits);
+    return err <= bound;
+}
+#endif
+void test_mpf_batch() {
+#if !defined USE_ORIGINAL_GMPXX
+    const std::size_t n = 203;
+    gmp_randclass r(gmp_randinit_default);
+    r.seed(7);
+    mpf_batch<256> x(n), y(n), w(n), z(n);
+    std::vector<mpf_class> X(n), Y(n), W(n);
+    for (std::size_t i = 0; i < n; i++) {
+        X[i] = mpf_class(r.get_f(256), 512);
+        Y[i] = mpf_class(r.get_f(256), 512);
+        W[i] = mpf_class(r.get_f(256), 512);
+        // mixed signs and exponents, zeros, and exact or near cancellation
+        mpf_mul_2exp(X[i].get_mpf_t(), X[i].get_mpf_t(), i % 97);
+        mpf_div_2exp(Y[i].get_mpf_t(), Y[i].get_mpf_t(), i % 13);
+        if (i % 3 == 1)
+            X[i] = -X[i];
+        if (i % 5 == 2)
+            W[i] = -W[i];
+        if (i % 17 == 0)
+            Y[i] = 0;
+        if (i % 11 == 3)
+            Y[i] = -X[i];
+        if (i % 19 == 4) {
+            Y[i] = -X[i];
+            mpf_class ulp(1, 512);
+            mpf_div_2exp(ulp.get_mpf_t(), ulp.get_mpf_t(), 200);
+            Y[i] += X[i] * ulp;
+        }
+        x.set(i, X[i]);
+        y.set(i, Y[i]);
+        w.set(i, W[i]);
+        assert(batch_close_to(x.get(i), X[i], 256, 0));
+    }
+    mpf_class zero(0);
+    batch_add(z, x, y);
+    for (std::size_t i = 0; i < n; i++)
+        assert(batch_close_to(z.get(i), X[i] + Y[i], 250, abs(X[i]) + abs(Y[i])));
+    assert(z.get(3) == 0 && z.get(14) == 0);
+    batch_mul(z, x, y);
+    for (std::size_t i = 0; i < n; i++)
+        assert(batch_close_to(z.get(i), X[i] * Y[i], 250, zero));
+    batch_fma(z, x, y, w);
+    for (std::size_t i = 0; i < n; i++)
+        assert(batch_close_to(z.get(i), X[i] * Y[i] + W[i], 250, abs(X[i] * Y[i]) + abs(W[i])));
+    mpf_class alpha("-1.25", 256);
+    batch_axpy(alpha, x, w);
+    for (std::size_t i = 0; i < n; i++)
+        assert(batch_close_to(w.get(i), alpha * X[i] + W[i], 250, abs(X[i]) + abs(W[i])));
+    mpf_class dot(0, 512), norm(0, 512);
+    for (std::size_t i = 0; i < n; i++) {
+        dot += X[i] * Y[i];
+        norm += abs(X[i] * Y[i]);
+    }
+    assert(batch_close_to(batch_dot(x, y), dot, 245, norm));
+    // Bits bits of precision also when Bits is not a multiple of 32: 1 + 2^(1 - Bits) is exact
+    auto check_precision = [](auto batch) {
+        const int bits = static_cast<int>(batch.get_prec());
+        decltype(batch) a(1), b(1), c(1);
+        mpf_class one(1, 2 * bits), ulp(1, 2 * bits);
+        mpf_div_2exp(ulp.get_mpf_t(), ulp.get_mpf_t(), bits - 1);
+        a.set(0, one);
+        b.set(0, ulp);
+        batch_add(c, a, b);
+        assert(c.get(0) == one + ulp);
+        // (1 + ulp)^2 = 1 + 2 ulp + ulp^2, the last term truncated
+        batch_mul(a, c, c);
+        assert(a.get(0) == one + 2 * ulp);
+    };
+    check_precision(mpf_batch<32>());
+    check_precision(mpf_batch<64>());
+    check_precision(mpf_batch<100>());
+    check_precision(mpf_batch<200>());
+    check_precision(mpf_batch<256>());
+    {
+        // exponents: out of range in set(), saturated or flushed to zero in the kernels
+        mpf_batch<128> a(2), b(2);
+        mpf_class huge(1, 128), tiny(1, 128);
+        mpf_mul_2exp(huge.get_mpf_t(), huge.get_mpf_t(), 1UL << 36);
+        bool thrown = false;
+        try {
+            a.set(0, huge);
+        } catch (const std::range_error &) {
+            thrown = true;
+        }
+        assert(thrown && a.get(0) == 0);
+        huge = 1;
+        mpf_mul_2exp(huge.get_mpf_t(), huge.get_mpf_t(), 32UL * ((1UL << 28) - 2));
+        mpf_div_2exp(tiny.get_mpf_t(), tiny.get_mpf_t(), 32UL * ((1UL << 28) - 2));
+        a.set(0, huge);
+        a.set(1, tiny);
+        assert(a.get(0) == huge && a.get(1) == tiny);
+        batch_mul(b, a, a);
+        assert(b.get(0) >= huge && b.get(1) == 0);
+        batch_add(b, b, b);
+        assert(b.get(0) >= huge);
+    }
+    std::cout << "test_mpf_batch passed." << std::endl;
+#endif
+}
+void test_mpfx() {
+#if !defined USE_ORIGINAL_GMPXX
+    using fx = mpfx<63, 200>;
+    using fxr = mpfx<63, 200, mpfx_rounding::nearest>;
+    static_assert(fx::limbs * GMP_NUMB_BITS >= 264, "mpfx limbs");
+    mpf_class ulp(1, 512);
+    mpf_div_2exp(ulp.get_mpf_t(), ulp.get_mpf_t(), 200);
+    gmp_randclass r(gmp_randinit_default);
+    r.seed(11);
+    for (int i = 0; i < 200; i++) {
+        mpf_class a(r.get_f(200), 512), b(r.get_f(200), 512);
+        a *= 1000;
+        if (i % 2)
+            a = -a;
+        if (i % 3 == 0)
+            b = -b;
+        fx x(a), y(b);
+        // get_f(200) values times 1000 are within 10 bits of the fraction, conversions are exact
+        assert(x.get_mpf_class(512) == a && y.get_mpf_class(512) == b && mpf_class(-x) == -a);
+        assert((x + y).get_mpf_class(512) == a + b && (x - y).get_mpf_class(512) == a - b);
+        mpf_class exact = a * b, t = (x * y).get_mpf_class(512), n = fxr(fxr(a) * fxr(b)).get_mpf_class(512);
+        // truncation toward zero within one ulp, rounding within half an ulp
+        assert(abs(t) <= abs(exact) && abs(exact - t) < ulp && abs(exact - n) <= ulp / 2);
+        assert(((x * x).get_mpf_class(512) - a * a) < ulp && (x < y) == (a < b) && (x == y) == (a == b) && sgn(x) == sgn(a));
+        fx z = x;
+        z += y;
+        z -= x;
+        z *= fx(1);
+        assert(z == y && abs(-z) == abs(y));
+    }
+    // from integers and doubles, printing, and wrap around past the limbs
+    assert(fx(-3).get_mpf_class() == -3 && fx(0.375).get_d() == 0.375 && fx(2) * fx(-0.5) == fx(-1) && fx() == fx(0));
+    std::ostringstream os;
+    os << fx(-1.25);
+    assert(os.str() == "-1.25");
+    std::cout << "test_mpfx passed." << std::endl;
+#endif
+}
+void test_mpf_bfp() {
+#if !defined USE_ORIGINAL_GMPXX
+    const std::size_t m = 37, k = 45, n = 29;
+    gmp_randclass r(gmp_randinit_default);
+    r.seed(13);
+    mpf_matrix A(m, k, 256), B(k, n, 256), C(m, n, 256), D(m, k, 256);
+    // mixed signs and scales, and an all zero tile in A
+    for (std::size_t j = 0; j < k; j++)
+        for (std::size_t i = 0; i < m; i++) {
+            A(i, j) = r.get_f(200);
+            if ((i + j) % 3 == 0)
+                A(i, j) = -A(i, j);
+            if (j >= 16)
+                mpf_mul_2exp(A(i, j).get_mpf_t(), A(i, j).get_mpf_t(), 40);
+            if (i < 16 && j < 16)
+                A(i, j) = 0;
+        }
+    for (std::size_t j = 0; j < n; j++)
+        for (std::size_t i = 0; i < k; i++) {
+            B(i, j) = r.get_f(200);
+            if ((i * j) % 5 == 1)
+                B(i, j) = -B(i, j);
+            if (i < 16)
+                mpf_div_2exp(B(i, j).get_mpf_t(), B(i, j).get_mpf_t(), 70);
+        }
+    mpf_bfp_matrix a(A, 16), b(B, 16), c(m, n, 256, 16);
+    assert(a.limbs() * GMP_NUMB_BITS > 256 && a.tile_size() == 16 && a.rows() == m && a.cols() == k && a.tile_is_zero(0, 0) && !b.tile_is_zero(0, 0));
+    // get_f(200) values within 64 bits of the tile maximum convert exactly
+    a.get(D);
+    for (std::size_t j = 0; j < k; j++)
+        for (std::size_t i = 0; i < m; i++)
+            assert(a.get(i, j) == A(i, j) && D(i, j) == A(i, j));
+    gemm(c, a, b);
+    c.get(C);
+    mpf_class exact(0, 1024), err(0, 256), bound(0, 256);
+    for (std::size_t j = 0; j < n; j++)
+        for (std::size_t i = 0; i < m; i++) {
+            exact = 0;
+            bound = 0;
+            for (std::size_t l = 0; l < k; l++) {
+                exact += mpf_class(A(i, l) * B(l, j), 1024);
+                bound += abs(A(i, l)) * abs(B(l, j));
+            }
+            err = abs(C(i, j) - exact);
+            mpf_div_2exp(bound.get_mpf_t(), bound.get_mpf_t(), 240);
+            assert(err <= bound);
+        }
+    std::cout << "test_mpf_bfp passed." << std::endl;
+#endif
+}
+#if !defined USE_ORIGINAL_GMPXX
+// whether the writes a view must not allow compile
+template <typename T, typename = void> struct is_stream_readable : std::false_type {};
+template <typename T> struct is_stream_readable<T, std::void_t<decltype(std::declval<std::istream &>() >> std::declval<T &>())>> : std::true_type {};
+template <typename T, typename = void> struct is_add_assignable : std::false_type {};
+template <typename T> struct is_add_assignable<T, std::void_t<decltype(std::declval<T &>() += 1)>> : std::true_type {};
+template <typename View, typename Base> constexpr bool is_read_only_view() {
+    return std::is_convertible_v<const View &, const Base &> && !std::is_convertible_v<View &, Base &> && !std::is_assignable_v<View &, Base> && !std::is_assignable_v<View &, const View &> && !std::is_swappable_with_v<Base &, View &> && !is_stream_readable<View>::value && !is_add_assignable<View>::value;
+}
+static_assert(is_stream_readable<mpf_class>::value && is_add_assignable<mpf_class>::value && std::is_swappable_with_v<mpf_class &, mpf_class &>, "the detection works");
+static_assert(is_read_only_view<mpz_view, mpz_class>(), "mpz_view cannot be written to");
+static_assert(is_read_only_view<mpf_view, mpf_class>(), "mpf_view cannot be written to");
+#endif
+void test_mpz_mpf_view() {
+#if !defined USE_ORIGINAL_GMPXX
+    const mp_limb_t d[4] = {0x0123456789abcdefUL & GMP_NUMB_MASK, 5, 0, 7};
+    const mp_limb_t zero[1] = {0};
+    mpz_class z;
+    mpz_import(z.get_mpz_t(), 4, -1, sizeof(mp_limb_t), 0, GMP_NAIL_BITS, d);
+    {
+        // the view reads the limbs in place, and takes part in mpz_class expressions and functions
+        mpz_view v(d, 4), w(d, -2), e(zero, 1);
+        assert(v.get_mpz_t()->_mp_d == d && v == z && -w == mpz_class(5) * (mpz_class(1) << GMP_NUMB_BITS) + d[0]);
+        assert(v + w == z - (z % (mpz_class(1) << (2 * GMP_NUMB_BITS))) && v * 3 == z * 3 && gcd(v, v) == z && abs(w) == -w && sgn(e) == 0);
+        mpz_view c = v;
+        assert(c.get_mpz_t()->_mp_d == d && c == v);
+        // moving from a view copies the limbs, so the result may be written to
+        mpz_class m = std::move(c);
+        m += 1;
+        assert(m == z + 1 && v == z);
+        m = std::move(w);
+        assert(m == w && m.get_mpz_t()->_mp_d != d);
+    }
+    {
+        mpf_class f(0, 4 * GMP_NUMB_BITS);
+        mpf_set_z(f.get_mpf_t(), z.get_mpz_t());
+        mpf_div_2exp(f.get_mpf_t(), f.get_mpf_t(), 3 * GMP_NUMB_BITS);
+        // 0.d[3] d[2] d[1] d[0] * 2^(64 * 1), with a leading zero limb dropped in the second
+        const mp_limb_t padded[5] = {d[0], d[1], d[2], d[3], 0};
+        mpf_view v(d, 4, 1), p(padded, -5, 2), e(zero, 1, 7), q(d, 4, 1, 64);
+        assert(v.get_mpf_t()->_mp_d == d && v == f && p == -f && sgn(e) == 0 && v.get_prec() == 4 * GMP_NUMB_BITS && q.get_prec() == 64);
+        assert(v + p == 0 && v * 2 == f * 2 && sqrt(v) == sqrt(f) && abs(p) == f && floor(v) == floor(f) && v > 1);
+        mpf_view c = v;
+        assert(c.get_mpf_t()->_mp_d == d && c == f);
+        mpf_class m = std::move(c);
+        m += 1;
+        assert(m == f + 1 && v == f);
+        // copies of a view and the value read from it own their limbs
+        mpf_class x(v);
+        x = v;
+        swap(x, m);
+        assert(m == f && x.get_mpf_t()->_mp_d != d && v.get_mpf_t()->_mp_d == d);
+        const mpf_class &r = v;
+        assert(&r == &static_cast<const mpf_class &>(v) && r.get_mpf_t()->_mp_d == d);
+        std::ostringstream out;
+        out << v << " " << -v;
+        assert(!out.str().empty());
+    }
+    {
+        // a view with the other view or with mpq_class takes the result type of the owning types, 3 and 3.5 here
+        const mp_limb_t three[1] = {3}, three_half[2] = {mp_limb_t(1) << (GMP_NUMB_BITS - 1), 3};
+        mpz_view z3(three, 1);
+        mpf_view f3(three, 1, 1), f7_2(three_half, 2, 1);
+        const mpq_class h(1, 2);
+        static_assert(std::is_same_v<decltype(f3 + z3), mpf_class> && std::is_same_v<decltype(z3 * h), mpq_class> && std::is_same_v<decltype(h - f3), mpf_class>, "owning result types");
+        assert(f3 + z3 == 6 && z3 + f3 == 6 && f3 - z3 == 0 && z3 - f7_2 == -0.5 && z3 * f3 == 9 && f7_2 / z3 == f7_2 / mpz_class(3) && z3 / f3 == 1);
+        assert(f3 == z3 && z3 == f3 && f7_2 != z3 && z3 != f7_2 && z3 < f7_2 && f7_2 > z3 && z3 <= f3 && f3 >= z3);
+        assert(h + z3 == mpq_class(7, 2) && z3 + h == mpq_class(7, 2) && z3 - h == mpq_class(5, 2) && h - z3 == mpq_class(-5, 2) && h * z3 == mpq_class(3, 2) && z3 / h == 6 && h / z3 == mpq_class(1, 6));
+        assert(h < z3 && z3 > h && h != z3 && z3 != h && !(h == z3) && !(z3 == h) && h <= z3 && z3 >= h);
+        assert(h + f3 == f7_2 && f3 + h == f7_2 && f7_2 - h == 3 && h - f3 == -2.5 && f3 * h == 1.5 && f3 / h == 6 && h / f3 == h / mpf_class(f3));
+        assert(h < f3 && f3 > h && h != f3 && f7_2 != h && h <= f7_2 && f7_2 >= h && !(h == f3) && !(f3 == h));
+        // the other owning type is constructed explicitly
+        static_assert(!std::is_convertible_v<const mpz_view &, mpf_class> && !std::is_convertible_v<const mpf_view &, mpz_class> && !std::is_convertible_v<const mpf_view &, mpq_class>, "explicit");
+        mpf_class a(z3);
+        mpz_class c(f7_2), e(f3);
+        mpq_class g(f7_2), l(z3);
+        assert(a == 3 && c == 3 && e == 3 && g == mpq_class(7, 2) && l == 3 && a.get_mpf_t()->_mp_d != three);
+    }
+    std::cout << "test_mpz_mpf_view passed." << std::endl;
+#endif
+}
+void test_bulk_convert() {
+#if !defined USE_ORIGINAL_GMPXX && GMP_NUMB_BITS == 64 && GMP_NAIL_BITS == 0
+    const std::size_t n = 4000;
+    std::vector<double> d(n), d2(n);
+    std::vector<float> f(n), f2(n);
+    std::vector<int64_t> s(n), s2(n);
+    std::vector<uint64_t> u(n), u2(n);
+    std::vector<__int128> w(n), w2(n);
+    std::mt19937_64 gen(17);
+    for (std::size_t i = 0; i < n; i++) {
+        // random bit patterns cover normal and subnormal numbers; NaN and infinity are replaced
+        uint64_t bits = gen();
+        uint32_t fbits = static_cast<uint32_t>(gen());
+        std::memcpy(&d[i], &bits, sizeof(double));
+        std::memcpy(&f[i], &fbits, sizeof(float));
+        if (!std::isfinite(d[i]) || i % 7 == 0)
+            d[i] = (i % 3) ? std::ldexp(static_cast<double>(bits >> 11), static_cast<int>(i % 200) - 100) : -0.0;
+        if (!std::isfinite(f[i]))
+            f[i] = 1.5f;
+        s[i] = (i == 0) ? std::numeric_limits<int64_t>::min() : static_cast<int64_t>(gen());
+        u[i] = gen();
+        w[i] = static_cast<__int128>((static_cast<unsigned __int128>(s[i]) << 64) | u[i]);
+    }
+    mpf_vector x(n, 256), y, z(7, 64);
+    mpf_class ref(0, 256);
+    convert(d.data(), n, x);
+    convert(x, d2.data());
+    for (std::size_t i = 0; i < n; i++) {
+        mpf_set_d(ref.get_mpf_t(), d[i]);
+        assert(x[i] == ref && d2[i] == d[i]);
+    }
+    convert(f.data(), n, y);
+    convert(y, f2.data());
+    assert(y.size() == n && y.get_prec() == mpf_get_default_prec());
+    for (std::size_t i = 0; i < n; i++) {
+        mpf_set_d(ref.get_mpf_t(), f[i]);
+        assert(y[i] == ref && f2[i] == f[i]);
+    }
+    // to double the value is truncated, as by mpf_get_d
+    for (std::size_t i = 0; i < n; i++) {
+        x[i] = x[i] / 3;
+        if (i % 5 == 0)
+            mpf_mul_2exp(x[i].get_mpf_t(), x[i].get_mpf_t(), 2000);
+    }
+    convert(x, d2.data());
+    for (std::size_t i = 0; i < n; i++) {
+        long exp;
+        mpf_get_d_2exp(&exp, x[i].get_mpf_t());
+        assert(d2[i] == (exp > 1024 ? (x[i] > 0 ? HUGE_VAL : -HUGE_VAL) : mpf_get_d(x[i].get_mpf_t())));
+    }
+    convert(s.data(), n, x);
+    convert(x, s2.data());
+    convert(u.data(), n, y);
+    convert(y, u2.data());
+    for (std::size_t i = 0; i < n; i++) {
+        mpf_set_si(ref.get_mpf_t(), s[i]);
+        assert(x[i] == ref && s2[i] == s[i]);
+        mpf_set_ui(ref.get_mpf_t(), u[i]);
+        assert(y[i] == ref && u2[i] == u[i]);
+        x[i] = x[i] / 3;
+    }
+    convert(x, s2.data());
+    for (std::size_t i = 0; i < n; i++)
+        assert(s2[i] == mpf_get_si(x[i].get_mpf_t()));
+    // 128 bit integers into the smallest mpf, and a matrix
+    convert(w.data(), n, z);
+    convert(z, w2.data());
+    mpf_matrix A(40, 100, 256);
+    convert(w.data(), A);
+    for (std::size_t i = 0; i < n; i++) {
+        mpf_class t = mpf_class(s[i], 256) * mpf_class(std::pow(2.0, 64), 256) + u[i];
+        assert(z[i] == t && w2[i] == w[i] && A(i % 40, i / 40) == t);
+    }
+#if defined __SIZEOF_FLOAT128__
+    std::vector<__float128> q(n), q2(n);
+    for (std::size_t i = 0; i < n; i++)
+        q[i] = static_cast<__float128>(d[i]) * (1 + static_cast<__float128>(1) / 3) * (i % 2 ? 1e-300 : 1);
+    convert(q.data(), n, z);
+    convert(z, q2.data());
+    for (std::size_t i = 0; i < n; i++)
+        assert(q2[i] == q[i] && (i % 2 || z[i] == 0 || abs(z[i] / (mpf_class(d[i], 256) * 4 / 3) - 1) < 1e-30));
+#endif
+    std::vector<unsigned __int128> v(n), v2(n);
+    for (std::size_t i = 0; i < n; i++)
+        v[i] = static_cast<unsigned __int128>(w[i]);
+    convert(v.data(), n, z);
+    convert(z, v2.data());
+    for (std::size_t i = 0; i < n; i++)
+        assert(v2[i] == v[i] && z[i] >= 0);
+#if defined __cpp_lib_span
+    convert(std::span<const double>(d), x);
+    convert(x, std::span<double>(d2));
+    for (std::size_t i = 0; i < n; i++)
+        assert(d2[i] == d[i]);
+#endif
+    bool thrown = false;
+    d[5] = std::numeric_limits<double>::quiet_NaN();
+    try {
+        convert(d.data(), n, x);
+    } catch (const std::domain_error &) {
+        thrown = true;
+    }
+    assert(thrown);
+    std::cout << "test_bulk_convert passed." << std::endl;
+#endif
+}
+void test_stats() {
+#if !defined USE_ORIGINAL_GMPXX
+#if defined ___GMPXX_MKII_STATS___
+    {
+        // one allocation for the limbs of each mpf_class, freed when it goes out of scope
+        stats_scope scope;
+        {
+            mpf_class a(1, 256), b(2, 256);
+            stats_counters c = scope.counters();
+            assert(c.allocations == 2 && c.frees == 0 && c.bytes_allocated > 0);
+        }
+        stats_counters c = scope.counters();
+        assert(c.allocations == 2 && c.frees == 2 && c.bytes_allocated == c.bytes_freed);
+    }
+    {
+        // a growing mpz reallocates
+        stats_scope scope;
+        mpz_class a(1);
+        a <<= 100000;
+        assert(scope.counters().reallocations + scope.counters().allocations >= 1 && scope.counters().bytes_allocated >= 100000 / 8);
+    }
+    {
+        // named regions accumulate over scopes; other threads show up in stats_total() only
+        for (int i = 0; i < 3; i++) {
+            stats_scope scope("test_stats");
+            mpf_class a(i, 128);
+        }
+        stats_counters total = stats_total();
+        std::thread worker([] { mpf_class a(1, 128); });
+        worker.join();
+        assert(stats_total().allocations >= total.allocations + 1);
+        bool found = false;
+        for (const auto &region : stats_regions()) {
+            if (region.first == "test_stats") {
+                assert(region.second.allocations == 3 && region.second.frees == 3);
+                found = true;
+            }
+        }
+        assert(found);
+        std::ostringstream out;
+        out << stats();
+        assert(out.str().find("allocations") != std::string::npos);
+    }
+#endif
+    std::cout << "test_stats passed." << std::endl;
+#endif
+}
+void test_profile() {
+#if !defined USE_ORIGINAL_GMPXX
+#if defined ___GMPXX_MKII_PROFILE___
+    {
+        profile_reset();
+        mpf_class a(2), b(3), c;
+        for (int i = 0; i < 10; i++)
+            c = a * b + a;
+        c = exp(a);
+        std::thread worker([&] { mpf_class d = a * b; });
+        worker.join();
+        // mpf_basic has counters of its own
+        mpf_basic<mpf_prec_max> x(2), y(3);
+        x = x * y + y;
+        x /= y;
+        auto find = [](const std::vector<profile_entry> &entries, const std::string &name) {
+            for (const profile_entry &e : entries)
+                if (e.name == name)
+                    return e;
+            return profile_entry{};
+        };
+        std::vector<profile_entry> entries = profile_entries();
+        // the worker thread counts into its own table, merged here
+        assert(find(entries, "operator*").calls >= 11 && find(entries, "operator+").calls >= 10);
+        assert(find(entries, "operator*").limbs >= 11 && find(entries, "exp").calls == 1);
+        assert(find(entries, "mpf_basic::operator*").calls == 1 && find(entries, "mpf_basic::operator+").calls == 1 && find(entries, "mpf_basic::operator/=").calls == 1 && x == 3);
+        for (std::size_t i = 1; i < entries.size(); i++)
+            assert(entries[i - 1].nanoseconds >= entries[i].nanoseconds);
+        std::ostringstream text, json;
+        profile_report(text);
+        profile_json(json);
+        assert(text.str().find("operator*") != std::string::npos && json.str().find("\"name\": \"exp\"") != std::string::npos);
+        profile_reset();
+        assert(find(profile_entries(), "operator*").calls == 0);
+    }
+#endif
+    std::cout << "test_profile passed." << std::endl;
+#endif
+}
 void test_misc() {
     {
         mpz_class a(-11);
@@ -2818,6 +4186,13 @@ void test_cos() {
         std::cout << "cos(1.0) matched in " << i - 1 << " decimal digits" << std::endl;
         assert(i - 1 > decimal_digits - 2 && "not accurate");
     }
+    {
+        // arguments past 2pi that reduce into (pi/2, pi]
+        mpf_class x = 2.5, tolerance = 1;
+        tolerance.div_2exp(mpf_get_default_prec() - 16);
+        assert(abs(cos(x + 6 * const_pi()) - cos(x)) < tolerance);
+        assert(abs(cos(-x - 6 * const_pi()) - cos(x)) < tolerance);
+    }
     std::cout << "test_cos passed." << std::endl;
 #endif
 }
@@ -2934,6 +4309,16 @@ void test_tan() {
         std::cout << "tan(1.0) matched in " << i - 1 << " decimal digits" << std::endl;
         assert(i - 1 > decimal_digits - 2 && "not accurate");
     }
+    {
+        // tan has period pi, also for arguments far from [-pi/2, pi/2]
+        mpf_class tolerance = 1;
+        tolerance.div_2exp(mpf_get_default_prec() - 16);
+        for (double v : {0.5, 2.0, -2.0, 4.0}) {
+            mpf_class x = v;
+            assert(abs(tan(x + 5 * const_pi()) - tan(x)) < tolerance);
+        }
+        assert(abs(tan(mpf_class(1e10)) - sin(mpf_class(1e10)) / cos(mpf_class(1e10))) < tolerance);
+    }
     std::cout << "test_tan passed." << std::endl;
 #endif
 }
@@ -3531,6 +4916,27 @@ int main() {
     // misc tests
     test_precisions_mixed();
     test_misc();
+    test_istream_extraction();
+    test_text_io();
+    test_first_touch();
+    test_compact_vector();
+    test_radix_conversion();
+    test_hexfloat_io();
+    test_format();
+    test_mpz_small();
+    test_mpq_small();
+    test_mpq_accumulator();
+    test_mixed_double_int();
+    test_precision_literals();
+    test_mpf_basic();
+    test_dd_class();
+    test_mpf_batch();
+    test_mpfx();
+    test_mpf_bfp();
+    test_mpz_mpf_view();
+    test_bulk_convert();
+    test_stats();
+    test_profile();
 
     //
     test_reminder();